@@ -2,6 +2,7 @@
 
 load("@bazel_tools//tools/build_defs/repo:git.bzl", "git_repository")
 load("@bazel_tools//tools/build_defs/repo:http.bzl", "http_archive")
+load("@com_github_3rdparty_bazel_rules_jemalloc//bazel:deps.bzl", jemalloc_deps = "deps")
 load("@com_github_3rdparty_eventuals//bazel:deps.bzl", eventuals_deps = "deps")
 load("@com_github_3rdparty_stout_borrowed_ptr//bazel:deps.bzl", stout_borrowed_ptr_deps = "deps")
 load("@com_github_3rdparty_stout_notification//bazel:deps.bzl", stout_notification_deps = "deps")
@@ -32,6 +33,10 @@ def deps(repo_mapping = {}):
         repo_mapping = repo_mapping,
     )
 
+    jemalloc_deps(
+        repo_mapping = repo_mapping,
+    )
+
     # !!! Here be dragons !!!
     # grpc is currently (2021/09/06) pulling in a version of absl and boringssl
     # that does not compile on linux with neither gcc (11.1) nor clang (12.0).
@@ -74,6 +79,14 @@ def deps(repo_mapping = {}):
             strip_prefix = "glog-0.4.0",
         )
 
+    if "com_github_google_benchmark" not in native.existing_rules():
+        http_archive(
+            name = "com_github_google_benchmark",
+            url = "https://github.com/google/benchmark/archive/v1.6.0.tar.gz",
+            sha256 = "1f71c72ce08d2c1310011ea6436b31e39ccab8c2db94186d26657d41747c85d6",
+            strip_prefix = "benchmark-1.6.0",
+        )
+
     if "com_github_google_googletest" not in native.existing_rules():
         http_archive(
             name = "com_github_google_googletest",
@@ -11,6 +11,7 @@
 
 load("@bazel_tools//tools/build_defs/repo:git.bzl", "git_repository")
 load("@bazel_tools//tools/build_defs/repo:http.bzl", "http_archive")
+load("//3rdparty/bazel-rules-jemalloc:repos.bzl", jemalloc_repos = "repos")
 load("//3rdparty/eventuals:repos.bzl", eventuals_repos = "repos")
 load("//3rdparty/pyprotoc-plugin:repos.bzl", pyprotoc_plugin_repos = "repos")
 load("//3rdparty/stout-borrowed-ptr:repos.bzl", stout_borrowed_ptr_repos = "repos")
@@ -42,6 +43,10 @@ def repos(external = True, repo_mapping = {}):
         repo_mapping = repo_mapping,
     )
 
+    jemalloc_repos(
+        repo_mapping = repo_mapping,
+    )
+
     if "com_github_grpc_grpc" not in native.existing_rules():
         http_archive(
             name = "com_github_grpc_grpc",
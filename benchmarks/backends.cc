@@ -0,0 +1,110 @@
+#include "benchmark/benchmark.h"
+#include "eventuals/grpc/client.h"
+#include "eventuals/grpc/server.h"
+#include "eventuals/let.h"
+#include "eventuals/loop.h"
+#include "eventuals/map.h"
+#include "eventuals/terminal.h"
+#include "eventuals/then.h"
+#include "examples/protos/helloworld.grpc.pb.h"
+
+using helloworld::Greeter;
+using helloworld::HelloReply;
+using helloworld::HelloRequest;
+
+using stout::Borrowable;
+
+using eventuals::Let;
+using eventuals::Loop;
+using eventuals::Map;
+using eventuals::Terminate;
+using eventuals::Then;
+
+using eventuals::grpc::Client;
+using eventuals::grpc::CompletionPool;
+using eventuals::grpc::Server;
+using eventuals::grpc::ServerBackend;
+using eventuals::grpc::ServerBuilder;
+
+////////////////////////////////////////////////////////////////////////
+
+// Compares the latency of unary calls served by each 'ServerBackend'.
+//
+// Run with:
+//
+//   bazel run -c opt //benchmarks:backends
+
+////////////////////////////////////////////////////////////////////////
+
+static auto Serve(Server& server) {
+  return server.Accept<Greeter, HelloRequest, HelloReply>("SayHello")
+      | Map(Let([](auto& call) {
+           return UnaryPrologue(call)
+               | Then([](auto&& request) {
+                    HelloReply reply;
+                    reply.set_message("Hello " + request.name());
+                    return reply;
+                  })
+               | UnaryEpilogue(call);
+         }))
+      | Loop();
+}
+
+////////////////////////////////////////////////////////////////////////
+
+static void BM_Backend(benchmark::State& state, ServerBackend backend) {
+  ServerBuilder builder;
+
+  builder.SetBackend(backend);
+
+  int port = 0;
+
+  builder.AddListeningPort(
+      "0.0.0.0:0",
+      grpc::InsecureServerCredentials(),
+      &port);
+
+  auto build = builder.BuildAndStart();
+
+  CHECK(build.status.ok()) << build.status.error();
+
+  auto server = std::move(build.server);
+
+  auto [served, k] = Terminate(Serve(*server));
+
+  k.Start();
+
+  Borrowable<CompletionPool> pool;
+
+  Client client(
+      "0.0.0.0:" + std::to_string(port),
+      grpc::InsecureChannelCredentials(),
+      pool.Borrow());
+
+  for (auto _ : state) {
+    auto call = [&]() {
+      HelloRequest request;
+      request.set_name("emily");
+      return client.Unary<Greeter, HelloRequest, HelloReply>(
+          "SayHello",
+          std::move(request));
+    };
+
+    auto result = *call();
+
+    CHECK(result.status.ok()) << result.status.error_message();
+
+    benchmark::DoNotOptimize(result.response);
+  }
+
+  server->Shutdown();
+  server->Wait();
+}
+
+BENCHMARK_CAPTURE(BM_Backend, CompletionQueue, ServerBackend::CompletionQueue)
+    ->UseRealTime();
+
+BENCHMARK_CAPTURE(BM_Backend, Callback, ServerBackend::Callback)
+    ->UseRealTime();
+
+////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,103 @@
+#include "benchmark/benchmark.h"
+#include "eventuals/grpc/client.h"
+#include "eventuals/grpc/server.h"
+#include "eventuals/let.h"
+#include "eventuals/loop.h"
+#include "eventuals/map.h"
+#include "eventuals/terminal.h"
+#include "eventuals/then.h"
+#include "examples/protos/keyvaluestore.grpc.pb.h"
+
+using stout::Borrowable;
+
+using eventuals::Let;
+using eventuals::Loop;
+using eventuals::Map;
+using eventuals::Terminate;
+using eventuals::Then;
+
+using eventuals::grpc::Client;
+using eventuals::grpc::CompletionPool;
+using eventuals::grpc::Server;
+using eventuals::grpc::ServerBuilder;
+using eventuals::grpc::Stream;
+
+////////////////////////////////////////////////////////////////////////
+
+// Measures the fixed cost of a call made with 'Client::Call()', i.e.,
+// starting the call, closing it without writing any requests, and
+// finishing it, against an in-process server that finishes each call
+// as soon as it has been accepted. Unlike '//benchmarks:unary' no
+// messages get serialized, written, or read.
+//
+// Run with:
+//
+//   bazel run -c opt //benchmarks:call-setup
+
+////////////////////////////////////////////////////////////////////////
+
+static auto Serve(Server& server) {
+  return server.Accept<
+             Stream<keyvaluestore::Request>,
+             Stream<keyvaluestore::Response>>(
+             "keyvaluestore.KeyValueStore.GetValues")
+      | Map(Let([](auto& call) {
+           return call.Finish(::grpc::Status::OK)
+               | call.WaitForDone();
+         }))
+      | Loop();
+}
+
+////////////////////////////////////////////////////////////////////////
+
+static void BM_CallSetup(benchmark::State& state) {
+  ServerBuilder builder;
+
+  int port = 0;
+
+  builder.AddListeningPort(
+      "0.0.0.0:0",
+      grpc::InsecureServerCredentials(),
+      &port);
+
+  auto build = builder.BuildAndStart();
+
+  CHECK(build.status.ok()) << build.status.error();
+
+  auto server = std::move(build.server);
+
+  auto [served, k] = Terminate(Serve(*server));
+
+  k.Start();
+
+  Borrowable<CompletionPool> pool;
+
+  Client client(
+      "0.0.0.0:" + std::to_string(port),
+      grpc::InsecureChannelCredentials(),
+      pool.Borrow());
+
+  for (auto _ : state) {
+    auto call = [&]() {
+      return client.Call<
+                 Stream<keyvaluestore::Request>,
+                 Stream<keyvaluestore::Response>>(
+                 "keyvaluestore.KeyValueStore.GetValues")
+          | Then(Let([](auto& call) {
+               return call.WritesDone()
+                   | call.Finish();
+             }));
+    };
+
+    auto status = *call();
+
+    CHECK(status.ok()) << status.error_message();
+  }
+
+  server->Shutdown();
+  server->Wait();
+}
+
+BENCHMARK(BM_CallSetup)->UseRealTime();
+
+////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,40 @@
+#include "benchmark/benchmark.h"
+#include "eventuals/grpc/completion-pool.h"
+
+using stout::Borrowable;
+
+using eventuals::grpc::CompletionPool;
+
+////////////////////////////////////////////////////////////////////////
+
+// Measures 'CompletionPool::Schedule()' which every client call does
+// (unless the call gets scheduled on the current completion queue)
+// and which scans all of the completion queues for the least loaded.
+//
+// Run with:
+//
+//   bazel run -c opt //benchmarks:completion-pool
+
+////////////////////////////////////////////////////////////////////////
+
+// NOTE: shared by all threads of a multi-threaded run so that they
+// contend on the same completion queues like concurrent calls would.
+static Borrowable<CompletionPool>& Pool() {
+  static auto* pool = new Borrowable<CompletionPool>();
+  return *pool;
+}
+
+////////////////////////////////////////////////////////////////////////
+
+static void BM_Schedule(benchmark::State& state) {
+  auto& pool = Pool();
+
+  for (auto _ : state) {
+    auto cq = pool->Schedule();
+    benchmark::DoNotOptimize(cq.get());
+  }
+}
+
+BENCHMARK(BM_Schedule)->ThreadRange(1, 8)->UseRealTime();
+
+////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,145 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "eventuals/grpc/call-log.h"
+#include "eventuals/grpc/call-phases.h"
+#include "gflags/gflags.h"
+#include "glog/logging.h"
+
+using eventuals::grpc::CallLog;
+using eventuals::grpc::CallPhases;
+
+////////////////////////////////////////////////////////////////////////
+
+// Prints the events of a call log written by a server built with
+// 'ServerBuilder::SetCallLog()', one per line ordered by when they
+// were logged, e.g.:
+//
+//   +1.234567ms call 42 Accepted /helloworld.Greeter/SayHello *
+//   +1.240012ms call 42 Read 7 bytes 0a05656d696c79
+//   +1.251334ms call 42 Write 13 bytes
+//   +1.251339ms call 42 Finish status 0
+//   +1.302870ms call 42 Phases RequestCall=812.4us Lookup=1.2us ...
+//   +1.302871ms call 42 Done
+//
+// Where the time is relative to when the log was opened (which gets
+// printed first) and bytes only get printed for sampled calls.
+//
+// Run with:
+//
+//   bazel run //benchmarks:decode-call-log -- --call_log=log --call=42
+
+////////////////////////////////////////////////////////////////////////
+
+DEFINE_string(call_log, "", "path of the call log to decode");
+
+DEFINE_uint64(call, 0, "only print events of this call, or all if 0");
+
+////////////////////////////////////////////////////////////////////////
+
+static std::string Hex(const std::string& data) {
+  std::ostringstream out;
+  out << std::hex << std::setfill('0');
+  for (unsigned char c : data) {
+    out << std::setw(2) << static_cast<int>(c);
+  }
+  return out.str();
+}
+
+////////////////////////////////////////////////////////////////////////
+
+static std::string Describe(const CallLog::Reader::Record& record) {
+  std::ostringstream out;
+
+  switch (record.phase) {
+    case CallLog::Phase::Accepted: {
+      size_t separator = record.data.find('\0');
+      out << "Accepted " << record.data.substr(0, separator);
+      if (separator != std::string::npos) {
+        out << " " << record.data.substr(separator + 1);
+      }
+      break;
+    }
+    case CallLog::Phase::Read:
+    case CallLog::Phase::Write:
+      out << (record.phase == CallLog::Phase::Read ? "Read " : "Write ")
+          << record.value << " bytes";
+      if (!record.data.empty()) {
+        out << " " << Hex(record.data);
+      }
+      break;
+    case CallLog::Phase::Finish:
+      out << "Finish status " << record.value;
+      break;
+    case CallLog::Phase::Cancelled:
+      out << "Cancelled";
+      break;
+    case CallLog::Phase::Phases: {
+      out << "Phases";
+      for (size_t i = 0; i < CallPhases::kPhases; i++) {
+        int64_t nanoseconds = 0;
+        if ((i + 1) * sizeof(nanoseconds) > record.data.size()) {
+          break;
+        }
+        std::memcpy(
+            &nanoseconds,
+            record.data.data() + i * sizeof(nanoseconds),
+            sizeof(nanoseconds));
+        out << " " << CallPhases::Name(static_cast<CallPhases::Phase>(i))
+            << "=" << nanoseconds / 1000.0 << "us";
+      }
+      break;
+    }
+    case CallLog::Phase::Done:
+      out << "Done" << (record.value ? " (cancelled)" : "");
+      break;
+    default:
+      out << "Unknown (" << static_cast<int>(record.phase) << ")";
+      break;
+  }
+
+  return out.str();
+}
+
+////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char** argv) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  google::InitGoogleLogging(argv[0]);
+
+  CHECK(!FLAGS_call_log.empty()) << "'--call_log' is required";
+
+  auto reader = CallLog::Reader::Open(FLAGS_call_log);
+
+  CHECK(reader) << "Failed to read call log '" << FLAGS_call_log << "'";
+
+  std::time_t started = std::chrono::system_clock::to_time_t(
+      reader->started());
+
+  std::cout << "Opened at " << std::put_time(std::gmtime(&started), "%FT%TZ")
+            << std::endl;
+
+  std::cout << std::fixed << std::setprecision(6);
+
+  for (const auto& record : reader->Records()) {
+    if (FLAGS_call != 0 && record.call != FLAGS_call) {
+      continue;
+    }
+
+    std::cout << "+"
+              << std::chrono::duration<double, std::milli>(record.time).count()
+              << "ms call " << record.call << " " << Describe(record)
+              << std::endl;
+  }
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////
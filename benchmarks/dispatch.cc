@@ -0,0 +1,133 @@
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "benchmark/benchmark.h"
+#include "eventuals/grpc/client.h"
+#include "eventuals/grpc/server.h"
+#include "test/helloworld.eventuals.h"
+
+using helloworld::HelloReply;
+using helloworld::HelloRequest;
+
+using helloworld::eventuals::Greeter;
+
+using stout::Borrowable;
+
+using eventuals::grpc::Client;
+using eventuals::grpc::CompletionPool;
+using eventuals::grpc::ServerBuilder;
+
+////////////////////////////////////////////////////////////////////////
+
+// Compares statically dispatched generated services with type erased
+// ones, reporting the number of heap allocations per call (which
+// includes those made by the client and gRPC itself, so only the
+// difference between the two is interesting).
+//
+// Run with:
+//
+//   bazel run -c opt //benchmarks:dispatch
+
+////////////////////////////////////////////////////////////////////////
+
+static std::atomic<size_t> allocations = 0;
+
+void* operator new(size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* p = std::malloc(size)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+  std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+  std::free(p);
+}
+
+////////////////////////////////////////////////////////////////////////
+
+class StaticGreeter final : public Greeter::Service<StaticGreeter> {
+ public:
+  auto SayHello(::grpc::ServerContext* context, HelloRequest&& request) {
+    HelloReply reply;
+    reply.set_message("Hello " + request.name());
+    return reply;
+  }
+};
+
+class TypeErasedGreeter final
+  : public Greeter::TypeErased<TypeErasedGreeter> {
+ public:
+  auto SayHello(::grpc::ServerContext* context, HelloRequest&& request) {
+    HelloReply reply;
+    reply.set_message("Hello " + request.name());
+    return reply;
+  }
+};
+
+////////////////////////////////////////////////////////////////////////
+
+template <typename Service>
+static void BM_Dispatch(benchmark::State& state) {
+  Service service;
+
+  ServerBuilder builder;
+
+  int port = 0;
+
+  builder.AddListeningPort(
+      "0.0.0.0:0",
+      grpc::InsecureServerCredentials(),
+      &port);
+
+  builder.RegisterService(&service);
+
+  auto build = builder.BuildAndStart();
+
+  CHECK(build.status.ok()) << build.status.error();
+
+  auto server = std::move(build.server);
+
+  Borrowable<CompletionPool> pool;
+
+  Client client(
+      "0.0.0.0:" + std::to_string(port),
+      grpc::InsecureChannelCredentials(),
+      pool.Borrow());
+
+  size_t before = allocations.load();
+
+  for (auto _ : state) {
+    auto call = [&]() {
+      HelloRequest request;
+      request.set_name("emily");
+      return client.Unary<helloworld::Greeter, HelloRequest, HelloReply>(
+          "SayHello",
+          std::move(request));
+    };
+
+    auto result = *call();
+
+    CHECK(result.status.ok()) << result.status.error_message();
+
+    benchmark::DoNotOptimize(result.response);
+  }
+
+  state.counters["allocations/rpc"] = benchmark::Counter(
+      allocations.load() - before,
+      benchmark::Counter::kAvgIterations);
+
+  server->Shutdown();
+  server->Wait();
+}
+
+BENCHMARK_TEMPLATE(BM_Dispatch, StaticGreeter)->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_Dispatch, TypeErasedGreeter)->UseRealTime();
+
+////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,152 @@
+#include <string>
+
+#include "eventuals/filter.h"
+#include "eventuals/grpc/server.h"
+#include "eventuals/let.h"
+#include "eventuals/loop.h"
+#include "eventuals/map.h"
+#include "eventuals/terminal.h"
+#include "eventuals/then.h"
+#include "examples/protos/helloworld.grpc.pb.h"
+#include "examples/protos/keyvaluestore.grpc.pb.h"
+#include "gflags/gflags.h"
+
+using helloworld::Greeter;
+using helloworld::HelloReply;
+using helloworld::HelloRequest;
+
+using eventuals::Filter;
+using eventuals::Let;
+using eventuals::Loop;
+using eventuals::Map;
+using eventuals::Terminate;
+using eventuals::Then;
+
+using eventuals::grpc::Server;
+using eventuals::grpc::ServerBuilder;
+using eventuals::grpc::Stream;
+
+////////////////////////////////////////////////////////////////////////
+
+// Server for '//benchmarks:load-generator' that serves
+// 'helloworld.Greeter.SayHello' for unary calls and
+// 'keyvaluestore.KeyValueStore.GetValues' for streaming calls.
+//
+// As an "echo" server it replies to each request with a response
+// carrying the request's payload (or '--response_bytes' bytes). As a
+// "sink" server it replies to unary calls with an empty response and
+// consumes all of the requests of a streaming call without replying.
+//
+// Run with:
+//
+//   bazel run -c opt //benchmarks:echo-server -- --port=50051
+
+////////////////////////////////////////////////////////////////////////
+
+DEFINE_int32(port, 50051, "port to listen on (on localhost)");
+
+DEFINE_string(mode, "echo", "either 'echo' or 'sink'");
+
+DEFINE_int32(
+    response_bytes,
+    -1,
+    "bytes of payload in each response, or -1 to echo the request");
+
+DEFINE_int32(
+    completion_queues,
+    0,
+    "number of completion queues, or 0 for the default");
+
+DEFINE_bool(thread_per_core, false, "serve in thread per core mode");
+
+////////////////////////////////////////////////////////////////////////
+
+static std::string Payload(const std::string& request) {
+  return FLAGS_response_bytes < 0
+      ? request
+      : std::string(FLAGS_response_bytes, 'x');
+}
+
+////////////////////////////////////////////////////////////////////////
+
+static auto ServeUnary(Server& server, bool sink) {
+  return server.Accept<Greeter, HelloRequest, HelloReply>("SayHello")
+      | Map(Let([sink](auto& call) {
+           return UnaryPrologue(call)
+               | Then([sink](auto&& request) {
+                    HelloReply reply;
+                    if (!sink) {
+                      reply.set_message(Payload(request.name()));
+                    }
+                    return reply;
+                  })
+               | UnaryEpilogue(call);
+         }))
+      | Loop();
+}
+
+////////////////////////////////////////////////////////////////////////
+
+static auto ServeStreaming(Server& server, bool sink) {
+  return server.Accept<
+             Stream<keyvaluestore::Request>,
+             Stream<keyvaluestore::Response>>(
+             "keyvaluestore.KeyValueStore.GetValues")
+      | Map(Let([sink](auto& call) {
+           return call.Reader().ReadRecycled()
+               | Filter([sink](auto&) {
+                    return !sink;
+                  })
+               | Map([](auto&& request) {
+                    keyvaluestore::Response response;
+                    response.set_value(Payload(request.key()));
+                    return response;
+                  })
+               | StreamingEpilogue(call);
+         }))
+      | Loop();
+}
+
+////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char** argv) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  google::InitGoogleLogging(argv[0]);
+
+  CHECK(FLAGS_mode == "echo" || FLAGS_mode == "sink")
+      << "'--mode' must be either 'echo' or 'sink'";
+
+  bool sink = FLAGS_mode == "sink";
+
+  ServerBuilder builder;
+
+  builder.AddListeningPort(
+      "localhost:" + std::to_string(FLAGS_port),
+      grpc::InsecureServerCredentials());
+
+  if (FLAGS_completion_queues > 0) {
+    builder.SetNumberOfCompletionQueues(FLAGS_completion_queues);
+  }
+
+  if (FLAGS_thread_per_core) {
+    builder.SetThreadPerCore();
+  }
+
+  auto build = builder.BuildAndStart();
+
+  CHECK(build.status.ok()) << build.status.error();
+
+  auto server = std::move(build.server);
+
+  auto [unary, unary_k] = Terminate(ServeUnary(*server, sink));
+  auto [streaming, streaming_k] = Terminate(ServeStreaming(*server, sink));
+
+  unary_k.Start();
+  streaming_k.Start();
+
+  LOG(INFO) << "Serving (" << FLAGS_mode << ") on localhost:" << FLAGS_port;
+
+  server->Wait();
+
+  return 0;
+}
@@ -0,0 +1,98 @@
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "eventuals/grpc/server.h"
+#include "eventuals/iterate.h"
+#include "eventuals/loop.h"
+#include "eventuals/map.h"
+
+using eventuals::Iterate;
+using eventuals::Loop;
+using eventuals::Map;
+
+using eventuals::grpc::Endpoint;
+using eventuals::grpc::Endpoints;
+
+////////////////////////////////////////////////////////////////////////
+
+// Measures 'Endpoints::Lookup()' which the server does for every call
+// it accepts, for a server serving 'state.range(0)' endpoints, when
+// the call matches an endpoint for its host, only matches an endpoint
+// for any host (i.e., "*"), or doesn't match any endpoint.
+//
+// Run with:
+//
+//   bazel run -c opt //benchmarks:endpoints
+
+////////////////////////////////////////////////////////////////////////
+
+static std::string Path(int64_t i) {
+  return "/package.Service/Method" + std::to_string(i);
+}
+
+////////////////////////////////////////////////////////////////////////
+
+// Returns endpoints for 'count' paths where even paths are served for
+// "localhost" and odd paths are served for any host.
+static std::unique_ptr<Endpoints> Serving(int64_t count) {
+  auto endpoints = std::make_unique<Endpoints>();
+
+  std::vector<int64_t> indexes;
+  for (int64_t i = 0; i < count; i++) {
+    indexes.push_back(i);
+  }
+
+  *(Iterate(std::move(indexes))
+    | Map([&](int64_t i) {
+        return endpoints->Insert(std::make_unique<Endpoint>(
+            Path(i),
+            i % 2 == 0 ? "localhost" : "*"));
+      })
+    | Loop());
+
+  return endpoints;
+}
+
+////////////////////////////////////////////////////////////////////////
+
+template <typename F>
+static void Lookup(benchmark::State& state, F path) {
+  auto endpoints = Serving(state.range(0));
+
+  for (auto _ : state) {
+    Endpoint* endpoint = *endpoints->Lookup(path(state), "localhost");
+    benchmark::DoNotOptimize(endpoint);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////
+
+static void BM_LookupHost(benchmark::State& state) {
+  Lookup(state, [](auto& state) {
+    return Path(0);
+  });
+}
+
+BENCHMARK(BM_LookupHost)->Range(1, 1024);
+
+////////////////////////////////////////////////////////////////////////
+
+static void BM_LookupAnyHost(benchmark::State& state) {
+  Lookup(state, [](auto& state) {
+    return Path(1);
+  });
+}
+
+BENCHMARK(BM_LookupAnyHost)->Range(2, 1024);
+
+////////////////////////////////////////////////////////////////////////
+
+static void BM_LookupMissing(benchmark::State& state) {
+  Lookup(state, [](auto& state) {
+    return Path(-1);
+  });
+}
+
+BENCHMARK(BM_LookupMissing)->Range(1, 1024);
+
+////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,308 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "eventuals/grpc/client.h"
+#include "eventuals/iterate.h"
+#include "eventuals/let.h"
+#include "eventuals/loop.h"
+#include "eventuals/map.h"
+#include "eventuals/terminal.h"
+#include "eventuals/then.h"
+#include "examples/protos/helloworld.grpc.pb.h"
+#include "examples/protos/keyvaluestore.grpc.pb.h"
+#include "gflags/gflags.h"
+
+using helloworld::Greeter;
+using helloworld::HelloReply;
+using helloworld::HelloRequest;
+
+using stout::Borrowable;
+
+using eventuals::Iterate;
+using eventuals::Let;
+using eventuals::Loop;
+using eventuals::Map;
+using eventuals::Then;
+
+using eventuals::grpc::Client;
+using eventuals::grpc::CompletionPool;
+using eventuals::grpc::Stream;
+
+////////////////////////////////////////////////////////////////////////
+
+// Open-loop load generator for '//benchmarks:echo-server' built on
+// 'Client' and 'CompletionPool'.
+//
+// Calls get started according to a schedule (at a constant rate or
+// with Poisson arrivals) independent of how long earlier calls take,
+// with at most '--concurrency' calls outstanding. Latency is measured
+// from when a call was _supposed_ to start rather than when it was
+// actually started so that a server that stalls gets charged for the
+// calls that queued up behind the stall (i.e., corrected for
+// "coordinated omission"); the uncorrected latencies are reported
+// too for comparison.
+//
+// Run with:
+//
+//   bazel run -c opt //benchmarks:echo-server -- --port=50051
+//   bazel run -c opt //benchmarks:load-generator -- --port=50051 \
+//       --rate=10000 --arrival=poisson --duration=30
+
+////////////////////////////////////////////////////////////////////////
+
+DEFINE_int32(port, 50051, "port of the server (on localhost)");
+
+DEFINE_string(mode, "unary", "either 'unary' or 'streaming'");
+
+DEFINE_string(arrival, "constant", "either 'constant' or 'poisson'");
+
+DEFINE_double(rate, 1000, "calls started per second");
+
+DEFINE_int32(duration, 10, "seconds to generate load for");
+
+DEFINE_int32(concurrency, 64, "maximum number of outstanding calls");
+
+DEFINE_int32(messages, 10, "requests per call in 'streaming' mode");
+
+DEFINE_int32(request_bytes, 16, "bytes of payload in each request");
+
+DEFINE_uint64(seed, 0, "seed for Poisson arrivals, or 0 for random");
+
+////////////////////////////////////////////////////////////////////////
+
+using Clock = std::chrono::steady_clock;
+
+////////////////////////////////////////////////////////////////////////
+
+// Returns the time between consecutive calls.
+class Arrivals {
+ public:
+  Arrivals(double rate, bool poisson, uint64_t seed)
+    : interval_(1.0 / rate),
+      poisson_(poisson),
+      random_(seed == 0 ? std::random_device()() : seed),
+      exponential_(rate) {}
+
+  Clock::duration Next() {
+    double seconds = poisson_ ? exponential_(random_) : interval_;
+    return std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(seconds));
+  }
+
+ private:
+  const double interval_;
+  const bool poisson_;
+  std::mt19937_64 random_;
+  std::exponential_distribution<double> exponential_;
+};
+
+////////////////////////////////////////////////////////////////////////
+
+struct Latencies {
+  std::vector<Clock::duration> corrected;
+  std::vector<Clock::duration> uncorrected;
+  size_t errors = 0;
+};
+
+////////////////////////////////////////////////////////////////////////
+
+static void Report(
+    const std::string& name,
+    std::vector<Clock::duration>& latencies) {
+  std::sort(latencies.begin(), latencies.end());
+
+  auto percentile = [&](double p) {
+    size_t index = static_cast<size_t>(
+        std::ceil(p / 100 * latencies.size()));
+    index = std::clamp<size_t>(index, 1, latencies.size()) - 1;
+    return std::chrono::duration<double, std::micro>(latencies[index])
+        .count();
+  };
+
+  std::cout << std::fixed << std::setprecision(1)
+            << "latency (" << name << ", us):"
+            << " p50 = " << percentile(50)
+            << " p90 = " << percentile(90)
+            << " p99 = " << percentile(99)
+            << " p99.9 = " << percentile(99.9)
+            << " max = " << percentile(100)
+            << std::endl;
+}
+
+////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char** argv) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  google::InitGoogleLogging(argv[0]);
+
+  CHECK(FLAGS_mode == "unary" || FLAGS_mode == "streaming")
+      << "'--mode' must be either 'unary' or 'streaming'";
+
+  CHECK(FLAGS_arrival == "constant" || FLAGS_arrival == "poisson")
+      << "'--arrival' must be either 'constant' or 'poisson'";
+
+  CHECK_GT(FLAGS_rate, 0) << "'--rate' must be positive";
+  CHECK_GT(FLAGS_duration, 0) << "'--duration' must be positive";
+  CHECK_GT(FLAGS_concurrency, 0) << "'--concurrency' must be positive";
+  CHECK_GT(FLAGS_messages, 0) << "'--messages' must be positive";
+
+  Borrowable<CompletionPool> pool;
+
+  Client client(
+      "localhost:" + std::to_string(FLAGS_port),
+      grpc::InsecureChannelCredentials(),
+      pool.Borrow());
+
+  const std::string payload(FLAGS_request_bytes, 'x');
+
+  std::vector<keyvaluestore::Request> requests(FLAGS_messages);
+  for (auto& request : requests) {
+    request.set_key(payload);
+  }
+
+  // Performs a single call returning whether or not it succeeded.
+  auto call = [&]() {
+    if (FLAGS_mode == "unary") {
+      auto unary = [&]() {
+        HelloRequest request;
+        request.set_name(payload);
+        return client.Unary<Greeter, HelloRequest, HelloReply>(
+            "SayHello",
+            std::move(request));
+      };
+
+      return (*unary()).status.ok();
+    } else {
+      auto streaming = [&]() {
+        return client.Call<
+                   Stream<keyvaluestore::Request>,
+                   Stream<keyvaluestore::Response>>(
+                   "keyvaluestore.KeyValueStore.GetValues")
+            | Then(Let([&](auto& call) {
+                 return Iterate(requests)
+                     | Map([&](auto& request) {
+                          return call.Writer().Write(request);
+                        })
+                     | Loop()
+                     | call.WritesDone()
+                     | call.Reader().ReadRecycled()
+                     | Map([](auto&&) {})
+                     | Loop()
+                     | call.Finish();
+               }));
+      };
+
+      return (*streaming()).ok();
+    }
+  };
+
+  // Intended start times of calls that haven't been started yet.
+  std::mutex mutex;
+  std::condition_variable scheduled;
+  std::deque<Clock::time_point> pending;
+  bool done = false;
+
+  std::vector<Latencies> latencies(FLAGS_concurrency);
+
+  std::vector<std::thread> workers;
+  for (int i = 0; i < FLAGS_concurrency; i++) {
+    workers.emplace_back([&, i]() {
+      while (true) {
+        Clock::time_point intended;
+        {
+          std::unique_lock lock(mutex);
+          scheduled.wait(lock, [&]() {
+            return !pending.empty() || done;
+          });
+          if (pending.empty()) {
+            return;
+          }
+          intended = pending.front();
+          pending.pop_front();
+        }
+
+        auto started = Clock::now();
+        bool ok = call();
+        auto ended = Clock::now();
+
+        if (ok) {
+          latencies[i].corrected.push_back(ended - intended);
+          latencies[i].uncorrected.push_back(ended - started);
+        } else {
+          latencies[i].errors++;
+        }
+      }
+    });
+  }
+
+  Arrivals arrivals(
+      FLAGS_rate,
+      FLAGS_arrival == "poisson",
+      FLAGS_seed);
+
+  auto start = Clock::now();
+  auto end = start + std::chrono::seconds(FLAGS_duration);
+
+  size_t calls = 0;
+
+  for (auto next = start; next < end; next += arrivals.Next()) {
+    std::this_thread::sleep_until(next);
+    {
+      std::scoped_lock lock(mutex);
+      pending.push_back(next);
+    }
+    scheduled.notify_one();
+    calls++;
+  }
+
+  {
+    std::scoped_lock lock(mutex);
+    done = true;
+  }
+
+  scheduled.notify_all();
+
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  auto elapsed = std::chrono::duration<double>(Clock::now() - start);
+
+  Latencies total;
+  for (auto& worker : latencies) {
+    total.corrected.insert(
+        total.corrected.end(),
+        worker.corrected.begin(),
+        worker.corrected.end());
+    total.uncorrected.insert(
+        total.uncorrected.end(),
+        worker.uncorrected.begin(),
+        worker.uncorrected.end());
+    total.errors += worker.errors;
+  }
+
+  std::cout << std::fixed << std::setprecision(1)
+            << "calls = " << calls
+            << " errors = " << total.errors
+            << " elapsed = " << elapsed.count() << "s"
+            << " rate = " << calls / elapsed.count() << "/s"
+            << " (target " << FLAGS_rate << "/s)"
+            << std::endl;
+
+  if (!total.corrected.empty()) {
+    Report("corrected", total.corrected);
+    Report("uncorrected", total.uncorrected);
+  }
+
+  return total.errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,1026 @@
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "eventuals/grpc/client.h"
+#include "eventuals/grpc/server.h"
+#include "eventuals/iterate.h"
+#include "eventuals/let.h"
+#include "eventuals/loop.h"
+#include "eventuals/map.h"
+#include "eventuals/terminal.h"
+#include "eventuals/then.h"
+#include "examples/protos/helloworld.grpc.pb.h"
+#include "examples/protos/keyvaluestore.grpc.pb.h"
+#include "gflags/gflags.h"
+#include "grpcpp/generic/async_generic_service.h"
+#include "grpcpp/generic/generic_stub.h"
+#include "grpcpp/impl/codegen/proto_utils.h"
+
+using helloworld::Greeter;
+using helloworld::HelloReply;
+using helloworld::HelloRequest;
+
+using keyvaluestore::KeyValueStore;
+
+using stout::Borrowable;
+
+using eventuals::Iterate;
+using eventuals::Let;
+using eventuals::Loop;
+using eventuals::Map;
+using eventuals::Terminate;
+using eventuals::Then;
+
+using eventuals::grpc::Client;
+using eventuals::grpc::CompletionPool;
+using eventuals::grpc::Server;
+using eventuals::grpc::ServerBuilder;
+using eventuals::grpc::Stream;
+
+////////////////////////////////////////////////////////////////////////
+
+// Measures what 'eventuals::grpc' costs on top of gRPC by running the
+// same workload, either unary calls of 'helloworld.Greeter.SayHello'
+// or streaming calls of 'keyvaluestore.KeyValueStore.GetValues' (each
+// writing '--messages' requests and reading back a response for each
+// one), through a server and client built with:
+//
+//   eventuals: 'eventuals::grpc::Server' and 'eventuals::grpc::Client'.
+//
+//   async:     '::grpc::AsyncGenericService' (like 'Server' uses) and
+//              '::grpc::TemplatedGenericStub' (like 'Client' uses)
+//              with hand-rolled completion queue loops.
+//
+//   callback:  '::grpc::CallbackGenericService' and the callback API
+//              of '::grpc::TemplatedGenericStub'.
+//
+//   sync:      the synchronous generated services and stubs.
+//
+// For each it reports (side by side) the throughput, latency
+// percentiles, CPU (of the whole process, i.e., server and client)
+// per call, and heap allocations per call.
+//
+// Run with:
+//
+//   bazel run -c opt //benchmarks:overhead -- --concurrency=16
+//
+//   bazel run -c opt //benchmarks:overhead -- --workload=streaming
+
+////////////////////////////////////////////////////////////////////////
+
+DEFINE_string(
+    paths,
+    "eventuals,async,callback,sync",
+    "comma separated paths to measure");
+
+DEFINE_string(
+    workload,
+    "unary",
+    "workload to measure, either 'unary' or 'streaming'");
+
+DEFINE_int32(duration, 5, "seconds to measure each path for");
+
+DEFINE_int32(concurrency, 8, "number of threads making calls");
+
+DEFINE_int32(request_bytes, 16, "bytes of payload in each request");
+
+DEFINE_int32(messages, 16, "requests written by each streaming call");
+
+////////////////////////////////////////////////////////////////////////
+
+static std::atomic<size_t> allocations = 0;
+
+void* operator new(size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* p = std::malloc(size)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+  std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+  std::free(p);
+}
+
+////////////////////////////////////////////////////////////////////////
+
+using Clock = std::chrono::steady_clock;
+
+static const char* kSayHello = "/helloworld.Greeter/SayHello";
+
+static const char* kGetValues = "/keyvaluestore.KeyValueStore/GetValues";
+
+static HelloReply Reply(const HelloRequest& request) {
+  HelloReply reply;
+  reply.set_message("Hello " + request.name());
+  return reply;
+}
+
+static keyvaluestore::Response GetValue(
+    const keyvaluestore::Request& request) {
+  keyvaluestore::Response response;
+  response.set_value(request.key());
+  return response;
+}
+
+////////////////////////////////////////////////////////////////////////
+
+// Deserializes a 'Request' from 'buffer' and then replaces it with
+// the serialized response returned from 'f' (for the generic APIs).
+template <typename Request, typename F>
+static void Respond(::grpc::ByteBuffer& buffer, F&& f) {
+  Request request;
+  CHECK(::grpc::SerializationTraits<Request>::Deserialize(
+            &buffer,
+            &request)
+            .ok());
+  auto response = f(request);
+  bool own = true;
+  CHECK(::grpc::SerializationTraits<decltype(response)>::Serialize(
+            response,
+            &buffer,
+            &own)
+            .ok());
+}
+
+////////////////////////////////////////////////////////////////////////
+
+// A server and client for 'SayHello' and 'GetValues' built with one
+// of the APIs.
+class Path {
+ public:
+  virtual ~Path() = default;
+
+  // Performs a blocking 'SayHello' call returning whether or not it
+  // succeeded.
+  virtual bool Unary(const HelloRequest& request) = 0;
+
+  // Performs a blocking 'GetValues' call that writes all of
+  // 'requests' and reads all of the responses returning whether or
+  // not it succeeded.
+  virtual bool Streaming(
+      const std::vector<keyvaluestore::Request>& requests) = 0;
+};
+
+////////////////////////////////////////////////////////////////////////
+
+// Serves 'SayHello' until the server is shutdown.
+static auto ServeUnary(Server& server) {
+  return server.Accept<Greeter, HelloRequest, HelloReply>("SayHello")
+      | Map(Let([](auto& call) {
+           return UnaryPrologue(call)
+               | Then([](auto&& request) {
+                    return Reply(request);
+                  })
+               | UnaryEpilogue(call);
+         }))
+      | Loop();
+}
+
+////////////////////////////////////////////////////////////////////////
+
+// Serves 'GetValues' until the server is shutdown.
+static auto ServeStreaming(Server& server) {
+  return server.Accept<
+             Stream<keyvaluestore::Request>,
+             Stream<keyvaluestore::Response>>(
+             "keyvaluestore.KeyValueStore.GetValues")
+      | Map(Let([](auto& call) {
+           return call.Reader().Read()
+               | Map([](auto&& request) {
+                    return GetValue(request);
+                  })
+               | StreamingEpilogue(call);
+         }))
+      | Loop();
+}
+
+////////////////////////////////////////////////////////////////////////
+
+class EventualsPath final : public Path {
+ public:
+  EventualsPath() {
+    ServerBuilder builder;
+
+    int port = 0;
+
+    builder.AddListeningPort(
+        "localhost:0",
+        ::grpc::InsecureServerCredentials(),
+        &port);
+
+    auto build = builder.BuildAndStart();
+
+    CHECK(build.status.ok()) << build.status.error();
+
+    server_ = std::move(build.server);
+
+    auto serve = [](auto e) -> std::shared_ptr<void> {
+      auto [served, k] = Terminate(std::move(e));
+
+      // NOTE: moved to the heap (before being started) so that it
+      // outlives this constructor.
+      auto serving =
+          std::make_shared<std::decay_t<decltype(k)>>(std::move(k));
+      serving->Start();
+      return serving;
+    };
+
+    serving_.push_back(serve(ServeUnary(*server_)));
+    serving_.push_back(serve(ServeStreaming(*server_)));
+
+    client_ = std::make_unique<Client>(
+        "localhost:" + std::to_string(port),
+        ::grpc::InsecureChannelCredentials(),
+        pool_.Borrow());
+  }
+
+  ~EventualsPath() override {
+    server_->Shutdown();
+    server_->Wait();
+  }
+
+  bool Unary(const HelloRequest& request) override {
+    auto call = [&]() {
+      return client_->Unary<Greeter, HelloRequest, HelloReply>(
+          "SayHello",
+          HelloRequest(request));
+    };
+
+    return (*call()).status.ok();
+  }
+
+  bool Streaming(
+      const std::vector<keyvaluestore::Request>& requests) override {
+    auto call = [&]() {
+      return client_->Call<
+                 Stream<keyvaluestore::Request>,
+                 Stream<keyvaluestore::Response>>(
+                 "keyvaluestore.KeyValueStore.GetValues")
+          | Then(Let([&](auto& call) {
+               return Iterate(requests)
+                   | Map([&](auto& request) {
+                        return call.Writer().Write(request);
+                      })
+                   | Loop()
+                   | call.WritesDone()
+                   | call.Reader().Read()
+                   | Map([](auto&&) {})
+                   | Loop()
+                   | call.Finish();
+             }));
+    };
+
+    return (*call()).ok();
+  }
+
+ private:
+  Borrowable<CompletionPool> pool_;
+  std::unique_ptr<Server> server_;
+  std::vector<std::shared_ptr<void>> serving_;
+  std::unique_ptr<Client> client_;
+};
+
+////////////////////////////////////////////////////////////////////////
+
+// NOTE: each calling thread uses its own completion queue for the
+// raw async client so that a call only needs to wait for its own tag.
+struct ThreadCompletionQueue {
+  ~ThreadCompletionQueue() {
+    cq.Shutdown();
+    void* tag = nullptr;
+    bool ok = false;
+    while (cq.Next(&tag, &ok)) {}
+  }
+
+  ::grpc::CompletionQueue cq;
+};
+
+// Waits for the next (and only outstanding) tag on 'cq', which must
+// be 'tag', returning whether or not it was 'ok'.
+static bool Next(::grpc::CompletionQueue& cq, void* tag) {
+  void* next = nullptr;
+  bool ok = false;
+  CHECK(cq.Next(&next, &ok));
+  CHECK_EQ(next, tag);
+  return ok;
+}
+
+////////////////////////////////////////////////////////////////////////
+
+class AsyncPath final : public Path {
+ public:
+  AsyncPath() {
+    ::grpc::ServerBuilder builder;
+
+    int port = 0;
+
+    builder.AddListeningPort(
+        "localhost:0",
+        ::grpc::InsecureServerCredentials(),
+        &port);
+
+    builder.RegisterAsyncGenericService(&service_);
+
+    // NOTE: same number of completion queues (each with one thread)
+    // as 'eventuals::grpc::ServerBuilder' uses by default.
+    for (size_t i = 0; i < std::thread::hardware_concurrency(); i++) {
+      cqs_.push_back(builder.AddCompletionQueue());
+    }
+
+    server_ = builder.BuildAndStart();
+
+    CHECK(server_);
+
+    for (auto& cq : cqs_) {
+      new ServerCall(&service_, cq.get());
+      threads_.emplace_back([cq = cq.get()]() {
+        void* tag = nullptr;
+        bool ok = false;
+        while (cq->Next(&tag, &ok)) {
+          static_cast<ServerCall*>(tag)->Proceed(ok);
+        }
+      });
+    }
+
+    auto channel = ::grpc::CreateChannel(
+        "localhost:" + std::to_string(port),
+        ::grpc::InsecureChannelCredentials());
+
+    unary_ = std::make_unique<UnaryStub>(channel);
+    streaming_ = std::make_unique<StreamingStub>(channel);
+  }
+
+  ~AsyncPath() override {
+    server_->Shutdown();
+    for (auto& cq : cqs_) {
+      cq->Shutdown();
+    }
+    for (auto& thread : threads_) {
+      thread.join();
+    }
+  }
+
+  bool Unary(const HelloRequest& request) override {
+    thread_local ThreadCompletionQueue thread;
+
+    ::grpc::ClientContext context;
+
+    auto reader = unary_->PrepareUnaryCall(
+        &context,
+        kSayHello,
+        request,
+        &thread.cq);
+
+    reader->StartCall();
+
+    HelloReply reply;
+    ::grpc::Status status;
+
+    reader->Finish(&reply, &status, &context);
+
+    bool ok = Next(thread.cq, &context);
+
+    return ok && status.ok();
+  }
+
+  bool Streaming(
+      const std::vector<keyvaluestore::Request>& requests) override {
+    thread_local ThreadCompletionQueue thread;
+
+    ::grpc::ClientContext context;
+
+    auto stream = streaming_->PrepareCall(&context, kGetValues, &thread.cq);
+
+    stream->StartCall(&context);
+
+    bool ok = Next(thread.cq, &context);
+
+    for (size_t i = 0; ok && i < requests.size(); i++) {
+      stream->Write(requests[i], &context);
+      ok = Next(thread.cq, &context);
+    }
+
+    if (ok) {
+      stream->WritesDone(&context);
+      ok = Next(thread.cq, &context);
+    }
+
+    // NOTE: reading until the server finishes, which is the only
+    // expected way for a read to not be 'ok'.
+    if (ok) {
+      keyvaluestore::Response response;
+      do {
+        stream->Read(&response, &context);
+      } while (Next(thread.cq, &context));
+    }
+
+    ::grpc::Status status;
+
+    stream->Finish(&status, &context);
+
+    CHECK(Next(thread.cq, &context));
+
+    return ok && status.ok();
+  }
+
+ private:
+  using UnaryStub = ::grpc::TemplatedGenericStub<HelloRequest, HelloReply>;
+
+  using StreamingStub = ::grpc::TemplatedGenericStub<
+      keyvaluestore::Request,
+      keyvaluestore::Response>;
+
+  // NOTE: assumes every call is either for 'SayHello' or 'GetValues'.
+  class ServerCall {
+   public:
+    ServerCall(
+        ::grpc::AsyncGenericService* service,
+        ::grpc::ServerCompletionQueue* cq)
+      : service_(service),
+        cq_(cq),
+        stream_(&context_) {
+      service_->RequestCall(&context_, &stream_, cq_, cq_, this);
+    }
+
+    void Proceed(bool ok) {
+      // NOTE: a streaming call reads until the client is done
+      // writing, at which point it finishes.
+      if (!ok && state_ == State::Reading && streaming_) {
+        state_ = State::Finishing;
+        stream_.Finish(::grpc::Status::OK, this);
+        return;
+      } else if (!ok) {
+        delete this;
+        return;
+      }
+
+      switch (state_) {
+        case State::Requested: {
+          new ServerCall(service_, cq_);
+          streaming_ = context_.method() == kGetValues;
+          state_ = State::Reading;
+          stream_.Read(&buffer_, this);
+          break;
+        }
+        case State::Reading: {
+          if (streaming_) {
+            Respond<keyvaluestore::Request>(buffer_, GetValue);
+            state_ = State::Writing;
+            stream_.Write(buffer_, this);
+          } else {
+            Respond<HelloRequest>(buffer_, Reply);
+            state_ = State::Finishing;
+            stream_.WriteAndFinish(
+                buffer_,
+                ::grpc::WriteOptions(),
+                ::grpc::Status::OK,
+                this);
+          }
+          break;
+        }
+        case State::Writing: {
+          state_ = State::Reading;
+          stream_.Read(&buffer_, this);
+          break;
+        }
+        case State::Finishing: {
+          delete this;
+          break;
+        }
+      }
+    }
+
+   private:
+    enum class State {
+      Requested,
+      Reading,
+      Writing,
+      Finishing,
+    };
+
+    ::grpc::AsyncGenericService* service_;
+    ::grpc::ServerCompletionQueue* cq_;
+    ::grpc::GenericServerContext context_;
+    ::grpc::GenericServerAsyncReaderWriter stream_;
+    ::grpc::ByteBuffer buffer_;
+    State state_ = State::Requested;
+    bool streaming_ = false;
+  };
+
+  ::grpc::AsyncGenericService service_;
+  std::vector<std::unique_ptr<::grpc::ServerCompletionQueue>> cqs_;
+  std::unique_ptr<::grpc::Server> server_;
+  std::vector<std::thread> threads_;
+  std::unique_ptr<UnaryStub> unary_;
+  std::unique_ptr<StreamingStub> streaming_;
+};
+
+////////////////////////////////////////////////////////////////////////
+
+class CallbackPath final : public Path {
+ public:
+  CallbackPath() {
+    ::grpc::ServerBuilder builder;
+
+    int port = 0;
+
+    builder.AddListeningPort(
+        "localhost:0",
+        ::grpc::InsecureServerCredentials(),
+        &port);
+
+    builder.RegisterCallbackGenericService(&service_);
+
+    server_ = builder.BuildAndStart();
+
+    CHECK(server_);
+
+    auto channel = ::grpc::CreateChannel(
+        "localhost:" + std::to_string(port),
+        ::grpc::InsecureChannelCredentials());
+
+    unary_ = std::make_unique<UnaryStub>(channel);
+    streaming_ = std::make_unique<StreamingStub>(channel);
+  }
+
+  ~CallbackPath() override {
+    server_->Shutdown();
+  }
+
+  bool Unary(const HelloRequest& request) override {
+    ::grpc::ClientContext context;
+
+    HelloReply reply;
+
+    std::promise<::grpc::Status> promise;
+
+    unary_->experimental().UnaryCall(
+        &context,
+        kSayHello,
+        &request,
+        &reply,
+        [&promise](::grpc::Status status) {
+          promise.set_value(std::move(status));
+        });
+
+    return promise.get_future().get().ok();
+  }
+
+  bool Streaming(
+      const std::vector<keyvaluestore::Request>& requests) override {
+    ::grpc::ClientContext context;
+
+    StreamingCall call(requests);
+
+    streaming_->experimental().PrepareBidiStreamingCall(
+        &context,
+        kGetValues,
+        &call);
+
+    return call.Start().ok();
+  }
+
+ private:
+  using UnaryStub = ::grpc::TemplatedGenericStub<HelloRequest, HelloReply>;
+
+  using StreamingStub = ::grpc::TemplatedGenericStub<
+      keyvaluestore::Request,
+      keyvaluestore::Response>;
+
+  // Writes all of 'requests' while reading all of the responses.
+  class StreamingCall final
+    : public ::grpc::ClientBidiReactor<
+          keyvaluestore::Request,
+          keyvaluestore::Response> {
+   public:
+    StreamingCall(const std::vector<keyvaluestore::Request>& requests)
+      : requests_(requests) {}
+
+    // Starts the call and blocks until it's done.
+    ::grpc::Status Start() {
+      StartRead(&response_);
+      Write();
+      StartCall();
+      return promise_.get_future().get();
+    }
+
+    void OnWriteDone(bool ok) override {
+      if (ok) {
+        Write();
+      }
+    }
+
+    void OnReadDone(bool ok) override {
+      if (ok) {
+        StartRead(&response_);
+      }
+    }
+
+    void OnDone(const ::grpc::Status& status) override {
+      promise_.set_value(status);
+    }
+
+   private:
+    void Write() {
+      if (written_ < requests_.size()) {
+        StartWrite(&requests_[written_++]);
+      } else {
+        StartWritesDone();
+      }
+    }
+
+    const std::vector<keyvaluestore::Request>& requests_;
+    size_t written_ = 0;
+    keyvaluestore::Response response_;
+    std::promise<::grpc::Status> promise_;
+  };
+
+  class UnaryReactor final : public ::grpc::ServerGenericBidiReactor {
+   public:
+    UnaryReactor() {
+      StartRead(&buffer_);
+    }
+
+    void OnReadDone(bool ok) override {
+      if (!ok) {
+        Finish(::grpc::Status(::grpc::INVALID_ARGUMENT, "Missing request"));
+        return;
+      }
+
+      Respond<HelloRequest>(buffer_, Reply);
+
+      StartWriteAndFinish(
+          &buffer_,
+          ::grpc::WriteOptions(),
+          ::grpc::Status::OK);
+    }
+
+    void OnDone() override {
+      delete this;
+    }
+
+   private:
+    ::grpc::ByteBuffer buffer_;
+  };
+
+  class StreamingReactor final : public ::grpc::ServerGenericBidiReactor {
+   public:
+    StreamingReactor() {
+      StartRead(&buffer_);
+    }
+
+    // NOTE: reads until the client is done writing, at which point
+    // it finishes.
+    void OnReadDone(bool ok) override {
+      if (!ok) {
+        Finish(::grpc::Status::OK);
+        return;
+      }
+
+      Respond<keyvaluestore::Request>(buffer_, GetValue);
+
+      StartWrite(&buffer_);
+    }
+
+    void OnWriteDone(bool ok) override {
+      if (!ok) {
+        Finish(::grpc::Status(::grpc::UNKNOWN, "Failed to write"));
+        return;
+      }
+
+      StartRead(&buffer_);
+    }
+
+    void OnDone() override {
+      delete this;
+    }
+
+   private:
+    ::grpc::ByteBuffer buffer_;
+  };
+
+  // NOTE: assumes every call is either for 'SayHello' or 'GetValues'.
+  class Service final : public ::grpc::CallbackGenericService {
+   public:
+    ::grpc::ServerGenericBidiReactor* CreateReactor(
+        ::grpc::GenericCallbackServerContext* context) override {
+      if (context->method() == kGetValues) {
+        return new StreamingReactor();
+      } else {
+        return new UnaryReactor();
+      }
+    }
+  };
+
+  Service service_;
+  std::unique_ptr<::grpc::Server> server_;
+  std::unique_ptr<UnaryStub> unary_;
+  std::unique_ptr<StreamingStub> streaming_;
+};
+
+////////////////////////////////////////////////////////////////////////
+
+class SyncPath final : public Path {
+ public:
+  SyncPath() {
+    ::grpc::ServerBuilder builder;
+
+    int port = 0;
+
+    builder.AddListeningPort(
+        "localhost:0",
+        ::grpc::InsecureServerCredentials(),
+        &port);
+
+    builder.RegisterService(&greeter_);
+    builder.RegisterService(&store_);
+
+    server_ = builder.BuildAndStart();
+
+    CHECK(server_);
+
+    auto channel = ::grpc::CreateChannel(
+        "localhost:" + std::to_string(port),
+        ::grpc::InsecureChannelCredentials());
+
+    greeter_stub_ = Greeter::NewStub(channel);
+    store_stub_ = KeyValueStore::NewStub(channel);
+  }
+
+  ~SyncPath() override {
+    server_->Shutdown();
+  }
+
+  bool Unary(const HelloRequest& request) override {
+    ::grpc::ClientContext context;
+    HelloReply reply;
+    return greeter_stub_->SayHello(&context, request, &reply).ok();
+  }
+
+  bool Streaming(
+      const std::vector<keyvaluestore::Request>& requests) override {
+    ::grpc::ClientContext context;
+
+    auto stream = store_stub_->GetValues(&context);
+
+    for (auto& request : requests) {
+      if (!stream->Write(request)) {
+        break;
+      }
+    }
+
+    stream->WritesDone();
+
+    keyvaluestore::Response response;
+    while (stream->Read(&response)) {}
+
+    return stream->Finish().ok();
+  }
+
+ private:
+  class GreeterService final : public Greeter::Service {
+   public:
+    ::grpc::Status SayHello(
+        ::grpc::ServerContext* context,
+        const HelloRequest* request,
+        HelloReply* reply) override {
+      *reply = Reply(*request);
+      return ::grpc::Status::OK;
+    }
+  };
+
+  class KeyValueStoreService final : public KeyValueStore::Service {
+   public:
+    ::grpc::Status GetValues(
+        ::grpc::ServerContext* context,
+        ::grpc::ServerReaderWriter<
+            keyvaluestore::Response,
+            keyvaluestore::Request>* stream) override {
+      keyvaluestore::Request request;
+      while (stream->Read(&request)) {
+        if (!stream->Write(GetValue(request))) {
+          return ::grpc::Status(::grpc::UNKNOWN, "Failed to write");
+        }
+      }
+      return ::grpc::Status::OK;
+    }
+  };
+
+  GreeterService greeter_;
+  KeyValueStoreService store_;
+  std::unique_ptr<::grpc::Server> server_;
+  std::unique_ptr<Greeter::Stub> greeter_stub_;
+  std::unique_ptr<KeyValueStore::Stub> store_stub_;
+};
+
+////////////////////////////////////////////////////////////////////////
+
+static std::unique_ptr<Path> Make(const std::string& name) {
+  if (name == "eventuals") {
+    return std::make_unique<EventualsPath>();
+  } else if (name == "async") {
+    return std::make_unique<AsyncPath>();
+  } else if (name == "callback") {
+    return std::make_unique<CallbackPath>();
+  } else if (name == "sync") {
+    return std::make_unique<SyncPath>();
+  } else {
+    LOG(FATAL) << "Unknown path '" << name << "'";
+  }
+}
+
+////////////////////////////////////////////////////////////////////////
+
+static std::chrono::microseconds CPU() {
+  struct rusage usage;
+  CHECK_EQ(getrusage(RUSAGE_SELF, &usage), 0);
+  auto micros = [](const timeval& time) {
+    return std::chrono::seconds(time.tv_sec)
+        + std::chrono::microseconds(time.tv_usec);
+  };
+  return micros(usage.ru_utime) + micros(usage.ru_stime);
+}
+
+////////////////////////////////////////////////////////////////////////
+
+struct Result {
+  size_t calls = 0;
+  size_t errors = 0;
+  double qps = 0;
+  double p50 = 0;
+  double p99 = 0;
+  double cpu = 0;
+  double allocations = 0;
+};
+
+////////////////////////////////////////////////////////////////////////
+
+static Result Measure(Path& path) {
+  const std::string payload(FLAGS_request_bytes, 'x');
+
+  HelloRequest request;
+  request.set_name(payload);
+
+  std::vector<keyvaluestore::Request> requests(FLAGS_messages);
+  for (auto& request : requests) {
+    request.set_key(payload);
+  }
+
+  // Performs a single call of the workload returning whether or not
+  // it succeeded.
+  auto call = [&, streaming = FLAGS_workload == "streaming"]() {
+    if (streaming) {
+      return path.Streaming(requests);
+    } else {
+      return path.Unary(request);
+    }
+  };
+
+  // NOTE: warming up (e.g., connecting) on its own thread so that
+  // any thread locals it creates don't outlive the path.
+  std::thread([&]() {
+    for (size_t i = 0; i < 100; i++) {
+      CHECK(call());
+    }
+  }).join();
+
+  std::atomic<bool> stop = false;
+
+  std::vector<std::vector<Clock::duration>> latencies(FLAGS_concurrency);
+  std::vector<size_t> errors(FLAGS_concurrency, 0);
+
+  for (auto& thread : latencies) {
+    thread.reserve(1 << 20);
+  }
+
+  auto cpu = CPU();
+  size_t allocated = allocations.load();
+  auto start = Clock::now();
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < FLAGS_concurrency; i++) {
+    threads.emplace_back([&, i]() {
+      while (!stop.load(std::memory_order_relaxed)) {
+        auto started = Clock::now();
+        if (call()) {
+          latencies[i].push_back(Clock::now() - started);
+        } else {
+          errors[i]++;
+        }
+      }
+    });
+  }
+
+  std::this_thread::sleep_for(std::chrono::seconds(FLAGS_duration));
+
+  stop.store(true);
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  auto elapsed = std::chrono::duration<double>(Clock::now() - start);
+
+  Result result;
+
+  std::vector<Clock::duration> all;
+  for (int i = 0; i < FLAGS_concurrency; i++) {
+    all.insert(all.end(), latencies[i].begin(), latencies[i].end());
+    result.errors += errors[i];
+  }
+
+  result.calls = all.size() + result.errors;
+
+  if (result.calls == 0) {
+    return result;
+  }
+
+  result.qps = result.calls / elapsed.count();
+
+  result.cpu = std::chrono::duration<double, std::micro>(CPU() - cpu).count()
+      / result.calls;
+
+  result.allocations =
+      static_cast<double>(allocations.load() - allocated) / result.calls;
+
+  if (!all.empty()) {
+    std::sort(all.begin(), all.end());
+    auto percentile = [&](double p) {
+      size_t index = std::min(
+          all.size() - 1,
+          static_cast<size_t>(p / 100 * all.size()));
+      return std::chrono::duration<double, std::micro>(all[index]).count();
+    };
+    result.p50 = percentile(50);
+    result.p99 = percentile(99);
+  }
+
+  return result;
+}
+
+////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char** argv) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  google::InitGoogleLogging(argv[0]);
+
+  CHECK_GT(FLAGS_duration, 0) << "'--duration' must be positive";
+  CHECK_GT(FLAGS_concurrency, 0) << "'--concurrency' must be positive";
+
+  CHECK(FLAGS_workload == "unary" || FLAGS_workload == "streaming")
+      << "'--workload' must be either 'unary' or 'streaming'";
+
+  CHECK_GT(FLAGS_messages, 0) << "'--messages' must be positive";
+
+  std::cout << std::left
+            << std::setw(12) << "path"
+            << std::right
+            << std::setw(12) << "qps"
+            << std::setw(12) << "p50 (us)"
+            << std::setw(12) << "p99 (us)"
+            << std::setw(16) << "cpu/call (us)"
+            << std::setw(16) << "allocs/call"
+            << std::setw(10) << "errors"
+            << std::endl;
+
+  std::stringstream paths(FLAGS_paths);
+  std::string name;
+  while (std::getline(paths, name, ',')) {
+    Result result = [&]() {
+      auto path = Make(name);
+      return Measure(*path);
+    }();
+
+    std::cout << std::fixed << std::setprecision(1)
+              << std::left
+              << std::setw(12) << name
+              << std::right
+              << std::setw(12) << result.qps
+              << std::setw(12) << result.p50
+              << std::setw(12) << result.p99
+              << std::setw(16) << result.cpu
+              << std::setw(16) << result.allocations
+              << std::setw(10) << result.errors
+              << std::endl;
+  }
+
+  return 0;
+}
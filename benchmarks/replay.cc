@@ -0,0 +1,323 @@
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "eventuals/grpc/client.h"
+#include "eventuals/grpc/recorder.h"
+#include "eventuals/grpc/traits.h"
+#include "eventuals/iterate.h"
+#include "eventuals/let.h"
+#include "eventuals/loop.h"
+#include "eventuals/map.h"
+#include "eventuals/terminal.h"
+#include "eventuals/then.h"
+#include "examples/protos/helloworld.grpc.pb.h"
+#include "examples/protos/keyvaluestore.grpc.pb.h"
+#include "gflags/gflags.h"
+
+using stout::Borrowable;
+
+using eventuals::Iterate;
+using eventuals::Let;
+using eventuals::Loop;
+using eventuals::Map;
+using eventuals::Then;
+
+using eventuals::grpc::Client;
+using eventuals::grpc::CompletionPool;
+using eventuals::grpc::Recording;
+using eventuals::grpc::RequestResponseTraits;
+using eventuals::grpc::Stream;
+
+////////////////////////////////////////////////////////////////////////
+
+// Replays a recording made by a server built with
+// 'ServerBuilder::SetRecording()' against a server on localhost,
+// starting each call at the same time (relative to the start of the
+// recording) that it was originally received, or '--speed' times as
+// fast, and reporting the latency of the replayed calls.
+//
+// Each call writes all of its recorded requests and then reads all
+// of its responses, i.e., the timing between requests of a streaming
+// call is not replayed. The host of the recorded calls is ignored.
+//
+// NOTE: calls can only be replayed for methods whose request and
+// response types are known, see 'Replayers()'.
+//
+// Run with:
+//
+//   bazel run -c opt //benchmarks:replay -- \
+//       --recording=/path/to/recording --port=50051 --speed=2
+
+////////////////////////////////////////////////////////////////////////
+
+DEFINE_string(recording, "", "path of the recording to replay");
+
+DEFINE_int32(port, 50051, "port of the server (on localhost)");
+
+DEFINE_double(
+    speed,
+    1,
+    "how many times faster than recorded to replay, "
+    "or 0 to replay as fast as possible");
+
+DEFINE_int32(concurrency, 64, "maximum number of outstanding calls");
+
+////////////////////////////////////////////////////////////////////////
+
+using Clock = std::chrono::steady_clock;
+
+////////////////////////////////////////////////////////////////////////
+
+struct Call {
+  std::string method;
+  std::chrono::nanoseconds time;
+  std::vector<std::string> requests;
+};
+
+////////////////////////////////////////////////////////////////////////
+
+// Replays a call returning whether or not it succeeded.
+using Replayer = std::function<bool(Client&, const Call&)>;
+
+template <typename Request, typename Response>
+static Replayer Replay(std::string name) {
+  return [name = std::move(name)](Client& client, const Call& recorded) {
+    using RequestType = typename RequestResponseTraits::Details<
+        Request>::Type;
+
+    std::vector<RequestType> requests(recorded.requests.size());
+    for (size_t i = 0; i < requests.size(); i++) {
+      if (!requests[i].ParseFromString(recorded.requests[i])) {
+        return false;
+      }
+    }
+
+    auto call = [&]() {
+      return client.Call<Request, Response>(name)
+          | Then(Let([&](auto& call) {
+               return Iterate(requests)
+                   | Map([&](auto& request) {
+                        return call.Writer().Write(request);
+                      })
+                   | Loop()
+                   | call.WritesDone()
+                   | call.Reader().ReadRecycled()
+                   | Map([](auto&&) {})
+                   | Loop()
+                   | call.Finish();
+             }));
+    };
+
+    return (*call()).ok();
+  };
+}
+
+////////////////////////////////////////////////////////////////////////
+
+// Replayers keyed by the method of a call as recorded, i.e.,
+// "/package.Service/Method".
+static const std::unordered_map<std::string, Replayer>& Replayers() {
+  static const auto* replayers =
+      new std::unordered_map<std::string, Replayer>{
+          {"/helloworld.Greeter/SayHello",
+           Replay<helloworld::HelloRequest, helloworld::HelloReply>(
+               "helloworld.Greeter.SayHello")},
+          {"/keyvaluestore.KeyValueStore/GetValues",
+           Replay<
+               Stream<keyvaluestore::Request>,
+               Stream<keyvaluestore::Response>>(
+               "keyvaluestore.KeyValueStore.GetValues")},
+      };
+  return *replayers;
+}
+
+////////////////////////////////////////////////////////////////////////
+
+static std::vector<Call> Load(const std::string& path) {
+  auto reader = Recording::Reader::Open(path);
+
+  CHECK(reader) << "Failed to open recording '" << path << "'";
+
+  std::vector<Call> calls;
+  std::unordered_map<uint64_t, size_t> indexes;
+
+  while (auto record = reader->Next()) {
+    switch (record->type) {
+      case Recording::Type::Call:
+        indexes[record->call] = calls.size();
+        calls.push_back(Call{std::move(record->method), record->time, {}});
+        break;
+      case Recording::Type::Request: {
+        auto iterator = indexes.find(record->call);
+        if (iterator != indexes.end()) {
+          calls[iterator->second].requests.push_back(
+              std::move(record->request));
+        }
+        break;
+      }
+    }
+  }
+
+  // NOTE: calls are recorded in the order they were received but
+  // sort anyway in case a recording was assembled some other way.
+  std::stable_sort(
+      calls.begin(),
+      calls.end(),
+      [](const Call& left, const Call& right) {
+        return left.time < right.time;
+      });
+
+  return calls;
+}
+
+////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char** argv) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  google::InitGoogleLogging(argv[0]);
+
+  CHECK(!FLAGS_recording.empty()) << "'--recording' is required";
+  CHECK_GE(FLAGS_speed, 0) << "'--speed' must not be negative";
+  CHECK_GT(FLAGS_concurrency, 0) << "'--concurrency' must be positive";
+
+  std::vector<Call> calls = Load(FLAGS_recording);
+
+  Borrowable<CompletionPool> pool;
+
+  Client client(
+      "localhost:" + std::to_string(FLAGS_port),
+      grpc::InsecureChannelCredentials(),
+      pool.Borrow());
+
+  struct Pending {
+    const Call* call;
+    const Replayer* replayer;
+    Clock::time_point intended;
+  };
+
+  std::mutex mutex;
+  std::condition_variable scheduled;
+  std::deque<Pending> pending;
+  bool done = false;
+
+  std::vector<std::vector<Clock::duration>> latencies(FLAGS_concurrency);
+  std::vector<size_t> errors(FLAGS_concurrency, 0);
+
+  std::vector<std::thread> workers;
+  for (int i = 0; i < FLAGS_concurrency; i++) {
+    workers.emplace_back([&, i]() {
+      while (true) {
+        Pending next;
+        {
+          std::unique_lock lock(mutex);
+          scheduled.wait(lock, [&]() {
+            return !pending.empty() || done;
+          });
+          if (pending.empty()) {
+            return;
+          }
+          next = pending.front();
+          pending.pop_front();
+        }
+
+        if ((*next.replayer)(client, *next.call)) {
+          latencies[i].push_back(Clock::now() - next.intended);
+        } else {
+          errors[i]++;
+        }
+      }
+    });
+  }
+
+  std::unordered_map<std::string, size_t> skipped;
+
+  auto start = Clock::now();
+
+  for (const auto& call : calls) {
+    auto iterator = Replayers().find(call.method);
+
+    if (iterator == Replayers().end()) {
+      skipped[call.method]++;
+      continue;
+    }
+
+    auto intended = start;
+
+    if (FLAGS_speed > 0) {
+      intended += std::chrono::duration_cast<Clock::duration>(
+          call.time / FLAGS_speed);
+      std::this_thread::sleep_until(intended);
+    } else {
+      intended = Clock::now();
+    }
+
+    {
+      std::scoped_lock lock(mutex);
+      pending.push_back(Pending{&call, &iterator->second, intended});
+    }
+
+    scheduled.notify_one();
+  }
+
+  {
+    std::scoped_lock lock(mutex);
+    done = true;
+  }
+
+  scheduled.notify_all();
+
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  auto elapsed = std::chrono::duration<double>(Clock::now() - start);
+
+  std::vector<Clock::duration> all;
+  size_t failed = 0;
+  for (int i = 0; i < FLAGS_concurrency; i++) {
+    all.insert(all.end(), latencies[i].begin(), latencies[i].end());
+    failed += errors[i];
+  }
+
+  for (auto& [method, count] : skipped) {
+    std::cout << "skipped " << count << " call(s) to unknown method "
+              << method << std::endl;
+  }
+
+  std::cout << std::fixed << std::setprecision(1)
+            << "calls = " << calls.size()
+            << " replayed = " << all.size() + failed
+            << " errors = " << failed
+            << " elapsed = " << elapsed.count() << "s"
+            << std::endl;
+
+  if (!all.empty()) {
+    std::sort(all.begin(), all.end());
+
+    auto percentile = [&](double p) {
+      size_t index = std::min(
+          all.size() - 1,
+          static_cast<size_t>(p / 100 * all.size()));
+      return std::chrono::duration<double, std::micro>(all[index]).count();
+    };
+
+    std::cout << "latency (us):"
+              << " p50 = " << percentile(50)
+              << " p90 = " << percentile(90)
+              << " p99 = " << percentile(99)
+              << " max = " << percentile(100)
+              << std::endl;
+  }
+
+  return failed == 0 ? 0 : 1;
+}
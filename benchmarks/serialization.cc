@@ -0,0 +1,104 @@
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "examples/protos/helloworld.grpc.pb.h"
+#include "glog/logging.h"
+#include "grpcpp/impl/codegen/proto_utils.h"
+#include "grpcpp/support/byte_buffer.h"
+
+using helloworld::HelloRequest;
+
+////////////////////////////////////////////////////////////////////////
+
+// Measures serializing and deserializing messages exactly like
+// 'ServerWriter' and 'ServerReader' do (i.e., via
+// '::grpc::SerializationTraits') for messages of 'state.range(0)'
+// bytes, including deserializing into a reused message like
+// 'ServerReader::ReadRecycled()' does.
+//
+// Run with:
+//
+//   bazel run -c opt //benchmarks:serialization
+
+////////////////////////////////////////////////////////////////////////
+
+static HelloRequest Request(int64_t size) {
+  HelloRequest request;
+  request.set_name(std::string(size, 'x'));
+  return request;
+}
+
+////////////////////////////////////////////////////////////////////////
+
+static void BM_Serialize(benchmark::State& state) {
+  auto request = Request(state.range(0));
+
+  for (auto _ : state) {
+    ::grpc::ByteBuffer buffer;
+    bool own = true;
+    auto status = ::grpc::SerializationTraits<HelloRequest>::Serialize(
+        request,
+        &buffer,
+        &own);
+    CHECK(status.ok()) << status.error_message();
+    benchmark::DoNotOptimize(buffer);
+  }
+
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_Serialize)->Range(8, 64 << 10);
+
+////////////////////////////////////////////////////////////////////////
+
+template <typename F>
+static void Deserialize(benchmark::State& state, F f) {
+  ::grpc::ByteBuffer serialized;
+  bool own = true;
+  auto status = ::grpc::SerializationTraits<HelloRequest>::Serialize(
+      Request(state.range(0)),
+      &serialized,
+      &own);
+  CHECK(status.ok()) << status.error_message();
+
+  for (auto _ : state) {
+    // NOTE: deserializing consumes the buffer so we need a copy
+    // (which only copies a reference to the underlying slices).
+    ::grpc::ByteBuffer buffer(serialized);
+    f(&buffer);
+  }
+
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+////////////////////////////////////////////////////////////////////////
+
+static void BM_Deserialize(benchmark::State& state) {
+  Deserialize(state, [](::grpc::ByteBuffer* buffer) {
+    HelloRequest request;
+    auto status = ::grpc::SerializationTraits<HelloRequest>::Deserialize(
+        buffer,
+        &request);
+    CHECK(status.ok()) << status.error_message();
+    benchmark::DoNotOptimize(request);
+  });
+}
+
+BENCHMARK(BM_Deserialize)->Range(8, 64 << 10);
+
+////////////////////////////////////////////////////////////////////////
+
+static void BM_DeserializeRecycled(benchmark::State& state) {
+  HelloRequest request;
+  Deserialize(state, [&](::grpc::ByteBuffer* buffer) {
+    auto status = ::grpc::SerializationTraits<HelloRequest>::Deserialize(
+        buffer,
+        &request);
+    CHECK(status.ok()) << status.error_message();
+    benchmark::DoNotOptimize(request);
+  });
+}
+
+BENCHMARK(BM_DeserializeRecycled)->Range(8, 64 << 10);
+
+////////////////////////////////////////////////////////////////////////
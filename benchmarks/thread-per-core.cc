@@ -0,0 +1,127 @@
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "eventuals/concurrent.h"
+#include "eventuals/grpc/client.h"
+#include "eventuals/grpc/server.h"
+#include "eventuals/iterate.h"
+#include "eventuals/loop.h"
+#include "eventuals/map.h"
+#include "test/helloworld.eventuals.h"
+
+using helloworld::HelloReply;
+using helloworld::HelloRequest;
+
+using helloworld::eventuals::Greeter;
+
+using stout::Borrowable;
+
+using eventuals::Concurrent;
+using eventuals::Iterate;
+using eventuals::Loop;
+using eventuals::Map;
+
+using eventuals::grpc::Client;
+using eventuals::grpc::CompletionPool;
+using eventuals::grpc::ServerBuilder;
+
+////////////////////////////////////////////////////////////////////////
+
+// Compares the throughput of a server whose completion queues share
+// endpoints with one built with 'ServerBuilder::SetThreadPerCore()'
+// as the number of completion queues grows. Each iteration issues a
+// batch of concurrent unary calls.
+//
+// Run with:
+//
+//   bazel run -c opt //benchmarks:thread-per-core
+
+////////////////////////////////////////////////////////////////////////
+
+class GreeterServiceImpl final : public Greeter::Service<GreeterServiceImpl> {
+ public:
+  auto SayHello(::grpc::ServerContext* context, HelloRequest&& request) {
+    HelloReply reply;
+    reply.set_message("Hello " + request.name());
+    return reply;
+  }
+};
+
+////////////////////////////////////////////////////////////////////////
+
+static constexpr size_t kCallsPerIteration = 64;
+
+static void BM_ThreadPerCore(benchmark::State& state, bool threadPerCore) {
+  GreeterServiceImpl service;
+
+  ServerBuilder builder;
+
+  builder.SetNumberOfCompletionQueues(state.range(0));
+
+  if (threadPerCore) {
+    builder.SetThreadPerCore();
+  }
+
+  int port = 0;
+
+  builder.AddListeningPort(
+      "0.0.0.0:0",
+      grpc::InsecureServerCredentials(),
+      &port);
+
+  builder.RegisterService(&service);
+
+  auto build = builder.BuildAndStart();
+
+  CHECK(build.status.ok()) << build.status.error();
+
+  auto server = std::move(build.server);
+
+  Borrowable<CompletionPool> pool;
+
+  Client client(
+      "0.0.0.0:" + std::to_string(port),
+      grpc::InsecureChannelCredentials(),
+      pool.Borrow());
+
+  std::vector<size_t> calls(kCallsPerIteration);
+
+  for (auto _ : state) {
+    auto batch = [&]() {
+      return Iterate(calls)
+          | Concurrent([&]() {
+               return Map([&](size_t) {
+                 HelloRequest request;
+                 request.set_name("emily");
+                 return client.Unary<
+                     helloworld::Greeter,
+                     HelloRequest,
+                     HelloReply>("SayHello", std::move(request));
+               });
+             })
+          | Map([](auto&& result) {
+               CHECK(result.status.ok()) << result.status.error_message();
+             })
+          | Loop();
+    };
+
+    *batch();
+  }
+
+  state.SetItemsProcessed(state.iterations() * kCallsPerIteration);
+
+  server->Shutdown();
+  server->Wait();
+}
+
+BENCHMARK_CAPTURE(BM_ThreadPerCore, Shared, false)
+    ->RangeMultiplier(2)
+    ->Range(1, 16)
+    ->UseRealTime();
+
+BENCHMARK_CAPTURE(BM_ThreadPerCore, ThreadPerCore, true)
+    ->RangeMultiplier(2)
+    ->Range(1, 16)
+    ->UseRealTime();
+
+////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,76 @@
+#include "benchmark/benchmark.h"
+#include "eventuals/grpc/traits.h"
+#include "examples/protos/helloworld.grpc.pb.h"
+#include "glog/logging.h"
+#include "google/protobuf/descriptor.h"
+
+using helloworld::HelloReply;
+using helloworld::HelloRequest;
+
+using eventuals::grpc::RequestResponseTraits;
+using eventuals::grpc::Stream;
+
+////////////////////////////////////////////////////////////////////////
+
+// Measures 'RequestResponseTraits::Validate()' which both the client
+// and the server do for every call (after looking up the method,
+// which is measured too) and which compares type names that are
+// computed by default constructing messages.
+//
+// Run with:
+//
+//   bazel run -c opt //benchmarks:traits
+
+////////////////////////////////////////////////////////////////////////
+
+static const google::protobuf::MethodDescriptor* SayHello() {
+  return google::protobuf::DescriptorPool::generated_pool()
+      ->FindMethodByName("helloworld.Greeter.SayHello");
+}
+
+////////////////////////////////////////////////////////////////////////
+
+static void BM_FindMethod(benchmark::State& state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(SayHello());
+  }
+}
+
+BENCHMARK(BM_FindMethod);
+
+////////////////////////////////////////////////////////////////////////
+
+static void BM_Validate(benchmark::State& state) {
+  const auto* method = SayHello();
+
+  CHECK(method != nullptr);
+
+  for (auto _ : state) {
+    auto error = RequestResponseTraits::Validate<HelloRequest, HelloReply>(
+        method);
+    CHECK(!error) << error->message;
+  }
+}
+
+BENCHMARK(BM_Validate);
+
+////////////////////////////////////////////////////////////////////////
+
+// NOTE: fails validation on the first check so this is the cheapest
+// possible validation.
+static void BM_ValidateMismatch(benchmark::State& state) {
+  const auto* method = SayHello();
+
+  CHECK(method != nullptr);
+
+  for (auto _ : state) {
+    auto error = RequestResponseTraits::Validate<
+        Stream<HelloRequest>,
+        HelloReply>(method);
+    CHECK(error);
+  }
+}
+
+BENCHMARK(BM_ValidateMismatch);
+
+////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,148 @@
+#include "benchmark/benchmark.h"
+#include "eventuals/grpc/client.h"
+#include "eventuals/grpc/server.h"
+#include "eventuals/let.h"
+#include "eventuals/loop.h"
+#include "eventuals/map.h"
+#include "eventuals/terminal.h"
+#include "eventuals/then.h"
+#include "examples/protos/helloworld.grpc.pb.h"
+
+using helloworld::Greeter;
+using helloworld::HelloReply;
+using helloworld::HelloRequest;
+
+using stout::Borrowable;
+
+using eventuals::Let;
+using eventuals::Loop;
+using eventuals::Map;
+using eventuals::Terminate;
+using eventuals::Then;
+
+using eventuals::grpc::Client;
+using eventuals::grpc::CompletionPool;
+using eventuals::grpc::Server;
+using eventuals::grpc::ServerBuilder;
+
+////////////////////////////////////////////////////////////////////////
+
+// Compares the latency of a unary call made with 'Client::Call()',
+// which uses a bidirectional stream and thus requires a completion
+// queue event for each of starting, writing, reading, reading the
+// end of the stream, and finishing, against 'Client::Unary()' which
+// only requires a single completion queue event.
+//
+// Run with:
+//
+//   bazel run -c opt //benchmarks:unary
+
+////////////////////////////////////////////////////////////////////////
+
+// Serves 'Greeter.SayHello' until the server is shutdown.
+static auto Serve(Server& server) {
+  return server.Accept<Greeter, HelloRequest, HelloReply>("SayHello")
+      | Map(Let([](auto& call) {
+           return UnaryPrologue(call)
+               | Then([](auto&& request) {
+                    HelloReply reply;
+                    reply.set_message("Hello " + request.name());
+                    return reply;
+                  })
+               | UnaryEpilogue(call);
+         }))
+      | Loop();
+}
+
+////////////////////////////////////////////////////////////////////////
+
+// Runs 'f' with a client connected to an in-process server that is
+// serving 'Greeter.SayHello'.
+template <typename F>
+static void WithGreeter(F f) {
+  ServerBuilder builder;
+
+  int port = 0;
+
+  builder.AddListeningPort(
+      "0.0.0.0:0",
+      grpc::InsecureServerCredentials(),
+      &port);
+
+  auto build = builder.BuildAndStart();
+
+  CHECK(build.status.ok()) << build.status.error();
+
+  auto server = std::move(build.server);
+
+  auto [served, k] = Terminate(Serve(*server));
+
+  k.Start();
+
+  Borrowable<CompletionPool> pool;
+
+  Client client(
+      "0.0.0.0:" + std::to_string(port),
+      grpc::InsecureChannelCredentials(),
+      pool.Borrow());
+
+  f(client);
+
+  server->Shutdown();
+  server->Wait();
+}
+
+////////////////////////////////////////////////////////////////////////
+
+static void BM_Call(benchmark::State& state) {
+  WithGreeter([&](Client& client) {
+    for (auto _ : state) {
+      auto call = [&]() {
+        return client.Call<Greeter, HelloRequest, HelloReply>("SayHello")
+            | Then(Let([](auto& call) {
+                 HelloRequest request;
+                 request.set_name("emily");
+                 return call.Writer().WriteLast(request)
+                     | call.Reader().Read()
+                     | Map([](auto&& response) {
+                          benchmark::DoNotOptimize(response);
+                        })
+                     | Loop()
+                     | call.Finish();
+               }));
+      };
+
+      auto status = *call();
+
+      CHECK(status.ok()) << status.error_message();
+    }
+  });
+}
+
+BENCHMARK(BM_Call)->UseRealTime();
+
+////////////////////////////////////////////////////////////////////////
+
+static void BM_Unary(benchmark::State& state) {
+  WithGreeter([&](Client& client) {
+    for (auto _ : state) {
+      auto call = [&]() {
+        HelloRequest request;
+        request.set_name("emily");
+        return client.Unary<Greeter, HelloRequest, HelloReply>(
+            "SayHello",
+            std::move(request));
+      };
+
+      auto result = *call();
+
+      CHECK(result.status.ok()) << result.status.error_message();
+
+      benchmark::DoNotOptimize(result.response);
+    }
+  });
+}
+
+BENCHMARK(BM_Unary)->UseRealTime();
+
+////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,111 @@
+#include "eventuals/grpc/arena.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "eventuals/grpc/logging.h"
+#include "glog/logging.h"
+
+#if defined(EVENTUALS_GRPC_JEMALLOC)
+#include "jemalloc/jemalloc.h"
+#endif
+
+////////////////////////////////////////////////////////////////////////
+
+#if defined(EVENTUALS_GRPC_JEMALLOC_THP)
+// NOTE: jemalloc reads this when it initializes, i.e., before 'main()'
+// so it can't be a runtime option; set 'MALLOC_CONF' in the
+// environment instead to enable transparent huge pages without
+// rebuilding.
+extern "C" {
+const char* malloc_conf = "thp:always,metadata_thp:auto";
+}
+#endif
+
+////////////////////////////////////////////////////////////////////////
+
+namespace eventuals {
+namespace grpc {
+
+////////////////////////////////////////////////////////////////////////
+
+#if defined(EVENTUALS_GRPC_JEMALLOC)
+
+// Arenas of threads that have exited which can be reused since jemalloc
+// has no way of destroying an arena that may still own allocations.
+static std::mutex* mutex = new std::mutex();
+static std::vector<unsigned>* arenas = new std::vector<unsigned>();
+
+// Returns the arena of a thread to 'arenas' when the thread exits.
+struct Arena {
+  ~Arena() {
+    if (index) {
+      std::scoped_lock lock(*mutex);
+      arenas->push_back(index.value());
+    }
+  }
+
+  std::optional<unsigned> index;
+};
+
+#endif
+
+////////////////////////////////////////////////////////////////////////
+
+void BindThreadToArena() {
+#if defined(EVENTUALS_GRPC_JEMALLOC)
+  static thread_local Arena arena;
+
+  if (arena.index) {
+    return; // Already bound.
+  }
+
+  unsigned index = 0;
+
+  {
+    std::scoped_lock lock(*mutex);
+    if (!arenas->empty()) {
+      index = arenas->back();
+      arenas->pop_back();
+    } else {
+      size_t size = sizeof(index);
+      int error = mallctl("arenas.create", &index, &size, nullptr, 0);
+      if (error != 0) {
+        LOG(WARNING)
+            << "Failed to create jemalloc arena: " << std::strerror(error);
+        return;
+      }
+    }
+  }
+
+  int error = mallctl(
+      "thread.arena",
+      nullptr,
+      nullptr,
+      &index,
+      sizeof(index));
+
+  if (error != 0) {
+    LOG(WARNING)
+        << "Failed to bind thread to jemalloc arena " << index
+        << ": " << std::strerror(error);
+    std::scoped_lock lock(*mutex);
+    arenas->push_back(index);
+    return;
+  }
+
+  arena.index = index;
+
+  EVENTUALS_GRPC_LOG(1) << "Bound thread to jemalloc arena " << index;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////
+
+} // namespace grpc
+} // namespace eventuals
+
+////////////////////////////////////////////////////////////////////////
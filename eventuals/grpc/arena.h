@@ -0,0 +1,26 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////////////
+
+namespace eventuals {
+namespace grpc {
+
+////////////////////////////////////////////////////////////////////////
+
+// Binds the calling thread to a dedicated jemalloc arena for as long
+// as the thread is running so that threads polling completion queues
+// don't contend with each other (e.g., when one thread frees what
+// another thread allocated). The arena gets reused by a later thread
+// after this thread exits.
+//
+// Only does something when built with '--config=jemalloc' (see
+// .bazelrc), otherwise (or if binding fails) the thread keeps using
+// the default allocator.
+void BindThreadToArena();
+
+////////////////////////////////////////////////////////////////////////
+
+} // namespace grpc
+} // namespace eventuals
+
+////////////////////////////////////////////////////////////////////////
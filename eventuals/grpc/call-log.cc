@@ -0,0 +1,257 @@
+#include "eventuals/grpc/call-log.h"
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+
+#include "glog/logging.h"
+
+////////////////////////////////////////////////////////////////////////
+
+namespace eventuals {
+namespace grpc {
+
+////////////////////////////////////////////////////////////////////////
+
+std::unique_ptr<CallLog> CallLog::Open(
+    const std::string& path,
+    CallLogOptions options) {
+#if defined(_WIN32)
+  LOG(WARNING) << "Call logs are not supported on Windows";
+  return nullptr;
+#else
+  CHECK(options.rings > 0) << "must have at least one ring";
+  CHECK(options.events > 0) << "must have at least one event per ring";
+
+  size_t events = 1;
+  while (events < options.events) {
+    events <<= 1;
+  }
+
+  size_t size = sizeof(Header)
+      + options.rings * (sizeof(Ring) + events * sizeof(Event));
+
+  int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+
+  if (fd < 0) {
+    PLOG(WARNING) << "Failed to open call log '" << path << "'";
+    return nullptr;
+  }
+
+  // NOTE: extending the file fills it with zeros, i.e., every ring
+  // starts out empty.
+  if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+    PLOG(WARNING) << "Failed to size call log '" << path << "'";
+    close(fd);
+    return nullptr;
+  }
+
+  void* base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+  // NOTE: the mapping keeps the file open.
+  close(fd);
+
+  if (base == MAP_FAILED) {
+    PLOG(WARNING) << "Failed to map call log '" << path << "'";
+    return nullptr;
+  }
+
+  auto* header = static_cast<Header*>(base);
+  header->rings = static_cast<uint32_t>(options.rings);
+  header->events = static_cast<uint32_t>(events);
+  header->steady = Now();
+  header->system = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::system_clock::now().time_since_epoch())
+                       .count();
+
+  // NOTE: writing the magic last so that a log is only recognized once
+  // its header is complete.
+  std::memcpy(header->magic, kMagic, sizeof(header->magic));
+
+  return std::unique_ptr<CallLog>(new CallLog(
+      static_cast<char*>(base),
+      size,
+      options.rings,
+      events,
+      options.sample));
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////
+
+CallLog::~CallLog() {
+#if !defined(_WIN32)
+  // NOTE: the events stay in the file (via the page cache) without
+  // needing an 'msync()'.
+  munmap(base_, size_);
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////
+
+std::unique_ptr<CallLog::Reader> CallLog::Reader::Open(
+    const std::string& path) {
+#if defined(_WIN32)
+  // NOTE: logs can't be written on Windows (see 'CallLog::Open()')
+  // so we don't need to map the file to see any concurrent writes.
+  FILE* file = std::fopen(path.c_str(), "rb");
+  if (file == nullptr) {
+    return nullptr;
+  }
+
+  std::string contents;
+
+  char buffer[64 * 1024];
+  size_t n = 0;
+  while ((n = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+    contents.append(buffer, n);
+  }
+
+  std::fclose(file);
+
+  return Parse(contents.data(), contents.size());
+#else
+  int fd = open(path.c_str(), O_RDONLY);
+
+  if (fd < 0) {
+    return nullptr;
+  }
+
+  struct stat info;
+  if (fstat(fd, &info) != 0 || info.st_size < (off_t) sizeof(Header)) {
+    close(fd);
+    return nullptr;
+  }
+
+  size_t size = static_cast<size_t>(info.st_size);
+
+  // NOTE: mapping (rather than reading) the log so that we can check
+  // whether an event got overwritten while we were copying it, see
+  // 'Parse()'.
+  void* base = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+
+  close(fd);
+
+  if (base == MAP_FAILED) {
+    return nullptr;
+  }
+
+  auto reader = Parse(static_cast<const char*>(base), size);
+
+  munmap(base, size);
+
+  return reader;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////
+
+std::unique_ptr<CallLog::Reader> CallLog::Reader::Parse(
+    const char* contents,
+    size_t size) {
+  Header header;
+
+  if (size < sizeof(header)) {
+    return nullptr;
+  }
+
+  std::memcpy(&header, contents, sizeof(header));
+
+  if (std::memcmp(header.magic, kMagic, sizeof(header.magic)) != 0
+      || header.rings == 0
+      || header.events == 0
+      || (header.events & (header.events - 1)) != 0
+      || size
+          < sizeof(Header)
+              + header.rings
+                  * (sizeof(Ring) + header.events * sizeof(Event))) {
+    return nullptr;
+  }
+
+  std::vector<Record> records;
+
+  const char* ring = contents + sizeof(Header);
+
+  for (size_t i = 0; i < header.rings; i++) {
+    const char* events = ring + sizeof(Ring);
+
+    for (size_t j = 0; j < header.events; j++) {
+      const char* event = events + j * sizeof(Event);
+
+      // NOTE: copying the fields out one at a time (rather than the
+      // whole 'Event') as 'Event' has an atomic.
+      auto field = [&](auto* value, size_t offset) {
+        std::memcpy(value, event + offset, sizeof(*value));
+      };
+
+      // NOTE: like a seqlock we read 'sequence' both before and
+      // after copying the rest of the fields so that we can skip an
+      // event that got (re)written while we copied it.
+      const auto* live = reinterpret_cast<const std::atomic<uint64_t>*>(
+          event + offsetof(Event, sequence));
+
+      uint64_t sequence = live->load(std::memory_order_acquire);
+
+      // Skip events that were never written or that are being
+      // written.
+      if (sequence == 0 || ((sequence - 1) & (header.events - 1)) != j) {
+        continue;
+      }
+
+      Record record;
+
+      int64_t nanoseconds = 0;
+      uint8_t length = 0;
+
+      field(&record.call, offsetof(Event, call));
+      field(&nanoseconds, offsetof(Event, nanoseconds));
+      field(&record.value, offsetof(Event, value));
+      field(&record.phase, offsetof(Event, phase));
+      field(&length, offsetof(Event, length));
+
+      record.time = std::chrono::nanoseconds(nanoseconds - header.steady);
+
+      record.data.assign(
+          event + offsetof(Event, data),
+          std::min<size_t>(length, sizeof(Event::data)));
+
+      std::atomic_thread_fence(std::memory_order_acquire);
+
+      if (live->load(std::memory_order_relaxed) != sequence) {
+        continue;
+      }
+
+      records.push_back(std::move(record));
+    }
+
+    ring = events + header.events * sizeof(Event);
+  }
+
+  std::stable_sort(
+      records.begin(),
+      records.end(),
+      [](const Record& a, const Record& b) {
+        return a.time < b.time;
+      });
+
+  return std::unique_ptr<Reader>(new Reader(
+      std::chrono::system_clock::time_point(
+          std::chrono::duration_cast<
+              std::chrono::system_clock::duration>(
+              std::chrono::nanoseconds(header.system))),
+      std::move(records)));
+}
+
+////////////////////////////////////////////////////////////////////////
+
+} // namespace grpc
+} // namespace eventuals
+
+////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,334 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "grpcpp/support/byte_buffer.h"
+
+////////////////////////////////////////////////////////////////////////
+
+namespace eventuals {
+namespace grpc {
+
+////////////////////////////////////////////////////////////////////////
+
+// Sizes a 'CallLog' and what it logs, see 'CallLog::Open()'.
+struct CallLogOptions {
+  // Number of rings.
+  size_t rings = 16;
+
+  // Number of events per ring (rounded up to a power of two).
+  size_t events = 64 * 1024;
+
+  // Log the first bytes of the messages of one out of every 'sample'
+  // calls, or none if 0.
+  size_t sample = 0;
+};
+
+////////////////////////////////////////////////////////////////////////
+
+// 'CallLog' is a binary log of the lifecycle of each call (when it
+// was accepted and its method and host, each message read and
+// written, when it was finished and with what status, and when it was
+// cancelled and done) that is cheap enough to leave on all the time,
+// unlike 'EVENTUALS_GRPC_LOG()' which formats entire messages.
+//
+// Events get written into fixed size slots of a ring buffer in a
+// memory mapped file, so logging an event is an atomic increment, a
+// clock read, and a few stores (no locks, allocations, formatting, or
+// system calls). Each thread writes to its own ring (threads share
+// rings round robin once there are more threads than rings) and once
+// a ring is full its oldest events get overwritten. Since the file is
+// memory mapped the most recent events are there even if the process
+// crashes.
+//
+// The first bytes of each message of one out of every
+// 'CallLogOptions::sample' calls can also be logged.
+//
+// A log is made up of a 'Header' followed by 'Header::rings' rings,
+// each a 'Ring' followed by 'Header::events' events, see
+// 'CallLog::Reader' (and '//benchmarks:decode-call-log') for reading
+// a log and 'ServerBuilder::SetCallLog()' for logging a server's
+// calls.
+//
+// NOTE: integers are written in host byte order, i.e., logs are only
+// meant to be read on the same kind of machine.
+class CallLog {
+ public:
+  enum class Phase : uint8_t {
+    // 'Event::data' is the method and host separated by '\0'.
+    Accepted = 1,
+
+    // 'Event::value' is the size of the message and 'Event::data' its
+    // first bytes if the call is sampled.
+    Read = 2,
+    Write = 3,
+
+    // 'Event::value' is the status code.
+    Finish = 4,
+
+    Cancelled = 5,
+
+    // 'Event::value' is whether or not the call was cancelled.
+    Done = 6,
+
+    // Logged right before 'Done' where 'Event::data' is how long the
+    // call spent in each 'CallPhases::Phase' (in order) in
+    // nanoseconds as 'int64_t's.
+    Phases = 7,
+  };
+
+  static constexpr char kMagic[] = "EVGRPCL1";
+
+  struct Header {
+    char magic[sizeof(kMagic) - 1];
+    uint32_t rings;
+    uint32_t events;
+
+    // When the log was opened, both from 'std::chrono::steady_clock'
+    // (which is what 'Event::nanoseconds' uses) and from
+    // 'std::chrono::system_clock' so that events can be mapped to
+    // wall clock time.
+    int64_t steady;
+    int64_t system;
+
+    char reserved[32];
+  };
+
+  struct Ring {
+    // Number of events ever written to this ring.
+    std::atomic<uint64_t> head;
+
+    char reserved[56];
+  };
+
+  struct Event {
+    // One more than the position of this event in its ring (i.e.,
+    // the value of 'Ring::head' when it was written), or 0 while it
+    // is being written.
+    std::atomic<uint64_t> sequence;
+
+    uint64_t call;
+    int64_t nanoseconds;
+    uint32_t value;
+    Phase phase;
+    uint8_t length;
+    uint16_t reserved;
+    char data[96];
+  };
+
+  static_assert(sizeof(Header) == 64);
+  static_assert(sizeof(Ring) == 64);
+  static_assert(sizeof(Event) == 128);
+  static_assert(std::atomic<uint64_t>::is_always_lock_free);
+
+  // Returns 'nullptr' if a log can't be created at 'path' (including
+  // on platforms without 'mmap()').
+  static std::unique_ptr<CallLog> Open(
+      const std::string& path,
+      CallLogOptions options = CallLogOptions());
+
+  CallLog(const CallLog&) = delete;
+
+  ~CallLog();
+
+  // Logs a new call returning an identifier for logging the rest of
+  // its lifecycle.
+  uint64_t Call(std::string_view method, std::string_view host) {
+    uint64_t call = calls_.fetch_add(1, std::memory_order_relaxed) + 1;
+
+    char data[sizeof(Event::data)];
+    size_t length = std::min(method.size(), sizeof(data));
+    std::memcpy(data, method.data(), length);
+    if (length < sizeof(data)) {
+      data[length++] = '\0';
+      size_t size = std::min(host.size(), sizeof(data) - length);
+      std::memcpy(data + length, host.data(), size);
+      length += size;
+    }
+
+    Log(call, Phase::Accepted, 0, std::string_view(data, length));
+
+    return call;
+  }
+
+  // Logs 'phase' of 'call' (as returned from 'Call()').
+  void Log(
+      uint64_t call,
+      Phase phase,
+      uint32_t value,
+      std::string_view data = std::string_view()) {
+    Ring* ring = Current();
+
+    uint64_t position = ring->head.fetch_add(1, std::memory_order_relaxed);
+
+    Event* event = Events(ring) + (position & mask_);
+
+    // NOTE: a reader ignores an event whose 'sequence' doesn't match
+    // its position, which includes while it is being (re)written.
+    event->sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    event->call = call;
+    event->nanoseconds = Now();
+    event->value = value;
+    event->phase = phase;
+    event->length = static_cast<uint8_t>(
+        std::min(data.size(), sizeof(Event::data)));
+    if (event->length > 0) {
+      std::memcpy(event->data, data.data(), event->length);
+    }
+
+    event->sequence.store(position + 1, std::memory_order_release);
+  }
+
+  // Logs a message read or written by 'call', see 'Phase::Read' and
+  // 'Phase::Write'.
+  void Message(uint64_t call, Phase phase, const ::grpc::ByteBuffer& buffer) {
+    uint32_t size = static_cast<uint32_t>(buffer.Length());
+
+    if (sample_ == 0 || call % sample_ != 0) {
+      Log(call, phase, size);
+      return;
+    }
+
+    char data[sizeof(Event::data)];
+    size_t length = 0;
+
+    std::vector<::grpc::Slice> slices;
+
+    // NOTE: 'Dump()' only takes references to the slices rather than
+    // copying them, and doesn't consume the buffer.
+    if (buffer.Dump(&slices).ok()) {
+      for (auto& slice : slices) {
+        size_t n = std::min(slice.size(), sizeof(data) - length);
+        std::memcpy(data + length, slice.begin(), n);
+        length += n;
+        if (length == sizeof(data)) {
+          break;
+        }
+      }
+    }
+
+    Log(call, phase, size, std::string_view(data, length));
+  }
+
+  // Reads a log, possibly while it is still being written.
+  class Reader {
+   public:
+    struct Record {
+      uint64_t call = 0;
+      Phase phase;
+
+      // Relative to when the log was opened.
+      std::chrono::nanoseconds time;
+
+      uint32_t value = 0;
+      std::string data;
+    };
+
+    // Returns 'nullptr' if 'path' can't be read or isn't a log.
+    static std::unique_ptr<Reader> Open(const std::string& path);
+
+    // When the log was opened.
+    std::chrono::system_clock::time_point started() const {
+      return started_;
+    }
+
+    // Returns every event still in the log ordered by when they were
+    // logged.
+    //
+    // NOTE: an event that was being written while the log was read
+    // gets skipped.
+    const std::vector<Record>& Records() const {
+      return records_;
+    }
+
+   private:
+    // Parses the log in 'contents' which might still be being written.
+    static std::unique_ptr<Reader> Parse(const char* contents, size_t size);
+
+    Reader(
+        std::chrono::system_clock::time_point started,
+        std::vector<Record>&& records)
+      : started_(started),
+        records_(std::move(records)) {}
+
+    const std::chrono::system_clock::time_point started_;
+    const std::vector<Record> records_;
+  };
+
+ private:
+  CallLog(char* base, size_t size, size_t rings, size_t events, size_t sample)
+    : base_(base),
+      size_(size),
+      rings_(rings),
+      mask_(events - 1),
+      sample_(sample),
+      id_(ids_.fetch_add(1, std::memory_order_relaxed) + 1) {}
+
+  static int64_t Now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+  Ring* At(size_t ring) {
+    return reinterpret_cast<Ring*>(
+        base_
+        + sizeof(Header)
+        + ring * (sizeof(Ring) + (mask_ + 1) * sizeof(Event)));
+  }
+
+  static Event* Events(Ring* ring) {
+    return reinterpret_cast<Event*>(ring + 1);
+  }
+
+  // Returns the ring of the current thread, picking one the first
+  // time a thread logs to this log.
+  Ring* Current() {
+    // NOTE: keyed by a unique identifier rather than by 'this' as a
+    // later log might get allocated at the same address.
+    struct Cached {
+      uint64_t id = 0;
+      Ring* ring = nullptr;
+    };
+
+    static thread_local Cached cached;
+
+    if (cached.id != id_) {
+      size_t ring = next_.fetch_add(1, std::memory_order_relaxed) % rings_;
+      cached.id = id_;
+      cached.ring = At(ring);
+    }
+
+    return cached.ring;
+  }
+
+  char* base_;
+  const size_t size_;
+  const size_t rings_;
+  const uint64_t mask_;
+  const size_t sample_;
+  const uint64_t id_;
+
+  std::atomic<uint64_t> calls_ = 0;
+  std::atomic<size_t> next_ = 0;
+
+  static inline std::atomic<uint64_t> ids_ = 0;
+};
+
+////////////////////////////////////////////////////////////////////////
+
+} // namespace grpc
+} // namespace eventuals
+
+////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,193 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "eventuals/grpc/histogram.h"
+
+////////////////////////////////////////////////////////////////////////
+
+namespace eventuals {
+namespace grpc {
+
+////////////////////////////////////////////////////////////////////////
+
+// Breaks down where the time of each call to a 'Server' goes, from
+// asking gRPC for the call until it is done, by timestamping it (see
+// 'Mark') and aggregating the time between timestamps (see 'Phase')
+// into a histogram per phase for each endpoint, see
+// 'Server::Phases()'.
+struct CallPhases {
+  // Points in the lifecycle of a call, in order.
+  enum Mark : uint8_t {
+    // 'RequestCall()' was issued for the call (only for
+    // 'ServerBackend::CompletionQueue').
+    Requested,
+
+    // gRPC handed us the call.
+    Accepted,
+
+    // The endpoint for the call was found.
+    LookedUp,
+
+    // A handler got the call from its endpoint (including after
+    // waiting for the endpoint's concurrency limit, if any).
+    Dequeued,
+
+    // The last response started to be written via 'WriteLast()'.
+    WritingLast,
+
+    // The call started to be finished.
+    Finishing,
+
+    // The call is done.
+    Done,
+
+    kMarks,
+  };
+
+  // The time from one 'Mark' until the next, in order.
+  enum Phase : uint8_t {
+    // Waiting in 'RequestCall()', i.e., until a call arrived.
+    RequestCall,
+
+    // Looking up the endpoint (including waiting for its lock).
+    Lookup,
+
+    // Waiting in the endpoint until being dequeued by a handler.
+    Queued,
+
+    // Handling the call until its last response or finishing.
+    Handler,
+
+    // Writing the last response until finishing.
+    WriteLast,
+
+    // Finishing until done, e.g., until 'ServerCall::WaitForDone()'.
+    Finish,
+
+    kPhases,
+  };
+
+  static const char* Name(Phase phase) {
+    switch (phase) {
+      case RequestCall:
+        return "RequestCall";
+      case Lookup:
+        return "Lookup";
+      case Queued:
+        return "Queued";
+      case Handler:
+        return "Handler";
+      case WriteLast:
+        return "WriteLast";
+      case Finish:
+        return "Finish";
+      default:
+        return "Unknown";
+    }
+  }
+
+  using Durations = std::array<std::chrono::nanoseconds, kPhases>;
+
+  // The timestamps of a single call which get stored inline in its
+  // 'ServerContext'.
+  //
+  // NOTE: marks can be made from different threads, e.g., a call
+  // can be done (because it was cancelled) while its handler is still
+  // running.
+  class Timeline {
+   public:
+    void Mark(CallPhases::Mark mark) {
+      marks_[mark].store(
+          std::chrono::steady_clock::now().time_since_epoch().count(),
+          std::memory_order_relaxed);
+    }
+
+    // Returns how long the call spent in each phase. A mark that was
+    // never made (e.g., 'WritingLast' for a call finished via
+    // 'ServerWriter::WriteAndFinish()') counts as made at the same
+    // time as the next mark that was, i.e., the phase ending at it
+    // takes no time and the phase after it takes all of the time.
+    Durations Measure() const {
+      std::array<int64_t, kMarks> marks;
+
+      for (size_t i = kMarks; i-- > 0;) {
+        marks[i] = marks_[i].load(std::memory_order_relaxed);
+        if (marks[i] == 0 && i + 1 < kMarks) {
+          marks[i] = marks[i + 1];
+        }
+      }
+
+      Durations durations;
+
+      for (size_t i = 0; i < kPhases; i++) {
+        durations[i] = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::duration(
+                std::max<int64_t>(0, marks[i + 1] - marks[i])));
+      }
+
+      return durations;
+    }
+
+   private:
+    // In 'std::chrono::steady_clock' ticks, or 0 if not (yet) made.
+    std::array<std::atomic<int64_t>, kMarks> marks_ = {};
+  };
+
+  // Histograms for each phase of the calls to an endpoint.
+  class Histograms {
+   public:
+    void Record(const Durations& durations) {
+      for (size_t i = 0; i < kPhases; i++) {
+        histograms_[i].Record(durations[i]);
+      }
+    }
+
+    const Histogram& operator[](Phase phase) const {
+      return histograms_[phase];
+    }
+
+   private:
+    std::array<Histogram, kPhases> histograms_;
+  };
+
+  // Percentiles of a phase, see 'Server::Phases()'.
+  struct Summary {
+    uint64_t calls = 0;
+    std::chrono::nanoseconds p50;
+    std::chrono::nanoseconds p90;
+    std::chrono::nanoseconds p99;
+    std::chrono::nanoseconds max;
+  };
+
+  static Summary Summarize(const Histogram& histogram) {
+    return Summary{
+        histogram.count(),
+        histogram.Percentile(50),
+        histogram.Percentile(90),
+        histogram.Percentile(99),
+        histogram.max()};
+  }
+};
+
+////////////////////////////////////////////////////////////////////////
+
+// Summaries of each phase of the calls to an endpoint, see
+// 'Server::Phases()'.
+struct EndpointPhases {
+  std::string path;
+  std::string host;
+  std::array<CallPhases::Summary, CallPhases::kPhases> phases;
+};
+
+////////////////////////////////////////////////////////////////////////
+
+} // namespace grpc
+} // namespace eventuals
+
+////////////////////////////////////////////////////////////////////////
@@ -1,17 +1,27 @@
 #pragma once
 
-#include "eventuals/callback.h"
+#include <atomic>
+#include <mutex>
+#include <optional>
+#include <utility>
+
 #include "eventuals/eventual.h"
 #include "eventuals/grpc/completion-pool.h"
 #include "eventuals/grpc/logging.h"
+#include "eventuals/grpc/poller.h"
+#include "eventuals/grpc/read-ahead.h"
+#include "eventuals/grpc/tag.h"
 #include "eventuals/grpc/traits.h"
 #include "eventuals/lazy.h"
 #include "eventuals/stream.h"
 #include "eventuals/then.h"
+#include "glog/logging.h"
 #include "grpcpp/client_context.h"
 #include "grpcpp/completion_queue.h"
 #include "grpcpp/create_channel.h"
 #include "grpcpp/generic/generic_stub.h"
+#include "grpcpp/support/async_unary_call.h"
+#include "grpcpp/support/client_callback.h"
 #include "stout/borrowable.h"
 
 ////////////////////////////////////////////////////////////////////////
@@ -41,21 +51,65 @@ class ClientReader {
       stream_(stream) {}
 
   auto Read() {
+    return ReadImpl(/* recycle = */ false);
+  }
+
+  // Like 'Read()' but rather than emitting a new response each time
+  // emits the same response object (as an lvalue) which gets reused,
+  // keeping the capacity of its strings and repeated fields, for the
+  // next response.
+  //
+  // NOTE: the emitted response is only valid until the next response
+  // gets read so it must be copied (or moved) if it needs to be kept.
+  auto ReadRecycled() {
+    return ReadImpl(/* recycle = */ true);
+  }
+
+  // Like 'Read()' but keeps reading ahead of the consumer into a
+  // buffer bounded by 'options', see 'ReadAhead()'.
+  auto Read(ReadAheadOptions options) {
+    return ReadAhead<ResponseType_, ResponseType_>(
+        options,
+        [this](ResponseType_* response, Tag* tag) {
+          stream_->Read(response, tag);
+        },
+        [](const ResponseType_& response) {
+          return response.ByteSizeLong();
+        },
+        [this](ResponseType_&& response) {
+          EVENTUALS_GRPC_LOG(1)
+              << "Received response for call ("
+              << context_ << ")"
+              << " with host = " << host_.value_or("*")
+              << " with path = " << path_
+              << " and response =\n"
+              << response.DebugString();
+
+          return std::optional<ResponseType_>(std::move(response));
+        });
+  }
+
+ private:
+  auto ReadImpl(bool recycle) {
     struct Data {
       ClientReader* reader = nullptr;
       ResponseType_ response;
+      bool recycle = false;
       void* k = nullptr;
     };
     return eventuals::Stream<ResponseType_>()
         .next([this,
                data = Data{},
-               callback = Callback<bool>()](auto& k) mutable {
+               tag = Tag(),
+               recycle](auto& k) mutable {
           using K = std::decay_t<decltype(k)>;
-          if (!callback) {
+          if (!tag) {
             data.reader = this;
+            data.recycle = recycle;
             data.k = &k;
-            callback = [&data](bool ok) mutable {
-              auto& k = *reinterpret_cast<K*>(data.k);
+            tag = Tag(&data, [](void* d, bool ok) {
+              auto& data = *static_cast<Data*>(d);
+              auto& k = *static_cast<K*>(data.k);
               if (ok) {
                 EVENTUALS_GRPC_LOG(1)
                     << "Received response for call ("
@@ -65,7 +119,11 @@ class ClientReader {
                     << " and response =\n"
                     << data.response.DebugString();
 
-                k.Emit(std::move(data.response));
+                if (data.recycle) {
+                  k.Emit(data.response);
+                } else {
+                  k.Emit(std::move(data.response));
+                }
               } else {
                 EVENTUALS_GRPC_LOG(1)
                     << "Received notice of last response (or error) for call ("
@@ -76,14 +134,13 @@ class ClientReader {
                 // Signify end of stream (or error).
                 k.Ended();
               }
-            };
+            });
           }
 
-          stream_->Read(&data.response, &callback);
+          stream_->Read(&data.response, &tag);
         });
   }
 
- private:
   // TODO(benh): explicitly borrow these for better safety (they come
   // from 'ClientCall' and outlive this 'ClientReader').
   const std::string& path_;
@@ -124,16 +181,18 @@ class ClientWriter {
         .raises<std::runtime_error>()
         .start(
             [this,
-             callback = Callback<bool>(),
+             tag = Tag(),
              request = std::move(request),
              options = std::move(options)](auto& k) mutable {
-              callback = [&k](bool ok) mutable {
+              using K = std::decay_t<decltype(k)>;
+              tag = Tag(&k, [](void* k, bool ok) {
                 if (ok) {
-                  k.Start();
+                  static_cast<K*>(k)->Start();
                 } else {
-                  k.Fail(std::runtime_error("Failed to write"));
+                  static_cast<K*>(k)->Fail(
+                      std::runtime_error("Failed to write"));
                 }
-              };
+              });
 
               EVENTUALS_GRPC_LOG(1)
                   << "Sending " << (options.is_last_message() ? "(last)" : "")
@@ -143,7 +202,7 @@ class ClientWriter {
                   << " and request =\n"
                   << request.DebugString();
 
-              stream_->Write(request, options, &callback);
+              stream_->Write(request, options, &tag);
             });
   }
 
@@ -168,6 +227,222 @@ class ClientWriter {
 
 ////////////////////////////////////////////////////////////////////////
 
+// Implements the same interface as the '::grpc::ClientAsyncReaderWriter'
+// returned from 'PrepareCall()' but using a reactor from gRPC's
+// callback API so that each callback (i.e., "tag") gets invoked
+// directly from one of gRPC's internal threads rather than from a
+// thread polling a completion queue.
+//
+// NOTE: unlike with the asynchronous API gRPC reads into (and writes
+// from) messages owned by this stream, which get moved into (and
+// copied from) the messages passed to 'Read()' (and 'Write()'), so
+// that an outstanding operation never refers to memory owned by a
+// call that has been abandoned, see 'Abandon()'.
+template <typename Request_, typename Response_>
+class CallbackClientStream final
+  : public ::grpc::ClientAsyncReaderWriterInterface<Request_, Response_>,
+    public ::grpc::ClientBidiReactor<Request_, Response_> {
+ public:
+  using Reactor_ = ::grpc::ClientBidiReactor<Request_, Response_>;
+
+  // NOTE: unlike with a completion queue the callback for 'tag' gets
+  // invoked before returning, i.e., on the calling thread, as there
+  // isn't a separate reaction for having started the call (any
+  // failure gets reported to subsequent operations instead).
+  void StartCall(void* tag) override {
+    // Hold the call open until 'Finish()' (or 'Abandon()') so that
+    // 'OnDone()' doesn't get invoked while we might still start more
+    // operations.
+    Reactor_::AddHold();
+    Reactor_::StartCall();
+
+    Invoke(tag, true);
+  }
+
+  // Must be called instead of destructing this stream if the call
+  // won't be finished, e.g., because the 'ClientCall' got destructed
+  // after a failure. Cancels the call and releases the hold from
+  // 'StartCall()' so that gRPC can invoke 'OnDone()' which then
+  // deletes this stream along with 'owned' (if any), which must be
+  // 'context' if the call owned it.
+  //
+  // NOTE: callbacks for any outstanding operations won't be invoked.
+  // A 'context' that isn't 'owned' must remain valid until gRPC
+  // invokes 'OnDone()', just like for any other call.
+  void Abandon(
+      ::grpc::ClientContext* context,
+      std::unique_ptr<::grpc::ClientContext>&& owned) {
+    {
+      std::scoped_lock lock(mutex_);
+      context_ = std::move(owned);
+      abandoned_.store(true);
+    }
+    context->TryCancel();
+    Reactor_::RemoveHold();
+  }
+
+  void ReadInitialMetadata(void* tag) override {
+    std::unique_lock lock(mutex_);
+    if (metadata_) {
+      bool ok = metadata_.value();
+      lock.unlock();
+      Invoke(tag, ok);
+    } else {
+      metadata_tag_ = tag;
+    }
+  }
+
+  void Read(Response_* response, void* tag) override {
+    response_ = response;
+    read_ = tag;
+    Reactor_::StartRead(&reading_);
+  }
+
+  void Write(const Request_& request, void* tag) override {
+    writing_ = request;
+    write_ = tag;
+    Reactor_::StartWrite(&writing_);
+  }
+
+  void Write(
+      const Request_& request,
+      ::grpc::WriteOptions options,
+      void* tag) override {
+    writing_ = request;
+    write_ = tag;
+    Reactor_::StartWrite(&writing_, options);
+  }
+
+  void WritesDone(void* tag) override {
+    writes_done_ = tag;
+    Reactor_::StartWritesDone();
+  }
+
+  void Finish(::grpc::Status* status, void* tag) override {
+    status_ = status;
+    finish_ = tag;
+    Reactor_::RemoveHold();
+  }
+
+  void OnReadInitialMetadataDone(bool ok) override {
+    if (abandoned_.load()) {
+      return;
+    }
+
+    std::unique_lock lock(mutex_);
+    metadata_ = ok;
+    if (metadata_tag_ != nullptr) {
+      void* tag = std::exchange(metadata_tag_, nullptr);
+      lock.unlock();
+      Invoke(tag, ok);
+    }
+  }
+
+  void OnReadDone(bool ok) override {
+    {
+      // NOTE: checking for abandonment while holding 'mutex_' so that
+      // 'response_' can't be destructed out from under us.
+      std::scoped_lock lock(mutex_);
+      if (abandoned_.load()) {
+        return;
+      }
+      if (ok) {
+        // NOTE: swapping (rather than moving) so that 'reading_'
+        // keeps the capacity of the previous response, e.g., when
+        // the response is being recycled.
+        CHECK_NOTNULL(response_)->Swap(&reading_);
+      }
+    }
+    Invoke(std::exchange(read_, nullptr), ok);
+  }
+
+  void OnWriteDone(bool ok) override {
+    if (!abandoned_.load()) {
+      Invoke(std::exchange(write_, nullptr), ok);
+    }
+  }
+
+  void OnWritesDoneDone(bool ok) override {
+    if (!abandoned_.load()) {
+      Invoke(std::exchange(writes_done_, nullptr), ok);
+    }
+  }
+
+  void OnDone(const ::grpc::Status& status) override {
+    // NOTE: nobody else owns this stream once it's been abandoned,
+    // and gRPC is done with the context (which we may own).
+    if (abandoned_.load()) {
+      delete this;
+      return;
+    }
+
+    *CHECK_NOTNULL(status_) = status;
+
+    // NOTE: invoking the finish callback might destruct this reactor
+    // (e.g., by destructing the 'ClientCall') so it must be the last
+    // thing we do.
+    Invoke(std::exchange(finish_, nullptr), true);
+  }
+
+ private:
+  static void Invoke(void* tag, bool ok) {
+    (*static_cast<Tag*>(CHECK_NOTNULL(tag)))(ok);
+  }
+
+  std::mutex mutex_;
+  std::optional<bool> metadata_;
+  void* metadata_tag_ = nullptr;
+
+  void* read_ = nullptr;
+  void* write_ = nullptr;
+  void* writes_done_ = nullptr;
+  void* finish_ = nullptr;
+
+  // What the outstanding read (if any) gets moved into.
+  Response_* response_ = nullptr;
+
+  // What gRPC reads into and writes from, see NOTE above.
+  Response_ reading_;
+  Request_ writing_;
+
+  ::grpc::Status* status_ = nullptr;
+
+  // Set if the call owned its context once it's been abandoned.
+  std::unique_ptr<::grpc::ClientContext> context_;
+
+  std::atomic<bool> abandoned_ = false;
+};
+
+////////////////////////////////////////////////////////////////////////
+
+// The completion queue that a call was scheduled on, see
+// 'ClientScheduling'.
+class ScheduledCompletionQueue {
+ public:
+  // NOTE: a completion queue borrowed from a 'CompletionPool' needs
+  // to be kept around until after the call terminates as it
+  // represents a "lease" on the completion queue that once
+  // relinquished will allow another call to use it.
+  ScheduledCompletionQueue(stout::borrowed_ptr<::grpc::CompletionQueue> cq)
+    : cq_(cq.get()),
+      borrowed_(std::move(cq)) {}
+
+  // NOTE: 'cq' must outlive the call, e.g., it's being polled by the
+  // current thread.
+  ScheduledCompletionQueue(::grpc::CompletionQueue* cq)
+    : cq_(cq) {}
+
+  ::grpc::CompletionQueue* get() const {
+    return cq_;
+  }
+
+ private:
+  ::grpc::CompletionQueue* cq_;
+  std::optional<stout::borrowed_ptr<::grpc::CompletionQueue>> borrowed_;
+};
+
+////////////////////////////////////////////////////////////////////////
+
 template <typename Request_, typename Response_>
 class ClientCall {
  public:
@@ -185,14 +460,16 @@ class ClientCall {
       const std::string& path,
       const std::optional<std::string>& host,
       ::grpc::ClientContext* context,
-      stout::borrowed_ptr<::grpc::CompletionQueue>&& cq,
+      std::optional<ScheduledCompletionQueue>&& cq,
       ::grpc::TemplatedGenericStub<RequestType_, ResponseType_>&& stub,
       std::unique_ptr<
-          ::grpc::ClientAsyncReaderWriter<
+          ::grpc::ClientAsyncReaderWriterInterface<
               RequestType_,
-              ResponseType_>>&& stream)
+              ResponseType_>>&& stream,
+      std::unique_ptr<::grpc::ClientContext>&& owned = nullptr)
     : path_(path),
       host_(host),
+      owned_(std::move(owned)),
       context_(context),
       cq_(std::move(cq)),
       stub_(std::move(stub)),
@@ -200,6 +477,21 @@ class ClientCall {
       reader_(path_, host_, context_, stream_.get()),
       writer_(path_, host_, context_, stream_.get()) {}
 
+  ClientCall(ClientCall&& that) = default;
+
+  ~ClientCall() {
+    // NOTE: with gRPC's callback API (i.e., no 'cq_') a call that
+    // never got finished still has a hold on its reactor which we
+    // need to release, and the reactor (and the context, which we
+    // hand over if we own it) must outlive the call, see
+    // 'CallbackClientStream::Abandon()'.
+    if (stream_ && !cq_ && !finishing_) {
+      static_cast<CallbackClientStream<RequestType_, ResponseType_>*>(
+          stream_.release())
+          ->Abandon(context_, std::move(owned_));
+    }
+  }
+
   auto* context() {
     return context_;
   }
@@ -219,21 +511,23 @@ class ClientCall {
     return Eventual<void>()
         .raises<std::runtime_error>()
         .start(
-            [this, callback = Callback<bool>()](auto& k) mutable {
-              callback = [&k](bool ok) mutable {
+            [this, tag = Tag()](auto& k) mutable {
+              using K = std::decay_t<decltype(k)>;
+              tag = Tag(&k, [](void* k, bool ok) {
                 if (ok) {
-                  k.Start();
+                  static_cast<K*>(k)->Start();
                 } else {
-                  k.Fail(std::runtime_error("Failed to do 'WritesDone()'"));
+                  static_cast<K*>(k)->Fail(
+                      std::runtime_error("Failed to do 'WritesDone()'"));
                 }
-              };
+              });
 
               EVENTUALS_GRPC_LOG(1)
                   << "Writing done for call (" << context_ << ")"
                   << " with host = " << host_.value_or("*")
                   << " with path = " << path_;
 
-              stream_->WritesDone(&callback);
+              stream_->WritesDone(&tag);
             });
   }
 
@@ -248,24 +542,27 @@ class ClientCall {
         .start(
             [this,
              data = Data{},
-             callback = Callback<bool>()](auto& k, auto&&...) mutable {
+             tag = Tag()](auto& k, auto&&...) mutable {
               using K = std::decay_t<decltype(k)>;
               data.k = &k;
-              callback = [&data](bool ok) {
-                auto& k = *reinterpret_cast<K*>(data.k);
+              tag = Tag(&data, [](void* d, bool ok) {
+                auto& data = *static_cast<Data*>(d);
+                auto& k = *static_cast<K*>(data.k);
                 if (ok) {
                   k.Start(std::move(data.status));
                 } else {
                   k.Fail(std::runtime_error("Failed to finish"));
                 }
-              };
+              });
 
               EVENTUALS_GRPC_LOG(1)
                   << "Finishing call (" << context_ << ")"
                   << " with host = " << host_.value_or("*")
                   << " with path = " << path_;
 
-              stream_->Finish(&data.status, &callback);
+              finishing_ = true;
+
+              stream_->Finish(&data.status, &tag);
             });
   }
 
@@ -275,35 +572,90 @@ class ClientCall {
   const std::string& path_;
   const std::optional<std::string>& host_;
 
+  // Set if the call was started without a context (see
+  // 'Client::Call()'), in which case it's 'context_'.
+  //
+  // NOTE: declared before (and thus destructed after) 'stream_'.
+  std::unique_ptr<::grpc::ClientContext> owned_;
+
   ::grpc::ClientContext* context_;
 
-  // NOTE: we need to keep this around until after the call terminates
-  // as it represents a "lease" on this completion queue that once
-  // relinquished will allow another call to use this queue.
-  stout::borrowed_ptr<::grpc::CompletionQueue> cq_;
+  // NOTE: we need to keep this around until after the call terminates,
+  // see 'ScheduledCompletionQueue'. Not set when using gRPC's
+  // callback API, see 'CallbackClientStream'.
+  std::optional<ScheduledCompletionQueue> cq_;
 
   ::grpc::TemplatedGenericStub<RequestType_, ResponseType_> stub_;
 
+  // Either a '::grpc::ClientAsyncReaderWriter' or a
+  // 'CallbackClientStream'.
   std::unique_ptr<
-      ::grpc::ClientAsyncReaderWriter<
+      ::grpc::ClientAsyncReaderWriterInterface<
           RequestType_,
           ResponseType_>>
       stream_;
 
   ClientReader<ResponseType_> reader_;
   ClientWriter<RequestType_> writer_;
+
+  // Whether or not 'Finish()' has been started, see '~ClientCall()'.
+  bool finishing_ = false;
+};
+
+////////////////////////////////////////////////////////////////////////
+
+// Result of 'Client::Unary()' where 'response' is only valid if
+// 'status.ok()'.
+template <typename Response_>
+struct StatusOrResponse {
+  ::grpc::Status status;
+  Response_ response;
+};
+
+////////////////////////////////////////////////////////////////////////
+
+// Which completion queue a 'Client' schedules each call on.
+enum class ClientScheduling {
+  // A completion queue from the client's 'CompletionPool', or gRPC's
+  // callback API if the client doesn't have a pool.
+  Default,
+
+  // The completion queue being polled by the current thread, if any,
+  // otherwise the same as 'Default'. Issuing a call from a server
+  // handler then uses the completion queue of the call being handled
+  // (the 'Server' is just another 'Poller') so a request can flow
+  // from the server to the client and back without changing threads.
+  //
+  // NOTE: the server must not be shutdown until all calls scheduled
+  // on its completion queues have terminated.
+  CurrentCompletionQueue,
 };
 
 ////////////////////////////////////////////////////////////////////////
 
 class Client {
  public:
+  // Each call uses a completion queue from 'pool' (unless
+  // 'scheduling' says otherwise).
+  Client(
+      const std::string& target,
+      const std::shared_ptr<::grpc::ChannelCredentials>& credentials,
+      stout::borrowed_ptr<CompletionPool> pool,
+      ClientScheduling scheduling = ClientScheduling::Default)
+    : channel_(::grpc::CreateChannel(target, credentials)),
+      pool_(std::move(pool)),
+      scheduling_(scheduling) {}
+
+  // Each call uses gRPC's callback API (unless 'scheduling' says
+  // otherwise) so every reader, writer, and finish completes directly
+  // on one of gRPC's internal threads rather than a thread polling a
+  // completion queue, i.e., no 'CompletionPool' is necessary.
   Client(
       const std::string& target,
       const std::shared_ptr<::grpc::ChannelCredentials>& credentials,
-      stout::borrowed_ptr<CompletionPool> pool)
+      ClientScheduling scheduling = ClientScheduling::Default)
     : channel_(::grpc::CreateChannel(target, credentials)),
-      pool_(std::move(pool)) {}
+      scheduling_(scheduling) {}
 
   auto Context() {
     return Eventual<::grpc::ClientContext*>()
@@ -328,6 +680,8 @@ class Client {
         std::move(host));
   }
 
+  // NOTE: if 'context' is 'nullptr' the call creates (and owns) its
+  // own context, otherwise 'context' must outlive the call.
   template <typename Request, typename Response>
   auto Call(
       std::string name,
@@ -350,29 +704,46 @@ class Client {
       std::string name;
       std::string path;
       std::optional<std::string> host;
-      stout::borrowed_ptr<::grpc::CompletionQueue> cq;
+      std::optional<ScheduledCompletionQueue> cq;
       ::grpc::TemplatedGenericStub<RequestType, ResponseType> stub;
       std::unique_ptr<
-          ::grpc::ClientAsyncReaderWriter<
+          ::grpc::ClientAsyncReaderWriterInterface<
               RequestType,
               ResponseType>>
           stream;
       void* k = nullptr;
+      // Set if started without a context, see 'ClientCall'.
+      std::unique_ptr<::grpc::ClientContext> owned;
     };
 
     return Eventual<ClientCall<Request, Response>>()
         .template raises<std::runtime_error>()
         .start(
-            [data = Data{
+            [this,
+             data = Data{
                  context,
                  std::move(name),
                  std::string(),
                  std::move(host),
-                 pool_->Schedule(),
+                 std::nullopt,
                  ::grpc::TemplatedGenericStub<
                      RequestType,
                      ResponseType>(channel_)},
-             callback = Callback<bool>()](auto& k) mutable {
+             tag = Tag()](auto& k) mutable {
+              // NOTE: scheduling once started (rather than when
+              // composed) so that 'ClientScheduling::
+              // CurrentCompletionQueue' uses the completion queue of
+              // the thread that starts the call.
+              data.cq = Schedule();
+
+              // NOTE: the call owns its context if it wasn't given one
+              // so that the context can outlive the call if need be,
+              // see 'CallbackClientStream::Abandon()'.
+              if (data.context == nullptr) {
+                data.owned = std::make_unique<::grpc::ClientContext>();
+                data.context = data.owned.get();
+              }
+
               const auto* method =
                   google::protobuf::DescriptorPool::generated_pool()
                       ->FindMethodByName(data.name);
@@ -398,10 +769,20 @@ class Client {
                       << " with host = " << data.host.value_or("*")
                       << " with path = " << data.path;
 
-                  data.stream = data.stub.PrepareCall(
-                      data.context,
-                      data.path,
-                      data.cq.get());
+                  if (data.cq) {
+                    data.stream = data.stub.PrepareCall(
+                        data.context,
+                        data.path,
+                        data.cq->get());
+                  } else {
+                    auto stream = std::make_unique<
+                        CallbackClientStream<RequestType, ResponseType>>();
+                    data.stub.experimental().PrepareBidiStreamingCall(
+                        data.context,
+                        data.path,
+                        stream.get());
+                    data.stream = std::move(stream);
+                  }
 
                   if (!data.stream) {
                     EVENTUALS_GRPC_LOG(1)
@@ -417,8 +798,9 @@ class Client {
                   } else {
                     using K = std::decay_t<decltype(k)>;
                     data.k = &k;
-                    callback = [&data](bool ok) {
-                      auto& k = *reinterpret_cast<K*>(data.k);
+                    tag = Tag(&data, [](void* d, bool ok) {
+                      auto& data = *static_cast<Data*>(d);
+                      auto& k = *static_cast<K*>(data.k);
                       if (ok) {
                         EVENTUALS_GRPC_LOG(1)
                             << "Started call (" << data.context << ")"
@@ -432,7 +814,8 @@ class Client {
                                 data.context,
                                 std::move(data.cq),
                                 std::move(data.stub),
-                                std::move(data.stream)));
+                                std::move(data.stream),
+                                std::move(data.owned)));
                       } else {
                         EVENTUALS_GRPC_LOG(1)
                             << "Failed to start call (" << data.context << ")"
@@ -441,52 +824,269 @@ class Client {
 
                         k.Fail(std::runtime_error("Failed to start call"));
                       }
-                    };
+                    });
 
                     EVENTUALS_GRPC_LOG(1)
                         << "Starting call (" << data.context << ")"
                         << " with host = " << data.host.value_or("*")
                         << " with path = " << data.path;
 
-                    data.stream->StartCall(&callback);
+                    // NOTE: with gRPC's callback API 'tag' gets invoked
+                    // (and thus 'k' started) before 'StartCall()'
+                    // returns, see 'CallbackClientStream::StartCall()'.
+                    data.stream->StartCall(&tag);
                   }
                 }
               }
             });
   }
 
+  // Performs a unary call with a single batch, i.e., starting the
+  // call, sending the request, receiving the response, and finishing
+  // all complete with one completion queue event rather than the
+  // events required when using 'Call()' which uses a bidirectional
+  // stream for all calls.
   template <typename Service, typename Request, typename Response>
-  auto Call(
+  auto Unary(
       const std::string& name,
+      Request request,
+      ::grpc::ClientContext* context,
       std::optional<std::string> host = std::nullopt) {
     static_assert(
         IsService<Service>::value,
         "expecting \"service\" type to be a protobuf 'Service'");
 
-    return Call<Request, Response>(
+    return Unary<Request, Response>(
         std::string(Service::service_full_name()) + "." + name,
+        std::move(request),
+        context,
         std::move(host));
   }
 
   template <typename Request, typename Response>
-  auto Call(
+  auto Unary(
       std::string name,
+      Request request,
+      ::grpc::ClientContext* context,
+      std::optional<std::string> host = std::nullopt) {
+    static_assert(
+        IsMessage<Request>::value,
+        "expecting \"request\" type to be a protobuf 'Message'");
+
+    static_assert(
+        IsMessage<Response>::value,
+        "expecting \"response\" type to be a protobuf 'Message'");
+
+    using Traits = RequestResponseTraits;
+
+    static_assert(
+        !Traits::Details<Request>::streaming
+            && !Traits::Details<Response>::streaming,
+        "expecting unary (i.e., non-streaming) requests and responses");
+
+    struct Data {
+      ::grpc::ClientContext* context;
+      std::string name;
+      std::string path;
+      std::optional<std::string> host;
+      Request request;
+      std::optional<ScheduledCompletionQueue> cq;
+      ::grpc::TemplatedGenericStub<Request, Response> stub;
+      std::unique_ptr<::grpc::ClientAsyncResponseReader<Response>> reader;
+      StatusOrResponse<Response> result;
+      void* k = nullptr;
+    };
+
+    return Eventual<StatusOrResponse<Response>>()
+        .template raises<std::runtime_error>()
+        .start(
+            [this,
+             data = Data{
+                 context,
+                 std::move(name),
+                 std::string(),
+                 std::move(host),
+                 std::move(request),
+                 std::nullopt,
+                 ::grpc::TemplatedGenericStub<Request, Response>(channel_)},
+             tag = Tag()](auto& k) mutable {
+              // NOTE: see comment in 'Call()' for why we schedule now.
+              data.cq = Schedule();
+
+              const auto* method =
+                  google::protobuf::DescriptorPool::generated_pool()
+                      ->FindMethodByName(data.name);
+
+              if (method == nullptr) {
+                k.Fail(std::runtime_error(
+                    "Method " + data.name + " not found"));
+                return;
+              }
+
+              auto error = Traits::Validate<Request, Response>(method);
+              if (error) {
+                k.Fail(std::runtime_error(error->message));
+                return;
+              }
+
+              if (data.host) {
+                data.context->set_authority(data.host.value());
+              }
+
+              data.path = "/" + data.name;
+              size_t index = data.path.find_last_of(".");
+              data.path.replace(index, 1, "/");
+
+              EVENTUALS_GRPC_LOG(1)
+                  << "Preparing unary call (" << data.context << ")"
+                  << " with host = " << data.host.value_or("*")
+                  << " with path = " << data.path
+                  << " and request =\n"
+                  << data.request.DebugString();
+
+              using K = std::decay_t<decltype(k)>;
+              data.k = &k;
+              tag = Tag(&data, [](void* d, bool ok) {
+                auto& data = *static_cast<Data*>(d);
+                auto& k = *static_cast<K*>(data.k);
+                if (ok) {
+                  EVENTUALS_GRPC_LOG(1)
+                      << "Finished unary call (" << data.context << ")"
+                      << " with host = " << data.host.value_or("*")
+                      << " with path = " << data.path
+                      << " and status = " << data.result.status.error_code();
+
+                  k.Start(std::move(data.result));
+                } else {
+                  k.Fail(std::runtime_error("Failed to finish"));
+                }
+              });
+
+              if (!data.cq) {
+                // NOTE: the callback API invokes our lambda directly
+                // from one of gRPC's internal threads.
+                data.stub.experimental().UnaryCall(
+                    data.context,
+                    data.path,
+                    &data.request,
+                    &data.result.response,
+                    [&data, &tag](::grpc::Status status) {
+                      data.result.status = std::move(status);
+                      tag(true);
+                    });
+                return;
+              }
+
+              data.reader = data.stub.PrepareUnaryCall(
+                  data.context,
+                  data.path,
+                  data.request,
+                  data.cq->get());
+
+              if (!data.reader) {
+                EVENTUALS_GRPC_LOG(1)
+                    << "Failed to prepare unary call (" << data.context << ")"
+                    << " with host = " << data.host.value_or("*")
+                    << " with path = " << data.path;
+
+                k.Fail(std::runtime_error("Failed to prepare call"));
+                return;
+              }
+
+              // NOTE: 'StartCall()' doesn't take a tag, the initial
+              // metadata, request, and half-close are all batched
+              // together with receiving the response and status once
+              // we call 'Finish()'.
+              data.reader->StartCall();
+              data.reader->Finish(
+                  &data.result.response,
+                  &data.result.status,
+                  &tag);
+            });
+  }
+
+  template <typename Service, typename Request, typename Response>
+  auto Unary(
+      const std::string& name,
+      Request request,
+      std::optional<std::string> host = std::nullopt) {
+    static_assert(
+        IsService<Service>::value,
+        "expecting \"service\" type to be a protobuf 'Service'");
+
+    return Unary<Request, Response>(
+        std::string(Service::service_full_name()) + "." + name,
+        std::move(request),
+        std::move(host));
+  }
+
+  template <typename Request, typename Response>
+  auto Unary(
+      std::string name,
+      Request request,
       std::optional<std::string> host = std::nullopt) {
     return Context()
         | Then([this,
                 name = std::move(name),
+                request = std::move(request),
                 host = std::move(host)](
                    ::grpc::ClientContext* context) mutable {
-             return Call<Request, Response>(
+             return Unary<Request, Response>(
                  std::move(name),
+                 std::move(request),
                  context,
                  std::move(host));
            });
   }
 
+  template <typename Service, typename Request, typename Response>
+  auto Call(
+      const std::string& name,
+      std::optional<std::string> host = std::nullopt) {
+    static_assert(
+        IsService<Service>::value,
+        "expecting \"service\" type to be a protobuf 'Service'");
+
+    return Call<Request, Response>(
+        std::string(Service::service_full_name()) + "." + name,
+        std::move(host));
+  }
+
+  template <typename Request, typename Response>
+  auto Call(
+      std::string name,
+      std::optional<std::string> host = std::nullopt) {
+    // NOTE: without a context the call creates (and owns) its own
+    // rather than using 'Context()' so that the context can outlive
+    // the call if need be, see 'CallbackClientStream::Abandon()'.
+    return Call<Request, Response>(
+        std::move(name),
+        static_cast<::grpc::ClientContext*>(nullptr),
+        std::move(host));
+  }
+
  private:
+  // Returns a completion queue for the next call, see
+  // 'ClientScheduling', or 'std::nullopt' when using gRPC's callback
+  // API.
+  std::optional<ScheduledCompletionQueue> Schedule() {
+    if (scheduling_ == ClientScheduling::CurrentCompletionQueue) {
+      Poller* poller = Poller::Current();
+      if (poller != nullptr) {
+        return ScheduledCompletionQueue(poller->cq());
+      }
+    }
+
+    if (pool_) {
+      return ScheduledCompletionQueue(pool_.value()->Schedule());
+    } else {
+      return std::nullopt;
+    }
+  }
+
   std::shared_ptr<::grpc::Channel> channel_;
-  stout::borrowed_ptr<CompletionPool> pool_;
+  std::optional<stout::borrowed_ptr<CompletionPool>> pool_;
+  ClientScheduling scheduling_ = ClientScheduling::Default;
 };
 
 ////////////////////////////////////////////////////////////////////////
@@ -1,9 +1,13 @@
 #pragma once
 
 #include <cassert>
+#include <chrono>
+#include <optional>
 #include <thread>
 
 #include "eventuals/callback.h"
+#include "eventuals/grpc/arena.h"
+#include "eventuals/grpc/poller.h"
 #include "grpcpp/completion_queue.h"
 #include "stout/borrowable.h"
 
@@ -16,19 +20,22 @@ namespace grpc {
 
 class CompletionPool {
  public:
-  CompletionPool() {
+  // Passing a 'tick' polls each completion queue with 'AsyncNext()'
+  // so that maintenance can be registered via 'pollers()', see
+  // 'Poller' for more details.
+  CompletionPool(
+      std::optional<std::chrono::nanoseconds> tick = std::nullopt) {
     unsigned int threads = std::thread::hardware_concurrency();
     threads_.reserve(threads);
     cqs_.reserve(threads);
+    pollers_.reserve(threads);
     for (size_t i = 0; i < threads; i++) {
       cqs_.emplace_back(new stout::Borrowable<::grpc::CompletionQueue>());
+      pollers_.emplace_back(new Poller(cqs_.back()->get(), tick));
       threads_.emplace_back(
-          [cq = cqs_.back()->get()]() {
-            void* tag = nullptr;
-            bool ok = false;
-            while (cq->Next(&tag, &ok)) {
-              (*static_cast<Callback<bool>*>(tag))(ok);
-            }
+          [poller = pollers_.back().get()]() {
+            BindThreadToArena();
+            poller->Run();
           });
     }
   }
@@ -65,6 +72,12 @@ class CompletionPool {
     }
   }
 
+  // NOTE: one 'Poller' per completion queue, none of which should be
+  // used after 'Wait()'.
+  const std::vector<std::unique_ptr<Poller>>& pollers() {
+    return pollers_;
+  }
+
   stout::borrowed_ptr<::grpc::CompletionQueue> Schedule() {
     // TODO(benh): provide alternative "scheduling" algorithms in
     // addition to "least loaded", e.g., round-robin, random.
@@ -84,6 +97,8 @@ class CompletionPool {
  private:
   std::vector<std::unique_ptr<stout::Borrowable<::grpc::CompletionQueue>>> cqs_;
 
+  std::vector<std::unique_ptr<Poller>> pollers_;
+
   std::vector<std::thread> threads_;
 
   bool shutdown_ = false;
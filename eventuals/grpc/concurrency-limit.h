@@ -0,0 +1,162 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <string>
+
+#include "eventuals/callback.h"
+#include "glog/logging.h"
+
+////////////////////////////////////////////////////////////////////////
+
+namespace eventuals {
+namespace grpc {
+
+////////////////////////////////////////////////////////////////////////
+
+// Limits how many calls to an endpoint are handled concurrently.
+//
+// The limit is either fixed or adapted using AIMD (additive increase,
+// multiplicative decrease): each call that completes within the
+// target latency increases the limit by '1 / limit' while each call
+// that is slower (or gets cancelled, e.g., because its deadline was
+// exceeded) multiplies the limit by 'backoff'.
+class ConcurrencyLimit {
+ public:
+  struct Options {
+    // Maximum number of calls handled concurrently, or the initial
+    // limit when 'adaptive'.
+    size_t limit = 0;
+
+    // Whether calls beyond the limit should be rejected immediately
+    // with 'RESOURCE_EXHAUSTED' rather than wait in the endpoint.
+    bool reject = false;
+
+    bool adaptive = false;
+
+    // Bounds for an adaptive limit.
+    size_t minimum = 1;
+    size_t maximum = 1024;
+
+    // Calls that take longer than this (or get cancelled) are
+    // considered a sign of overload by an adaptive limit.
+    std::chrono::nanoseconds latency = std::chrono::milliseconds(100);
+
+    double backoff = 0.9;
+  };
+
+  // Returns an error message if 'options' are invalid.
+  static std::optional<std::string> Validate(const Options& options) {
+    if (options.limit == 0) {
+      return "concurrency limit must be positive";
+    } else if (options.adaptive) {
+      if (options.minimum == 0 || options.minimum > options.maximum) {
+        return "adaptive concurrency limit requires 0 < minimum <= maximum";
+      } else if (options.backoff <= 0 || options.backoff >= 1) {
+        return "adaptive concurrency limit requires 0 < backoff < 1";
+      }
+    }
+    return std::nullopt;
+  }
+
+  ConcurrencyLimit(const Options& options)
+    : options_(options),
+      limit_(options.limit) {
+    auto error = Validate(options_);
+    CHECK(!error) << error.value();
+    if (options_.adaptive) {
+      limit_ = std::clamp<double>(
+          limit_,
+          options_.minimum,
+          options_.maximum);
+    }
+  }
+
+  ConcurrencyLimit(const ConcurrencyLimit&) = delete;
+
+  const Options& options() const {
+    return options_;
+  }
+
+  size_t limit() {
+    std::scoped_lock lock(mutex_);
+    return static_cast<size_t>(limit_);
+  }
+
+  size_t inflight() {
+    std::scoped_lock lock(mutex_);
+    return inflight_;
+  }
+
+  // Returns true if the call can be handled now.
+  bool TryAcquire() {
+    std::scoped_lock lock(mutex_);
+    if (inflight_ < static_cast<size_t>(limit_)) {
+      inflight_++;
+      return true;
+    }
+    return false;
+  }
+
+  // Invokes 'callback' once the call can be handled, which might be
+  // immediately (on the current thread) or after some other call
+  // releases (on the thread that releases).
+  void Acquire(Callback<>&& callback) {
+    std::unique_lock lock(mutex_);
+    if (waiters_.empty() && inflight_ < static_cast<size_t>(limit_)) {
+      inflight_++;
+      lock.unlock();
+      callback();
+    } else {
+      waiters_.push_back(std::move(callback));
+    }
+  }
+
+  // Releases a call that took 'latency' to complete and was possibly
+  // 'cancelled', waking up any waiting calls for which there is now
+  // room.
+  void Release(std::chrono::nanoseconds latency, bool cancelled) {
+    std::unique_lock lock(mutex_);
+
+    CHECK_GT(inflight_, 0u);
+
+    inflight_--;
+
+    if (options_.adaptive) {
+      if (cancelled || latency > options_.latency) {
+        limit_ = std::max<double>(limit_ * options_.backoff, options_.minimum);
+      } else {
+        limit_ = std::min<double>(limit_ + 1 / limit_, options_.maximum);
+      }
+    }
+
+    while (!waiters_.empty() && inflight_ < static_cast<size_t>(limit_)) {
+      inflight_++;
+      Callback<> callback = std::move(waiters_.front());
+      waiters_.pop_front();
+      lock.unlock();
+      callback();
+      lock.lock();
+    }
+  }
+
+ private:
+  const Options options_;
+
+  std::mutex mutex_;
+
+  double limit_ = 0;
+  size_t inflight_ = 0;
+
+  std::deque<Callback<>> waiters_;
+};
+
+////////////////////////////////////////////////////////////////////////
+
+} // namespace grpc
+} // namespace eventuals
+
+////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,274 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "eventuals/callback.h"
+#include "eventuals/eventual.h"
+#include "eventuals/then.h"
+#include "glog/logging.h"
+
+////////////////////////////////////////////////////////////////////////
+
+namespace eventuals {
+namespace grpc {
+
+////////////////////////////////////////////////////////////////////////
+
+// Pool of threads for running CPU heavy work off of the threads that
+// poll completion queues (so that one heavy handler doesn't stall
+// every other call on the same completion queue), see 'OnExecutor()'.
+//
+// Each thread has its own deque of work: work submitted from one of
+// the executor's own threads gets pushed onto that thread's deque
+// (and is run LIFO for locality) while work submitted from any other
+// thread is distributed round-robin. A thread that runs out of work
+// steals from the front of the other threads' deques before going to
+// sleep.
+//
+// Submitting work only takes the lock of the deque it gets pushed on
+// (and the lock of a sleeping thread to wake it, if any thread is
+// sleeping), i.e., there isn't any lock shared by every thread.
+class Executor {
+ public:
+  // Defaults to one thread per core.
+  Executor(std::optional<size_t> threads = std::nullopt) {
+    size_t size = threads.value_or(std::thread::hardware_concurrency());
+
+    CHECK(size > 0) << "executor requires at least one thread";
+
+    workers_.reserve(size);
+    for (size_t i = 0; i < size; i++) {
+      workers_.emplace_back(new Worker());
+    }
+
+    threads_.reserve(size);
+    for (size_t i = 0; i < size; i++) {
+      threads_.emplace_back([this, i]() {
+        Run(i);
+      });
+    }
+  }
+
+  Executor(const Executor&) = delete;
+
+  // NOTE: runs any work that has already been submitted before
+  // returning.
+  ~Executor() {
+    stopping_.store(true);
+
+    for (auto& worker : workers_) {
+      std::scoped_lock lock(worker->mutex);
+      worker->available.notify_one();
+    }
+
+    for (auto& thread : threads_) {
+      thread.join();
+    }
+  }
+
+  // Returns the 'Executor' that is running on the current thread, or
+  // 'nullptr' if the current thread doesn't belong to an executor.
+  static Executor* Current() {
+    return current_;
+  }
+
+  size_t size() const {
+    return workers_.size();
+  }
+
+  void Submit(Callback<>&& callback) {
+    Worker* worker = current_ == this
+        ? workers_[index_].get()
+        : workers_[next_.fetch_add(1, std::memory_order_relaxed)
+                   % workers_.size()]
+              .get();
+
+    {
+      std::scoped_lock lock(worker->mutex);
+      worker->deque.push_back(std::move(callback));
+    }
+
+    // NOTE: incrementing 'pending_' before checking 'sleeping_' (while
+    // a thread going to sleep increments 'sleeping_' before checking
+    // 'pending_', see 'Run()') means that either we see that a thread
+    // is sleeping and wake it or it sees the work and doesn't sleep.
+    pending_.fetch_add(1);
+
+    if (sleeping_.load() > 0) {
+      Wake(*worker);
+    }
+  }
+
+ private:
+  struct Worker {
+    // Protects 'deque' and 'sleeping'.
+    std::mutex mutex;
+    std::deque<Callback<>> deque;
+
+    // Whether or not this worker's thread is (about to be) waiting on
+    // 'available'.
+    bool sleeping = false;
+    std::condition_variable available;
+  };
+
+  // Wakes a sleeping thread, preferring the one for 'worker' as it's
+  // the one that has the most recently submitted work.
+  void Wake(Worker& worker) {
+    if (Wake1(worker)) {
+      return;
+    }
+
+    for (auto& other : workers_) {
+      if (other.get() != &worker && Wake1(*other)) {
+        return;
+      }
+    }
+  }
+
+  bool Wake1(Worker& worker) {
+    std::scoped_lock lock(worker.mutex);
+    if (worker.sleeping) {
+      worker.sleeping = false;
+      worker.available.notify_one();
+      return true;
+    }
+    return false;
+  }
+
+  std::optional<Callback<>> Pop(size_t index) {
+    Worker& worker = *workers_[index];
+    std::scoped_lock lock(worker.mutex);
+    if (!worker.deque.empty()) {
+      Callback<> callback = std::move(worker.deque.back());
+      worker.deque.pop_back();
+      return std::optional<Callback<>>(std::move(callback));
+    }
+    return std::nullopt;
+  }
+
+  std::optional<Callback<>> Steal(size_t index) {
+    for (size_t i = 1; i < workers_.size(); i++) {
+      Worker& victim = *workers_[(index + i) % workers_.size()];
+      std::scoped_lock lock(victim.mutex);
+      if (!victim.deque.empty()) {
+        Callback<> callback = std::move(victim.deque.front());
+        victim.deque.pop_front();
+        return std::optional<Callback<>>(std::move(callback));
+      }
+    }
+    return std::nullopt;
+  }
+
+  void Run(size_t index) {
+    current_ = this;
+    index_ = index;
+
+    Worker& worker = *workers_[index];
+
+    while (true) {
+      std::optional<Callback<>> callback = Pop(index);
+
+      if (!callback) {
+        callback = Steal(index);
+      }
+
+      if (callback) {
+        pending_.fetch_sub(1, std::memory_order_relaxed);
+        (*callback)();
+        continue;
+      }
+
+      // NOTE: 'pending_' might be positive even though we didn't find
+      // any work because it only gets incremented after the work has
+      // been pushed, in which case we just try again.
+      if (pending_.load() > 0) {
+        continue;
+      }
+
+      if (stopping_.load()) {
+        break;
+      }
+
+      std::unique_lock lock(worker.mutex);
+
+      worker.sleeping = true;
+
+      // NOTE: see comment in 'Submit()' for why we increment
+      // 'sleeping_' before checking 'pending_' (again).
+      sleeping_.fetch_add(1);
+
+      if (pending_.load() == 0 && !stopping_.load()) {
+        worker.available.wait(lock, [&]() {
+          return !worker.sleeping || stopping_.load();
+        });
+      }
+
+      worker.sleeping = false;
+
+      sleeping_.fetch_sub(1);
+    }
+
+    current_ = nullptr;
+  }
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+
+  std::vector<std::thread> threads_;
+
+  std::atomic<size_t> next_ = 0;
+
+  // Number of submitted callbacks that haven't been popped yet.
+  std::atomic<size_t> pending_ = 0;
+
+  // Number of threads that are (about to be) sleeping.
+  std::atomic<size_t> sleeping_ = 0;
+
+  std::atomic<bool> stopping_ = false;
+
+  static inline thread_local Executor* current_ = nullptr;
+  static inline thread_local size_t index_ = 0;
+};
+
+////////////////////////////////////////////////////////////////////////
+
+// Returns an eventual that continues on one of the threads of
+// 'executor', or on the current thread if 'executor' is 'nullptr'.
+inline auto OnExecutor(Executor* executor) {
+  return Eventual<void>(
+      [executor](auto& k, auto&&...) {
+        if (executor == nullptr) {
+          k.Start();
+        } else {
+          executor->Submit([&k]() {
+            k.Start();
+          });
+        }
+      });
+}
+
+////////////////////////////////////////////////////////////////////////
+
+// Returns an eventual that invokes 'f' (and runs any eventual that it
+// returns) on one of the threads of 'executor', or on the current
+// thread if 'executor' is 'nullptr'.
+//
+// NOTE: whatever gets composed after continues on the executor too.
+template <typename F>
+auto OnExecutor(Executor* executor, F f) {
+  return OnExecutor(executor)
+      | Then(std::move(f));
+}
+
+////////////////////////////////////////////////////////////////////////
+
+} // namespace grpc
+} // namespace eventuals
+
+////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+////////////////////////////////////////////////////////////////////////
+
+namespace eventuals {
+namespace grpc {
+
+////////////////////////////////////////////////////////////////////////
+
+// Histogram of durations that can be recorded into concurrently
+// without any locks.
+//
+// Buckets are log-linear (a la HdrHistogram): every power of two is
+// split into 'kSubBuckets' equally sized buckets so that a percentile
+// is off by at most 1 / 'kSubBuckets' (i.e., 12.5%) while covering
+// everything from a nanosecond to centuries in a few kilobytes.
+class Histogram {
+ public:
+  static constexpr size_t kSubBucketBits = 3;
+  static constexpr size_t kSubBuckets = 1 << kSubBucketBits;
+
+  Histogram() = default;
+
+  Histogram(const Histogram&) = delete;
+
+  void Record(std::chrono::nanoseconds duration) {
+    uint64_t value = std::max<int64_t>(0, duration.count());
+
+    buckets_[Index(value)].fetch_add(1, std::memory_order_relaxed);
+
+    count_.fetch_add(1, std::memory_order_relaxed);
+
+    uint64_t max = max_.load(std::memory_order_relaxed);
+    while (value > max
+           && !max_.compare_exchange_weak(
+               max,
+               value,
+               std::memory_order_relaxed)) {}
+  }
+
+  uint64_t count() const {
+    return count_.load(std::memory_order_relaxed);
+  }
+
+  std::chrono::nanoseconds max() const {
+    return std::chrono::nanoseconds(max_.load(std::memory_order_relaxed));
+  }
+
+  // Returns the 'p'th percentile (where 0 < 'p' <= 100), rounded up to
+  // the end of its bucket, or 0 if nothing has been recorded.
+  //
+  // NOTE: durations being recorded concurrently may or may not be
+  // included.
+  std::chrono::nanoseconds Percentile(double p) const {
+    uint64_t count = 0;
+    for (const auto& bucket : buckets_) {
+      count += bucket.load(std::memory_order_relaxed);
+    }
+
+    if (count == 0) {
+      return std::chrono::nanoseconds(0);
+    }
+
+    uint64_t rank = std::max<uint64_t>(
+        1,
+        static_cast<uint64_t>(p / 100 * count + 0.5));
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < buckets_.size(); i++) {
+      seen += buckets_[i].load(std::memory_order_relaxed);
+      if (seen >= rank) {
+        return std::chrono::nanoseconds(
+            std::min(Last(i), max_.load(std::memory_order_relaxed)));
+      }
+    }
+
+    return max();
+  }
+
+ private:
+  // Number of buckets needed for every 'uint64_t'.
+  static constexpr size_t kBuckets = (64 - kSubBucketBits + 1) * kSubBuckets;
+
+  // Index of the most significant bit set in 'value' (which must not
+  // be 0).
+  static size_t Log2(uint64_t value) {
+#if defined(_MSC_VER)
+    unsigned long index = 0;
+    _BitScanReverse64(&index, value);
+    return index;
+#else
+    return 63 - __builtin_clzll(value);
+#endif
+  }
+
+  static size_t Index(uint64_t value) {
+    if (value < kSubBuckets) {
+      return value;
+    }
+
+    size_t exponent = Log2(value);
+    size_t shift = exponent - kSubBucketBits;
+    size_t sub = (value >> shift) & (kSubBuckets - 1);
+
+    return (shift + 1) * kSubBuckets + sub;
+  }
+
+  // Returns the last value that falls into bucket 'index'.
+  static uint64_t Last(size_t index) {
+    if (index < kSubBuckets) {
+      return index;
+    }
+
+    size_t shift = index / kSubBuckets - 1;
+    uint64_t first = (kSubBuckets + index % kSubBuckets) << shift;
+
+    return first + ((uint64_t(1) << shift) - 1);
+  }
+
+  std::array<std::atomic<uint64_t>, kBuckets> buckets_ = {};
+  std::atomic<uint64_t> count_ = 0;
+  std::atomic<uint64_t> max_ = 0;
+};
+
+////////////////////////////////////////////////////////////////////////
+
+} // namespace grpc
+} // namespace eventuals
+
+////////////////////////////////////////////////////////////////////////
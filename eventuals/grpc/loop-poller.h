@@ -0,0 +1,203 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#include "eventuals/grpc/poller.h"
+#include "glog/logging.h"
+#include "grpcpp/completion_queue.h"
+#include "uv.h"
+
+////////////////////////////////////////////////////////////////////////
+
+namespace eventuals {
+namespace grpc {
+
+////////////////////////////////////////////////////////////////////////
+
+// 'LoopPoller' polls a completion queue from an existing libuv loop
+// instead of from threads of its own (like 'CompletionPool' does) so
+// that a service that already runs a loop (e.g., for timers or file
+// I/O) can handle both on one thread without any handoffs.
+//
+// The completion queue gets drained (via 'Poller::Drain()') right
+// before each time the loop would block waiting for I/O. Since a
+// completion queue has no file descriptor that libuv could wait on, a
+// timer wakes the loop every 'tick' so that an event waits at most
+// that long while the loop is otherwise idle. To keep I/O from being
+// starved no more than 'kMaximumEventsPerIteration' events are handled
+// per iteration, in which case the loop doesn't block until the
+// completion queue has been drained.
+//
+// After 'Start()' (which must be called on the thread running the
+// loop) the loop's thread polls this completion queue as far as
+// 'Poller::Current()' is concerned, so with
+// 'ClientScheduling::CurrentCompletionQueue' a 'Client' will schedule
+// calls started on the loop's thread on this completion queue:
+//
+//   LoopPoller poller(loop);
+//   poller.Start();
+//
+//   Client client(
+//       target,
+//       credentials,
+//       ClientScheduling::CurrentCompletionQueue);
+//
+//   // Start calls from the loop's thread, e.g., from a libuv callback.
+//
+//   uv_run(loop, UV_RUN_DEFAULT);
+//
+// After 'Shutdown()' the completion queue gets drained and then the
+// libuv handles get closed so that 'uv_run()' can return.
+//
+// NOTE: all members other than 'Shutdown()' must only be called on
+// the loop's thread.
+//
+// NOTE: built as '//:loop-poller' (rather than as part of '//:grpc')
+// so that only those that use it depend on libuv.
+class LoopPoller {
+ public:
+  static constexpr size_t kMaximumEventsPerIteration = 64;
+
+  LoopPoller(
+      uv_loop_t* loop,
+      std::chrono::nanoseconds tick = std::chrono::milliseconds(1))
+    : loop_(CHECK_NOTNULL(loop)),
+      poller_(&cq_, tick) {}
+
+  LoopPoller(const LoopPoller&) = delete;
+
+  ~LoopPoller() {
+    CHECK(!started_ || closed_)
+        << "LoopPoller destructed before its completion queue was "
+        << "shutdown and drained";
+
+    if (!started_) {
+      cq_.Shutdown();
+      void* tag = nullptr;
+      bool ok = false;
+      while (cq_.Next(&tag, &ok)) {}
+    }
+  }
+
+  ::grpc::CompletionQueue* cq() {
+    return &cq_;
+  }
+
+  Poller& poller() {
+    return poller_;
+  }
+
+  void Start() {
+    CHECK(!started_) << "already started";
+
+    started_ = true;
+
+    thread_ = std::this_thread::get_id();
+
+    Poller::SetCurrent(&poller_);
+
+    uv_prepare_init(loop_, &prepare_);
+    uv_timer_init(loop_, &timer_);
+    uv_idle_init(loop_, &idle_);
+
+    for (auto* handle : Handles()) {
+      handle->data = this;
+    }
+
+    uv_prepare_start(&prepare_, [](uv_prepare_t* prepare) {
+      static_cast<LoopPoller*>(prepare->data)->Drain();
+    });
+
+    // NOTE: the timer and idle callbacks don't need to do anything as
+    // waking up the loop is enough for the prepare callback to run.
+    uint64_t milliseconds = std::max<uint64_t>(
+        1,
+        std::chrono::ceil<std::chrono::milliseconds>(
+            poller_.tick().value())
+            .count());
+
+    uv_timer_start(
+        &timer_,
+        [](uv_timer_t*) {},
+        milliseconds,
+        milliseconds);
+  }
+
+  // Shuts down the completion queue, can be called from any thread.
+  void Shutdown() {
+    cq_.Shutdown();
+  }
+
+ private:
+  std::array<uv_handle_t*, 3> Handles() {
+    return {
+        reinterpret_cast<uv_handle_t*>(&prepare_),
+        reinterpret_cast<uv_handle_t*>(&timer_),
+        reinterpret_cast<uv_handle_t*>(&idle_)};
+  }
+
+  void Drain() {
+    DCHECK_EQ(thread_, std::this_thread::get_id());
+
+    if (closing_) {
+      return;
+    }
+
+    auto events = poller_.Drain(kMaximumEventsPerIteration);
+
+    if (!events) {
+      Close();
+    } else if (events.value() == kMaximumEventsPerIteration) {
+      // An active idle handle makes the loop poll for I/O without
+      // blocking so that we come back to draining right away.
+      uv_idle_start(&idle_, [](uv_idle_t*) {});
+    } else {
+      uv_idle_stop(&idle_);
+    }
+  }
+
+  void Close() {
+    closing_ = true;
+
+    if (Poller::Current() == &poller_) {
+      Poller::SetCurrent(nullptr);
+    }
+
+    for (auto* handle : Handles()) {
+      uv_close(handle, [](uv_handle_t* handle) {
+        auto* poller = static_cast<LoopPoller*>(handle->data);
+        if (++poller->closes_ == poller->Handles().size()) {
+          poller->closed_ = true;
+        }
+      });
+    }
+  }
+
+  uv_loop_t* loop_;
+
+  ::grpc::CompletionQueue cq_;
+
+  Poller poller_;
+
+  uv_prepare_t prepare_;
+  uv_timer_t timer_;
+  uv_idle_t idle_;
+
+  std::thread::id thread_;
+
+  bool started_ = false;
+  bool closing_ = false;
+  bool closed_ = false;
+  size_t closes_ = 0;
+};
+
+////////////////////////////////////////////////////////////////////////
+
+} // namespace grpc
+} // namespace eventuals
+
+////////////////////////////////////////////////////////////////////////
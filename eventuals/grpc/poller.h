@@ -0,0 +1,260 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "eventuals/callback.h"
+#include "eventuals/grpc/tag.h"
+#include "eventuals/grpc/timer-wheel.h"
+#include "glog/logging.h"
+#include "grpc/support/time.h"
+#include "grpcpp/completion_queue.h"
+
+////////////////////////////////////////////////////////////////////////
+
+namespace eventuals {
+namespace grpc {
+
+////////////////////////////////////////////////////////////////////////
+
+// 'Poller' drains a completion queue by repeatedly getting the next
+// event and invoking the 'Tag' that was used as its tag.
+//
+// By default a 'Poller' blocks "forever" in '::grpc::CompletionQueue::
+// Next()'. If a 'tick' is provided we instead use 'AsyncNext()' with
+// a deadline of at most 'tick' so that we can periodically run any
+// "maintenance" callbacks registered via 'Every()' on the same
+// thread(s) that are polling the completion queue, i.e., without
+// needing an extra thread or any cross-thread wakeups. Polling with a
+// tick also advances a 'TimerWheel' (with the tick as its resolution)
+// so that timers fire on the polling thread(s) too, see 'Timer()'.
+class Poller {
+ public:
+  // NOTE: same (monotonic) clock as 'TimerWheel' so that neither
+  // timers nor maintenance are affected by adjusting the wall clock.
+  using Clock = TimerWheel::Clock;
+
+  // NOTE: not using 'Clock::time_point' as its precision varies
+  // across platforms.
+  using TimePoint = std::chrono::time_point<Clock, std::chrono::nanoseconds>;
+
+  Poller(
+      ::grpc::CompletionQueue* cq,
+      std::optional<std::chrono::nanoseconds> tick = std::nullopt)
+    : cq_(CHECK_NOTNULL(cq)),
+      tick_(tick) {
+    CHECK(!tick_ || tick_->count() > 0) << "tick must be positive";
+
+    if (tick_) {
+      timers_.emplace(tick_.value());
+    }
+  }
+
+  Poller(const Poller&) = delete;
+
+  // Returns the 'Poller' that is running on the current thread, or
+  // 'nullptr' if the current thread is not polling a completion
+  // queue.
+  static Poller* Current() {
+    return current_;
+  }
+
+  // Sets the 'Poller' returned from 'Current()' for a thread that
+  // polls with 'Drain()' rather than 'Run()', e.g., the thread of an
+  // event loop, see 'LoopPoller'.
+  static void SetCurrent(Poller* poller) {
+    current_ = poller;
+  }
+
+  ::grpc::CompletionQueue* cq() {
+    return cq_;
+  }
+
+  const std::optional<std::chrono::nanoseconds>& tick() const {
+    return tick_;
+  }
+
+  TimerWheel& timers() {
+    CHECK(tick_) << "timers require polling with a tick";
+    return timers_.value();
+  }
+
+  // Registers 'callback' to be invoked approximately every 'interval'
+  // on a thread polling this completion queue. The precision is
+  // bounded by the 'tick' and by how long event callbacks take.
+  //
+  // NOTE: maintenance callbacks are never run concurrently with one
+  // another even if more than one thread is polling the completion
+  // queue, but they must not themselves call 'Every()'.
+  void Every(std::chrono::nanoseconds interval, Callback<>&& callback) {
+    CHECK(tick_) << "maintenance requires polling with a tick";
+
+    std::scoped_lock lock(mutex_);
+    maintenances_.push_back(Maintenance{
+        interval,
+        Clock::now() + interval,
+        std::move(callback)});
+  }
+
+  // Polls the completion queue until it has been shutdown and fully
+  // drained.
+  void Run() {
+    current_ = this;
+
+    if (!tick_) {
+      void* tag = nullptr;
+      bool ok = false;
+      while (cq_->Next(&tag, &ok)) {
+        (*static_cast<Tag*>(tag))(ok);
+      }
+    } else {
+      while (Poll(Clock::now() + tick_.value())) {}
+    }
+
+    current_ = nullptr;
+  }
+
+  // Polls the completion queue for at most one event, waiting no
+  // longer than 'deadline', and runs any maintenance that has come
+  // due. Returns false once the completion queue has been shutdown
+  // and fully drained.
+  //
+  // NOTE: requires that this 'Poller' was constructed with a tick.
+  bool Poll(TimePoint deadline) {
+    DCHECK(tick_);
+
+    void* tag = nullptr;
+    bool ok = false;
+
+    // NOTE: gRPC only takes wall clock deadlines as a
+    // 'std::chrono::time_point' so we pass a monotonic 'gpr_timespec'
+    // relative to now instead.
+    auto timeout = std::max(
+        std::chrono::nanoseconds(deadline - Clock::now()),
+        std::chrono::nanoseconds(0));
+
+    auto status = cq_->AsyncNext(
+        &tag,
+        &ok,
+        gpr_time_add(
+            gpr_now(GPR_CLOCK_MONOTONIC),
+            gpr_time_from_nanos(timeout.count(), GPR_TIMESPAN)));
+
+    switch (status) {
+      case ::grpc::CompletionQueue::SHUTDOWN:
+        return false;
+      case ::grpc::CompletionQueue::GOT_EVENT:
+        (*static_cast<Tag*>(tag))(ok);
+        break;
+      case ::grpc::CompletionQueue::TIMEOUT:
+        break;
+    }
+
+    TimePoint now = Clock::now();
+
+    timers_->Advance(now);
+
+    Maintain(now);
+
+    return true;
+  }
+
+  // Handles the events that are already available, but no more than
+  // 'max', without waiting for any, and then advances timers and runs
+  // maintenance that has come due like 'Poll()'. Returns how many
+  // events were handled or 'std::nullopt' once the completion queue
+  // has been shutdown and fully drained.
+  //
+  // NOTE: requires that this 'Poller' was constructed with a tick.
+  std::optional<size_t> Drain(size_t max) {
+    DCHECK(tick_);
+
+    size_t events = 0;
+
+    while (events < max) {
+      void* tag = nullptr;
+      bool ok = false;
+
+      // NOTE: a deadline in the past makes 'AsyncNext()' return
+      // immediately if there isn't an event.
+      auto status = cq_->AsyncNext(
+          &tag,
+          &ok,
+          gpr_inf_past(GPR_CLOCK_MONOTONIC));
+
+      if (status == ::grpc::CompletionQueue::SHUTDOWN) {
+        return std::nullopt;
+      } else if (status == ::grpc::CompletionQueue::TIMEOUT) {
+        break;
+      }
+
+      (*static_cast<Tag*>(tag))(ok);
+
+      events++;
+    }
+
+    TimePoint now = Clock::now();
+
+    timers_->Advance(now);
+
+    Maintain(now);
+
+    return events;
+  }
+
+ private:
+  struct Maintenance {
+    std::chrono::nanoseconds interval;
+    TimePoint next;
+    Callback<> callback;
+  };
+
+  void Maintain(TimePoint now) {
+    if (now < next_.load(std::memory_order_relaxed)) {
+      return;
+    }
+
+    // Only one thread at a time performs maintenance, any other
+    // threads just go back to polling.
+    std::unique_lock lock(mutex_, std::try_to_lock);
+
+    if (!lock) {
+      return;
+    }
+
+    TimePoint next = now + tick_.value();
+
+    for (auto& maintenance : maintenances_) {
+      if (maintenance.next <= now) {
+        maintenance.callback();
+        maintenance.next = now + maintenance.interval;
+      }
+      next = std::min(next, maintenance.next);
+    }
+
+    next_.store(next, std::memory_order_relaxed);
+  }
+
+  ::grpc::CompletionQueue* cq_;
+
+  const std::optional<std::chrono::nanoseconds> tick_;
+
+  std::optional<TimerWheel> timers_;
+
+  std::mutex mutex_;
+  std::vector<Maintenance> maintenances_;
+  std::atomic<TimePoint> next_ = TimePoint::min();
+
+  static inline thread_local Poller* current_ = nullptr;
+};
+
+////////////////////////////////////////////////////////////////////////
+
+} // namespace grpc
+} // namespace eventuals
+
+////////////////////////////////////////////////////////////////////////
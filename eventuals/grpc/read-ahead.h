@@ -0,0 +1,266 @@
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+#include "eventuals/grpc/tag.h"
+#include "eventuals/stream.h"
+#include "glog/logging.h"
+
+////////////////////////////////////////////////////////////////////////
+
+namespace eventuals {
+namespace grpc {
+
+////////////////////////////////////////////////////////////////////////
+
+// Bounds how far a reader may read ahead of its consumer, see
+// 'ServerReader::Read(ReadAheadOptions)' and
+// 'ClientReader::Read(ReadAheadOptions)'.
+struct ReadAheadOptions {
+  // Maximum number of messages buffered.
+  size_t messages = 16;
+
+  // Maximum number of bytes buffered (a single message that is larger
+  // than this still gets read once the buffer is empty).
+  size_t bytes = 4 * 1024 * 1024;
+};
+
+////////////////////////////////////////////////////////////////////////
+
+struct _ReadAhead {
+  // Shared between the stream and any outstanding read so that a read
+  // which completes after the consumer is done (and the stream has
+  // been destructed) still has somewhere to go.
+  template <
+      typename Value_,
+      typename Buffer_,
+      typename Read_,
+      typename Size_,
+      typename Parse_>
+  struct State : public std::enable_shared_from_this<
+                     State<Value_, Buffer_, Read_, Size_, Parse_>> {
+    State(ReadAheadOptions options, Read_ read, Size_ size, Parse_ parse)
+      : options(options),
+        read(std::move(read)),
+        size(std::move(size)),
+        parse(std::move(parse)) {
+      CHECK(options.messages > 0) << "must read ahead at least one message";
+      CHECK(options.bytes > 0) << "must read ahead at least one byte";
+
+      tag = Tag(this, [](void* state, bool ok) {
+        static_cast<State*>(state)->Completed(ok);
+      });
+    }
+
+    template <typename K>
+    void Next(K& k) {
+      std::unique_lock lock(mutex);
+
+      if (!buffered.empty()) {
+        Buffer_ buffer = std::move(buffered.front());
+        buffered.pop_front();
+        bytes -= size(buffer);
+
+        bool issue = ShouldRead();
+
+        lock.unlock();
+
+        if (issue) {
+          read(&reading, &tag);
+        }
+
+        Emit(k, std::move(buffer));
+      } else if (ended) {
+        lock.unlock();
+        k.Ended();
+      } else {
+        // Wait for the next message, which gets handed directly to
+        // 'k' rather than going through the buffer.
+        waiting = &k;
+        resume = [](void* k, State& state, std::optional<Buffer_>&& buffer) {
+          if (buffer) {
+            state.Emit(*static_cast<K*>(k), std::move(buffer.value()));
+          } else {
+            static_cast<K*>(k)->Ended();
+          }
+        };
+
+        bool issue = ShouldRead();
+
+        lock.unlock();
+
+        if (issue) {
+          read(&reading, &tag);
+        }
+      }
+    }
+
+    void Done() {
+      std::scoped_lock lock(mutex);
+      done = true;
+      waiting = nullptr;
+      buffered.clear();
+      bytes = 0;
+    }
+
+    // NOTE: expects 'mutex' to be held. If returns true then a read
+    // should be issued (after releasing 'mutex').
+    bool ShouldRead() {
+      if (!outstanding
+          && !ended
+          && !done
+          && buffered.size() < options.messages
+          && bytes < options.bytes) {
+        outstanding = true;
+        // Keep ourselves alive until the read completes.
+        self = this->shared_from_this();
+        return true;
+      }
+      return false;
+    }
+
+    void Completed(bool ok) {
+      std::unique_lock lock(mutex);
+
+      // NOTE: we may be the last reference, hence moving it out so it
+      // doesn't get released until after we've released 'mutex'.
+      auto keep = std::move(self);
+
+      outstanding = false;
+
+      if (done) {
+        return;
+      }
+
+      if (!ok) {
+        ended = true;
+        if (waiting != nullptr) {
+          void* k = std::exchange(waiting, nullptr);
+          lock.unlock();
+          resume(k, *this, std::nullopt);
+        }
+        return;
+      }
+
+      Buffer_ buffer = std::exchange(reading, Buffer_());
+
+      if (waiting != nullptr) {
+        void* k = std::exchange(waiting, nullptr);
+        bool issue = ShouldRead();
+        lock.unlock();
+        if (issue) {
+          read(&reading, &tag);
+        }
+        resume(k, *this, std::move(buffer));
+      } else {
+        bytes += size(buffer);
+        buffered.push_back(std::move(buffer));
+        bool issue = ShouldRead();
+        lock.unlock();
+        if (issue) {
+          read(&reading, &tag);
+        }
+      }
+    }
+
+    template <typename K>
+    void Emit(K& k, Buffer_&& buffer) {
+      std::optional<Value_> value = parse(std::move(buffer));
+      if (value) {
+        k.Emit(std::move(value.value()));
+      } else {
+        k.Fail(std::runtime_error("Failed to deserialize message"));
+      }
+    }
+
+    const ReadAheadOptions options;
+
+    Read_ read;
+    Size_ size;
+    Parse_ parse;
+
+    std::mutex mutex;
+
+    std::deque<Buffer_> buffered;
+    size_t bytes = 0;
+
+    // What the outstanding read (if any) is reading into.
+    Buffer_ reading;
+
+    bool outstanding = false;
+    bool ended = false;
+    bool done = false;
+
+    // Continuation waiting for the next message, if any.
+    void* waiting = nullptr;
+    void (*resume)(void*, State&, std::optional<Buffer_>&&) = nullptr;
+
+    Tag tag;
+
+    std::shared_ptr<State> self;
+  };
+};
+
+////////////////////////////////////////////////////////////////////////
+
+// Returns a stream of 'Value_' that keeps a read (via 'read(Buffer_*,
+// Tag*)') outstanding whenever there is room in a buffer
+// bounded by 'options' (as measured by 'size(const Buffer_&)') rather
+// than only reading once the consumer asks for the next value. Each
+// buffer is converted via 'parse(Buffer_&&)' which returns
+// 'std::nullopt' if the buffer couldn't be parsed.
+//
+// NOTE: at most one read is outstanding at a time as gRPC requires.
+template <
+    typename Value_,
+    typename Buffer_,
+    typename Read_,
+    typename Size_,
+    typename Parse_>
+auto ReadAhead(ReadAheadOptions options, Read_ read, Size_ size, Parse_ parse) {
+  using State = _ReadAhead::State<Value_, Buffer_, Read_, Size_, Parse_>;
+
+  // Stops reading ahead if the stream gets destructed without the
+  // consumer having called done, e.g., because of an interrupt.
+  struct Handle {
+    Handle(std::shared_ptr<State> state)
+      : state(std::move(state)) {}
+
+    Handle(Handle&& that) = default;
+
+    ~Handle() {
+      if (state) {
+        state->Done();
+      }
+    }
+
+    std::shared_ptr<State> state;
+  };
+
+  auto state = std::make_shared<State>(
+      options,
+      std::move(read),
+      std::move(size),
+      std::move(parse));
+
+  return eventuals::Stream<Value_>()
+      .next([handle = Handle(state)](auto& k) mutable {
+        handle.state->Next(k);
+      })
+      .done([handle = Handle(state)](auto& k) mutable {
+        handle.state->Done();
+        k.Ended();
+      });
+}
+
+////////////////////////////////////////////////////////////////////////
+
+} // namespace grpc
+} // namespace eventuals
+
+////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,287 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "glog/logging.h"
+#include "grpcpp/support/byte_buffer.h"
+
+////////////////////////////////////////////////////////////////////////
+
+namespace eventuals {
+namespace grpc {
+
+////////////////////////////////////////////////////////////////////////
+
+// Format of a recording made by a 'Recorder' (and read by a
+// 'Recording::Reader'):
+//
+//   recording := magic record*
+//   magic     := "EVGRPC01"
+//   record    := length:u32 type:u8 call:u64 nanoseconds:u64 body
+//
+// Where 'length' is the number of bytes following it, 'call'
+// identifies the call the record belongs to, 'nanoseconds' is when the
+// record was made relative to when the recording was started, and
+// 'body' depends on 'type':
+//
+//   Call:    size:u32 method size:u32 host
+//   Request: the serialized request (the rest of the record)
+//
+// NOTE: integers are written in host byte order, i.e., recordings
+// are only meant to be replayed on the same kind of machine.
+struct Recording {
+  static constexpr char kMagic[] = "EVGRPC01";
+
+  enum class Type : uint8_t {
+    Call = 1,
+    Request = 2,
+  };
+
+  struct Record {
+    Type type;
+    uint64_t call = 0;
+    std::chrono::nanoseconds time;
+
+    // Only for 'Type::Call'.
+    std::string method;
+    std::string host;
+
+    // Only for 'Type::Request'.
+    std::string request;
+  };
+
+  class Reader {
+   public:
+    // Returns 'nullptr' if 'path' can't be opened or isn't a
+    // recording.
+    static std::unique_ptr<Reader> Open(const std::string& path) {
+      FILE* file = std::fopen(path.c_str(), "rb");
+      if (file == nullptr) {
+        return nullptr;
+      }
+
+      char magic[sizeof(kMagic) - 1];
+
+      if (std::fread(magic, sizeof(magic), 1, file) != 1
+          || std::memcmp(magic, kMagic, sizeof(magic)) != 0) {
+        std::fclose(file);
+        return nullptr;
+      }
+
+      return std::unique_ptr<Reader>(new Reader(file));
+    }
+
+    Reader(const Reader&) = delete;
+
+    ~Reader() {
+      std::fclose(file_);
+    }
+
+    // Returns the next record or 'std::nullopt' at the end of the
+    // recording (including if the last record was truncated, e.g.,
+    // because the server crashed while recording).
+    std::optional<Record> Next() {
+      uint32_t length = 0;
+      if (std::fread(&length, sizeof(length), 1, file_) != 1) {
+        return std::nullopt;
+      }
+
+      std::string data(length, '\0');
+      if (length > 0 && std::fread(data.data(), length, 1, file_) != 1) {
+        return std::nullopt;
+      }
+
+      size_t offset = 0;
+
+      auto read = [&](void* value, size_t size) {
+        if (offset + size > data.size()) {
+          return false;
+        }
+        std::memcpy(value, data.data() + offset, size);
+        offset += size;
+        return true;
+      };
+
+      auto string = [&](std::string* value) {
+        uint32_t size = 0;
+        if (!read(&size, sizeof(size)) || offset + size > data.size()) {
+          return false;
+        }
+        value->assign(data, offset, size);
+        offset += size;
+        return true;
+      };
+
+      Record record;
+      uint8_t type = 0;
+      int64_t nanoseconds = 0;
+
+      if (!read(&type, sizeof(type))
+          || !read(&record.call, sizeof(record.call))
+          || !read(&nanoseconds, sizeof(nanoseconds))) {
+        return std::nullopt;
+      }
+
+      record.type = static_cast<Type>(type);
+      record.time = std::chrono::nanoseconds(nanoseconds);
+
+      switch (record.type) {
+        case Type::Call:
+          if (!string(&record.method) || !string(&record.host)) {
+            return std::nullopt;
+          }
+          break;
+        case Type::Request:
+          record.request = data.substr(offset);
+          break;
+        default:
+          LOG(WARNING) << "Unknown record type " << (int) type;
+          return std::nullopt;
+      }
+
+      return record;
+    }
+
+   private:
+    Reader(FILE* file)
+      : file_(file) {}
+
+    FILE* file_;
+  };
+};
+
+////////////////////////////////////////////////////////////////////////
+
+// Records calls (their method, host, and when they were received)
+// and their (serialized) requests to a file, see 'Recording' for the
+// format and 'ServerBuilder::SetRecording()'.
+class Recorder {
+ public:
+  // Returns 'nullptr' if 'path' can't be opened for writing.
+  static std::unique_ptr<Recorder> Open(const std::string& path) {
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+      return nullptr;
+    }
+
+    if (std::fwrite(
+            Recording::kMagic,
+            sizeof(Recording::kMagic) - 1,
+            1,
+            file)
+        != 1) {
+      std::fclose(file);
+      return nullptr;
+    }
+
+    return std::unique_ptr<Recorder>(new Recorder(file));
+  }
+
+  Recorder(const Recorder&) = delete;
+
+  ~Recorder() {
+    std::fclose(file_);
+  }
+
+  // Records a new call returning an identifier for recording its
+  // requests.
+  uint64_t Call(const std::string& method, const std::string& host) {
+    std::scoped_lock lock(mutex_);
+
+    uint64_t call = ++calls_;
+
+    std::string body;
+    Append(&body, static_cast<uint32_t>(method.size()));
+    body.append(method);
+    Append(&body, static_cast<uint32_t>(host.size()));
+    body.append(host);
+
+    Write(Recording::Type::Call, call, body);
+
+    return call;
+  }
+
+  // Records a request of 'call' (as returned from 'Call()').
+  void Request(uint64_t call, const ::grpc::ByteBuffer& buffer) {
+    std::vector<::grpc::Slice> slices;
+
+    // NOTE: 'Dump()' only takes references to the slices rather than
+    // copying them, and doesn't consume the buffer.
+    if (!buffer.Dump(&slices).ok()) {
+      LOG(WARNING) << "Failed to record request of call " << call;
+      return;
+    }
+
+    std::string body;
+    body.reserve(buffer.Length());
+    for (auto& slice : slices) {
+      body.append(
+          reinterpret_cast<const char*>(slice.begin()),
+          slice.size());
+    }
+
+    std::scoped_lock lock(mutex_);
+
+    Write(Recording::Type::Request, call, body);
+  }
+
+ private:
+  Recorder(FILE* file)
+    : file_(file),
+      started_(std::chrono::steady_clock::now()) {}
+
+  template <typename T>
+  static void Append(std::string* s, T value) {
+    s->append(reinterpret_cast<const char*>(&value), sizeof(value));
+  }
+
+  // NOTE: expects 'mutex_' to be held.
+  void Write(Recording::Type type, uint64_t call, const std::string& body) {
+    int64_t nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                              std::chrono::steady_clock::now() - started_)
+                              .count();
+
+    std::string header;
+    Append(
+        &header,
+        static_cast<uint32_t>(
+            sizeof(uint8_t)
+            + sizeof(call)
+            + sizeof(nanoseconds)
+            + body.size()));
+    Append(&header, static_cast<uint8_t>(type));
+    Append(&header, call);
+    Append(&header, nanoseconds);
+
+    // NOTE: 'FILE' does its own buffering so this doesn't do a system
+    // call per record.
+    if (std::fwrite(header.data(), header.size(), 1, file_) != 1
+        || (!body.empty()
+            && std::fwrite(body.data(), body.size(), 1, file_) != 1)) {
+      LOG(WARNING) << "Failed to record call " << call;
+    }
+  }
+
+  FILE* file_;
+
+  const std::chrono::steady_clock::time_point started_;
+
+  std::mutex mutex_;
+
+  uint64_t calls_ = 0;
+};
+
+////////////////////////////////////////////////////////////////////////
+
+} // namespace grpc
+} // namespace eventuals
+
+////////////////////////////////////////////////////////////////////////
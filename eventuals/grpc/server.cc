@@ -1,10 +1,21 @@
 #include "eventuals/grpc/server.h"
 
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
 #include <thread>
+#include <tuple>
 
 #include "eventuals/catch.h"
 #include "eventuals/closure.h"
 #include "eventuals/conditional.h"
+#include "eventuals/grpc/arena.h"
 #include "eventuals/grpc/logging.h"
 #include "eventuals/just.h"
 #include "eventuals/loop.h"
@@ -24,70 +35,79 @@ auto Server::RequestCall(
     ::grpc::ServerCompletionQueue* cq) {
   return Eventual<void>()
       .raises<std::runtime_error>()
-      .context(Callback<bool>())
+      .context(Tag())
       // NOTE: 'context' and 'cq' are stored in a 'Closure()' so safe
       // to capture them as references here.
-      .start([this, context, cq](auto& callback, auto& k) {
-        if (!callback) {
-          callback = [&k](bool ok) {
+      .start([this, context, cq](auto& tag, auto& k) {
+        if (!tag) {
+          using K = std::decay_t<decltype(k)>;
+          tag = Tag(&k, [](void* k, bool ok) {
             if (ok) {
-              k.Start();
+              static_cast<K*>(k)->Start();
             } else {
-              k.Fail(std::runtime_error("RequestCall !ok"));
+              static_cast<K*>(k)->Fail(
+                  std::runtime_error("RequestCall !ok"));
             }
-          };
+          });
         }
 
         service_->RequestCall(
             context->context(),
-            context->stream(),
+            context->async_stream(),
             // TODO(benh): use completion queue from
             // CompletionPool for each call rather than the
             // notification completion queue that we are using
             // for server notifications?
             cq,
             cq,
-            &callback);
+            &tag);
       });
 }
 
 ////////////////////////////////////////////////////////////////////////
 
-auto Server::Lookup(ServerContext* context) {
-  // NOTE: 'context' is stored in a 'Closure()' so safe to capture as
-  // a reference here.
-  return Synchronized(Then([this, context]() {
-    Endpoint* endpoint = nullptr;
-
-    auto iterator = endpoints_.find(
-        std::make_pair(context->method(), context->host()));
-
-    if (iterator != endpoints_.end()) {
-      endpoint = iterator->second.get();
-    } else {
-      iterator = endpoints_.find(
-          std::make_pair(context->method(), "*"));
-
-      if (iterator != endpoints_.end()) {
-        endpoint = iterator->second.get();
-      }
-    }
-
-    return endpoint;
-  }));
+auto Server::Lookup(ServerContext* context, Endpoints* shard) {
+  // NOTE: 'context' and 'shard' are stored in a 'Closure()' (or
+  // outlive the call in the case of 'shard') so safe to capture them
+  // here.
+  return Then([context, shard]() -> Endpoint* {
+           // NOTE: 'shard' is frozen before any calls are requested
+           // so it's safe to read without synchronization.
+           return shard != nullptr
+               ? shard->Find(context->method(), context->host())
+               : nullptr;
+         })
+      | Conditional(
+             [this](Endpoint* endpoint) {
+               return endpoint == nullptr && !endpoints_.empty();
+             },
+             [this, context](Endpoint*) {
+               return endpoints_.Lookup(context);
+             },
+             [](Endpoint* endpoint) {
+               return Just(endpoint);
+             });
 }
 
 ////////////////////////////////////////////////////////////////////////
 
-auto Server::Unimplemented(ServerContext* context) {
-  return Then([context]() {
+auto Server::Reject(ServerContext* context, Endpoint* endpoint) {
+  return Then([context, endpoint]() {
     EVENTUALS_GRPC_LOG(1)
         << "Dropping call for host " << context->host()
-        << " and path = " << context->method();
-
-    auto status = ::grpc::Status(
-        ::grpc::UNIMPLEMENTED,
-        context->method() + " for host " + context->host());
+        << " and path = " << context->method()
+        << (endpoint == nullptr ? "" : " (at concurrency limit)");
+
+    // NOTE: we only reject calls with an 'endpoint' when it is at its
+    // concurrency limit, otherwise nobody is serving the call.
+    auto status = endpoint == nullptr
+        ? ::grpc::Status(
+            ::grpc::UNIMPLEMENTED,
+            context->method() + " for host " + context->host())
+        : ::grpc::Status(
+            ::grpc::RESOURCE_EXHAUSTED,
+            "Concurrency limit reached for " + context->method()
+                + " for host " + context->host());
 
     context->FinishThenOnDone(status, [context](bool) {
       delete context;
@@ -97,24 +117,134 @@ auto Server::Unimplemented(ServerContext* context) {
 
 ////////////////////////////////////////////////////////////////////////
 
+void Server::Dispatch(std::unique_ptr<ServerContext>&& context) {
+  Record(context.get());
+
+  // NOTE: we're on one of gRPC's threads so rather than blocking it
+  // until the call has been enqueued (or rejected), e.g., while
+  // waiting on the lock of the endpoints, we start dispatching and
+  // whichever thread finishes it deletes it.
+  struct Dispatching {
+    Interrupt interrupt;
+    std::optional<Task::Of<void>> task;
+  };
+
+  auto* dispatching = new Dispatching();
+
+  dispatching->task.emplace(
+      Task::Of<void>([this, context = context.release()]() {
+        return Closure(
+            [this,
+             context = std::unique_ptr<ServerContext>(context)]() mutable {
+              return Lookup(context.get())
+                  | Conditional(
+                         [&](auto* endpoint) {
+                           return endpoint != nullptr
+                               && endpoint->Admit(context.get());
+                         },
+                         [&](auto* endpoint) {
+                           return endpoint->Enqueue(std::move(context));
+                         },
+                         [&](auto* endpoint) {
+                           return Reject(context.release(), endpoint);
+                         });
+            });
+      }));
+
+  dispatching->task->Start(
+      dispatching->interrupt,
+      [dispatching]() {
+        delete dispatching;
+      },
+      [](std::exception_ptr) {
+        LOG(FATAL) << "Unreachable";
+      },
+      []() {
+        LOG(FATAL) << "Unreachable";
+      });
+}
+
+////////////////////////////////////////////////////////////////////////
+
+class Server::CallbackService : public ::grpc::CallbackGenericService {
+ public:
+  void Start(Server* server) {
+    server_.store(server);
+  }
+
+  ::grpc::ServerGenericBidiReactor* CreateReactor(
+      ::grpc::GenericCallbackServerContext* context) override {
+    auto call = std::make_unique<ServerContext>(context);
+
+    // NOTE: gRPC doesn't invoke the reactor until we return it, so
+    // it's safe to grab it now even though the call might get
+    // handled (and destructed) as soon as we've dispatched it.
+    auto* reactor = call->reactor();
+
+    // NOTE: calls can arrive after '::grpc::ServerBuilder::
+    // BuildAndStart()' but before the 'Server' has been constructed.
+    Server* server = server_.load();
+
+    if (server != nullptr) {
+      server->Dispatch(std::move(call));
+    } else {
+      auto* starting = call.release();
+
+      EVENTUALS_GRPC_LOG(1)
+          << "Dropping call for host " << starting->host()
+          << " and path = " << starting->method()
+          << " (server is starting)";
+
+      starting->FinishThenOnDone(
+          ::grpc::Status(::grpc::UNAVAILABLE, "Server is starting"),
+          [starting](bool) {
+            delete starting;
+          });
+    }
+
+    return reactor;
+  }
+
+ private:
+  std::atomic<Server*> server_ = nullptr;
+};
+
+////////////////////////////////////////////////////////////////////////
+
 Server::Server(
     std::vector<Service*>&& services,
     std::unique_ptr<::grpc::AsyncGenericService>&& service,
+    std::unique_ptr<CallbackService>&& callbackService,
     std::unique_ptr<::grpc::Server>&& server,
     std::vector<std::unique_ptr<::grpc::ServerCompletionQueue>>&& cqs,
-    std::vector<std::thread>&& threads)
-  : service_(std::move(service)),
+    std::vector<std::unique_ptr<Poller>>&& pollers,
+    std::vector<std::thread>&& threads,
+    absl::flat_hash_map<
+        std::string,
+        ConcurrencyLimit::Options>&& limits,
+    std::unique_ptr<Recorder>&& recorder,
+    std::unique_ptr<CallLog>&& log,
+    bool threadPerCore)
+  : recorder_(std::move(recorder)),
+    log_(std::move(log)),
+    service_(std::move(service)),
+    callback_service_(std::move(callbackService)),
     server_(std::move(server)),
     cqs_(std::move(cqs)),
-    threads_(std::move(threads)) {
-  for (auto* service : services) {
-    auto& serve = serves_.emplace_back(std::make_unique<Serve>());
-
-    serve->service = service;
+    pollers_(std::move(pollers)),
+    threads_(std::move(threads)),
+    limits_(std::move(limits)) {
+  if (threadPerCore) {
+    shards_.reserve(cqs_.size());
+    for (size_t i = 0; i < cqs_.size(); i++) {
+      shards_.push_back(std::make_unique<Endpoints>());
+    }
+  }
 
-    serve->service->Register(this);
+  auto start = [](Serve& serve) {
+    auto* service = serve.service;
 
-    serve->task.emplace(
+    serve.task.emplace(
         Task::Of<void>([service]() {
           // Use a separate preemptible scheduler context to serve
           // each service so that we correctly handle any waiting
@@ -128,38 +258,109 @@ Server::Server(
           return Preempt(service->name(), service->Serve());
         }));
 
-    serve->task->Start(
-        serve->interrupt,
+    serve.task->Start(
+        serve.interrupt,
         [&serve]() {
           EVENTUALS_GRPC_LOG(1)
-              << serve->service->name()
+              << serve.service->name()
               << " completed serving";
-          serve->done.store(true);
+          serve.done.store(true);
         },
         [&serve](std::exception_ptr) {
           EVENTUALS_GRPC_LOG(1)
-              << serve->service->name()
+              << serve.service->name()
               << " failed serving";
-          serve->done.store(true);
+          serve.done.store(true);
         },
         [&serve]() {
           EVENTUALS_GRPC_LOG(1)
-              << serve->service->name()
+              << serve.service->name()
               << " stopped serving";
-          serve->done.store(true);
+          serve.done.store(true);
         });
+  };
+
+  // With 'ServerBuilder::SetThreadPerCore()' each service gets served
+  // once per completion queue starting from the thread polling that
+  // completion queue so that its 'Accept()'s insert into that
+  // completion queue's endpoints, see 'CurrentEndpoints()'. We use
+  // an alarm that expires immediately to get onto that thread and we
+  // wait until every service has started so that a 'Shutdown()'
+  // can't race with any 'Accept()'.
+  std::mutex mutex;
+  std::condition_variable condition;
+  size_t starting = 0;
+
+  for (auto* service : services) {
+    service->Register(this);
+
+    if (shards_.empty()) {
+      auto& serve = serves_.emplace_back(std::make_unique<Serve>());
+      serve->service = service;
+      start(*serve);
+    } else {
+      for (auto& cq : cqs_) {
+        auto& serve = serves_.emplace_back(std::make_unique<Serve>());
+        serve->service = service;
+        serve->started = [&, serve = serve.get()](bool ok) {
+          if (ok) {
+            start(*serve);
+          } else {
+            serve->done.store(true);
+          }
+          std::scoped_lock lock(mutex);
+          starting--;
+          condition.notify_all();
+        };
+
+        {
+          std::scoped_lock lock(mutex);
+          starting++;
+        }
+
+        serve->start = Tag(&serve->started, [](void* started, bool ok) {
+          (*static_cast<Callback<bool>*>(started))(ok);
+        });
+
+        serve->alarm.emplace();
+        serve->alarm->Set(
+            cq.get(),
+            std::chrono::system_clock::now(),
+            &serve->start);
+      }
+    }
+  }
+
+  {
+    std::unique_lock lock(mutex);
+    condition.wait(lock, [&]() {
+      return starting == 0;
+    });
+  }
+
+  // Now that every service has started (and thus accepted on its
+  // completion queue's thread) each shard is immutable so that its
+  // thread can look up calls without synchronization. Any 'Accept()'
+  // from now on inserts into the shared endpoints instead.
+  for (auto& shard : shards_) {
+    shard->Freeze();
   }
 
   workers_.reserve(cqs_.size());
 
-  for (auto&& cq : cqs_) {
+  for (size_t i = 0; i < cqs_.size(); i++) {
     auto& worker = workers_.emplace_back(std::make_unique<Worker>());
 
+    Endpoints* shard = shards_.empty() ? nullptr : shards_[i].get();
+
     worker->task.emplace(
-        cq.get(),
-        [this](auto* cq) {
+        cqs_[i].get(),
+        [this, shard](auto* cq) {
           return Closure(
-              [this, cq, context = std::unique_ptr<ServerContext>()]() mutable {
+              [this,
+               cq,
+               shard,
+               context = std::unique_ptr<ServerContext>()]() mutable {
                 // Use a separate preemptible scheduler context for
                 // each worker so that we correctly handle any waiting
                 // (e.g., on 'Lock' or 'Wait').
@@ -168,17 +369,21 @@ Server::Server(
                     Repeat([&]() mutable {
                       context = std::make_unique<ServerContext>();
                       return RequestCall(context.get(), cq)
-                          | Lookup(context.get())
+                          | Then([this, context = context.get()]() {
+                               Record(context);
+                             })
+                          | Lookup(context.get(), shard)
                           | Conditional(
-                                 [](auto* endpoint) {
-                                   return endpoint != nullptr;
+                                 [&](auto* endpoint) {
+                                   return endpoint != nullptr
+                                       && endpoint->Admit(context.get());
                                  },
                                  [&](auto* endpoint) {
                                    return endpoint->Enqueue(
                                        std::move(context));
                                  },
-                                 [&](auto*) {
-                                   return Unimplemented(context.release());
+                                 [&](auto* endpoint) {
+                                   return Reject(context.release(), endpoint);
                                  });
                     })
                         | Loop()
@@ -210,6 +415,10 @@ Server::Server(
           LOG(FATAL) << "Unreachable";
         });
   }
+
+  if (callback_service_) {
+    callback_service_->Start(this);
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////
@@ -225,10 +434,58 @@ Server::~Server() {
 
 ////////////////////////////////////////////////////////////////////////
 
+std::vector<EndpointPhases> Server::Phases() {
+  std::vector<EndpointPhases> endpoints;
+
+  {
+    std::scoped_lock lock(phases_mutex_);
+    for (const auto& [key, histograms] : phases_) {
+      EndpointPhases endpoint;
+      endpoint.path = key.first;
+      endpoint.host = key.second;
+      for (size_t i = 0; i < CallPhases::kPhases; i++) {
+        endpoint.phases[i] = CallPhases::Summarize(
+            (*histograms)[static_cast<CallPhases::Phase>(i)]);
+      }
+      endpoints.push_back(std::move(endpoint));
+    }
+  }
+
+  std::sort(
+      endpoints.begin(),
+      endpoints.end(),
+      [](const EndpointPhases& a, const EndpointPhases& b) {
+        return std::tie(a.path, a.host) < std::tie(b.path, b.host);
+      });
+
+  return endpoints;
+}
+
+////////////////////////////////////////////////////////////////////////
+
+CallPhases::Histograms* Server::Histograms(
+    const std::string& path,
+    const std::string& host) {
+  std::scoped_lock lock(phases_mutex_);
+  auto& histograms = phases_[std::make_pair(path, host)];
+  if (!histograms) {
+    histograms = std::make_unique<CallPhases::Histograms>();
+  }
+  return histograms.get();
+}
+
+////////////////////////////////////////////////////////////////////////
+
 void Server::Shutdown() {
   // Server might have already been shutdown.
   if (server_) {
     server_->Shutdown();
+
+    // With 'ServerBackend::Callback' there aren't any workers to
+    // notice the shutdown so we shutdown the endpoints ourselves.
+    if (callback_service_) {
+      *ShutdownEndpoints();
+    }
   }
 
   // NOTE: we don't interrupt 'workers_' or 'serves_' as shutting down
@@ -300,6 +557,26 @@ void Server::Wait() {
 
 ////////////////////////////////////////////////////////////////////////
 
+// Pins 'thread' to 'core' (modulo the number of cores), if supported
+// by the platform. Failing to pin is not an error as it's only an
+// optimization.
+static void Pin(std::thread& thread, size_t core) {
+#if defined(__linux__)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(core % std::max(std::thread::hardware_concurrency(), 1u), &set);
+  int error = pthread_setaffinity_np(
+      thread.native_handle(),
+      sizeof(set),
+      &set);
+  if (error != 0) {
+    EVENTUALS_GRPC_LOG(1) << "Failed to pin thread to core " << core;
+  }
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////
+
 ServerBuilder& ServerBuilder::SetNumberOfCompletionQueues(size_t n) {
   if (numberOfCompletionQueues_) {
     std::string error = "already set number of completion queues";
@@ -333,6 +610,83 @@ ServerBuilder& ServerBuilder::SetMinimumThreadsPerCompletionQueue(size_t n) {
 
 ////////////////////////////////////////////////////////////////////////
 
+ServerBuilder& ServerBuilder::SetCompletionQueueTick(
+    std::chrono::nanoseconds tick) {
+  if (completionQueueTick_) {
+    std::string error = "already set completion queue tick";
+    if (!status_.ok()) {
+      status_ = ServerStatus::Error(status_.error() + "; " + error);
+    } else {
+      status_ = ServerStatus::Error(error);
+    }
+  } else if (tick.count() <= 0) {
+    std::string error = "completion queue tick must be positive";
+    if (!status_.ok()) {
+      status_ = ServerStatus::Error(status_.error() + "; " + error);
+    } else {
+      status_ = ServerStatus::Error(error);
+    }
+  } else {
+    completionQueueTick_ = tick;
+  }
+  return *this;
+}
+
+////////////////////////////////////////////////////////////////////////
+
+ServerBuilder& ServerBuilder::SetBackend(ServerBackend backend) {
+  if (backend_) {
+    std::string error = "already set backend";
+    if (!status_.ok()) {
+      status_ = ServerStatus::Error(status_.error() + "; " + error);
+    } else {
+      status_ = ServerStatus::Error(error);
+    }
+  } else {
+    backend_ = backend;
+  }
+  return *this;
+}
+
+////////////////////////////////////////////////////////////////////////
+
+ServerBuilder& ServerBuilder::SetThreadPerCore() {
+  if (threadPerCore_) {
+    std::string error = "already set thread per core";
+    if (!status_.ok()) {
+      status_ = ServerStatus::Error(status_.error() + "; " + error);
+    } else {
+      status_ = ServerStatus::Error(error);
+    }
+  } else {
+    threadPerCore_ = true;
+  }
+  return *this;
+}
+
+////////////////////////////////////////////////////////////////////////
+
+ServerBuilder& ServerBuilder::SetConcurrencyLimit(
+    const std::string& name,
+    ConcurrencyLimit::Options options) {
+  std::optional<std::string> error = ConcurrencyLimit::Validate(options);
+  if (!error && limits_.contains(name)) {
+    error = "already set concurrency limit for " + name;
+  }
+  if (error) {
+    if (!status_.ok()) {
+      status_ = ServerStatus::Error(status_.error() + "; " + error.value());
+    } else {
+      status_ = ServerStatus::Error(error.value());
+    }
+  } else {
+    limits_.emplace(name, options);
+  }
+  return *this;
+}
+
+////////////////////////////////////////////////////////////////////////
+
 ServerBuilder& ServerBuilder::AddListeningPort(
     const std::string& address,
     std::shared_ptr<::grpc::ServerCredentials> credentials,
@@ -351,6 +705,40 @@ ServerBuilder& ServerBuilder::RegisterService(Service* service) {
 
 ////////////////////////////////////////////////////////////////////////
 
+ServerBuilder& ServerBuilder::SetRecording(const std::string& path) {
+  if (recording_) {
+    std::string error = "already set recording";
+    if (!status_.ok()) {
+      status_ = ServerStatus::Error(status_.error() + "; " + error);
+    } else {
+      status_ = ServerStatus::Error(error);
+    }
+  } else {
+    recording_ = path;
+  }
+  return *this;
+}
+
+////////////////////////////////////////////////////////////////////////
+
+ServerBuilder& ServerBuilder::SetCallLog(
+    const std::string& path,
+    CallLogOptions options) {
+  if (log_) {
+    std::string error = "already set call log";
+    if (!status_.ok()) {
+      status_ = ServerStatus::Error(status_.error() + "; " + error);
+    } else {
+      status_ = ServerStatus::Error(error);
+    }
+  } else {
+    log_.emplace(path, options);
+  }
+  return *this;
+}
+
+////////////////////////////////////////////////////////////////////////
+
 ServerStatusOrServer ServerBuilder::BuildAndStart() {
   if (addresses_.empty()) {
     const std::string error = "no listening addresses specified";
@@ -361,28 +749,98 @@ ServerStatusOrServer ServerBuilder::BuildAndStart() {
     }
   }
 
+  if (!backend_) {
+    backend_ = ServerBackend::CompletionQueue;
+  }
+
+  if (backend_ == ServerBackend::Callback
+      && (numberOfCompletionQueues_
+          || minimumThreadsPerCompletionQueue_
+          || completionQueueTick_
+          || threadPerCore_)) {
+    const std::string error =
+        "completion queue options can not be used with callback backend";
+    if (!status_.ok()) {
+      status_ = ServerStatus::Error(status_.error() + "; " + error);
+    } else {
+      status_ = ServerStatus::Error(error);
+    }
+  }
+
+  if (threadPerCore_
+      && minimumThreadsPerCompletionQueue_.value_or(1) != 1) {
+    const std::string error =
+        "thread per core requires one thread per completion queue";
+    if (!status_.ok()) {
+      status_ = ServerStatus::Error(status_.error() + "; " + error);
+    } else {
+      status_ = ServerStatus::Error(error);
+    }
+  }
+
+  std::unique_ptr<Recorder> recorder;
+
+  if (recording_) {
+    recorder = Recorder::Open(recording_.value());
+    if (!recorder) {
+      const std::string error =
+          "failed to open recording '" + recording_.value() + "'";
+      if (!status_.ok()) {
+        status_ = ServerStatus::Error(status_.error() + "; " + error);
+      } else {
+        status_ = ServerStatus::Error(error);
+      }
+    }
+  }
+
+  std::unique_ptr<CallLog> log;
+
+  if (log_) {
+    log = CallLog::Open(log_->first, log_->second);
+    if (!log) {
+      const std::string error =
+          "failed to open call log '" + log_->first + "'";
+      if (!status_.ok()) {
+        status_ = ServerStatus::Error(status_.error() + "; " + error);
+      } else {
+        status_ = ServerStatus::Error(error);
+      }
+    }
+  }
+
   if (!status_.ok()) {
     return ServerStatusOrServer{
         ServerStatus::Error("Error building server: " + status_.error()),
         nullptr};
   }
 
-  auto service = std::make_unique<::grpc::AsyncGenericService>();
+  std::unique_ptr<::grpc::AsyncGenericService> service;
+  std::unique_ptr<Server::CallbackService> callbackService;
 
-  builder_.RegisterAsyncGenericService(service.get());
+  std::vector<std::unique_ptr<::grpc::ServerCompletionQueue>> cqs;
 
-  if (!numberOfCompletionQueues_) {
-    numberOfCompletionQueues_ = 1;
-  }
+  if (backend_ == ServerBackend::Callback) {
+    callbackService = std::make_unique<Server::CallbackService>();
 
-  if (!minimumThreadsPerCompletionQueue_) {
-    minimumThreadsPerCompletionQueue_ = 1;
-  }
+    builder_.RegisterCallbackGenericService(callbackService.get());
+  } else {
+    service = std::make_unique<::grpc::AsyncGenericService>();
 
-  std::vector<std::unique_ptr<::grpc::ServerCompletionQueue>> cqs;
+    builder_.RegisterAsyncGenericService(service.get());
 
-  for (size_t i = 0; i < numberOfCompletionQueues_.value(); ++i) {
-    cqs.push_back(builder_.AddCompletionQueue());
+    if (!numberOfCompletionQueues_) {
+      numberOfCompletionQueues_ = threadPerCore_
+          ? std::max(std::thread::hardware_concurrency(), 1u)
+          : 1;
+    }
+
+    if (!minimumThreadsPerCompletionQueue_) {
+      minimumThreadsPerCompletionQueue_ = 1;
+    }
+
+    for (size_t i = 0; i < numberOfCompletionQueues_.value(); ++i) {
+      cqs.push_back(builder_.AddCompletionQueue());
+    }
   }
 
   std::unique_ptr<::grpc::Server> server = builder_.BuildAndStart();
@@ -397,18 +855,21 @@ ServerStatusOrServer ServerBuilder::BuildAndStart() {
     // NOTE: we wait to start the threads until after a succesful
     // 'BuildAndStart()' so that we don't have to bother with
     // stopping/joining.
+    std::vector<std::unique_ptr<Poller>> pollers;
     std::vector<std::thread> threads;
     for (auto& cq : cqs) {
+      auto& poller = pollers.emplace_back(
+          std::make_unique<Poller>(cq.get(), completionQueueTick_));
       for (size_t j = 0; j < minimumThreadsPerCompletionQueue_.value(); ++j) {
         threads.push_back(
             std::thread(
-                [cq = cq.get()]() {
-                  void* tag = nullptr;
-                  bool ok = false;
-                  while (cq->Next(&tag, &ok)) {
-                    (*static_cast<Callback<bool>*>(tag))(ok);
-                  }
+                [poller = poller.get()]() {
+                  BindThreadToArena();
+                  poller->Run();
                 }));
+        if (threadPerCore_) {
+          Pin(threads.back(), threads.size() - 1);
+        }
       }
     }
 
@@ -419,9 +880,15 @@ ServerStatusOrServer ServerBuilder::BuildAndStart() {
         std::unique_ptr<Server>(new Server(
             std::move(services_),
             std::move(service),
+            std::move(callbackService),
             std::move(server),
             std::move(cqs),
-            std::move(threads)))};
+            std::move(pollers),
+            std::move(threads),
+            std::move(limits_),
+            std::move(recorder),
+            std::move(log),
+            threadPerCore_))};
   }
 }
 
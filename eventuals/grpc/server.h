@@ -1,16 +1,35 @@
 #pragma once
 
+#include <atomic>
 #include <cassert>
+#include <chrono>
+#include <cstdint>
 #include <deque>
+#include <mutex>
+#include <optional>
+#include <string_view>
 #include <thread>
+#include <utility>
 
 #include "absl/container/flat_hash_map.h"
 #include "eventuals/catch.h"
+#include "eventuals/closure.h"
+#include "eventuals/compose.h"
+#include "eventuals/conditional.h"
 #include "eventuals/eventual.h"
+#include "eventuals/filter.h"
+#include "eventuals/grpc/call-log.h"
+#include "eventuals/grpc/call-phases.h"
+#include "eventuals/grpc/concurrency-limit.h"
+#include "eventuals/grpc/executor.h"
 #include "eventuals/grpc/logging.h"
-#include "eventuals/grpc/server.h"
+#include "eventuals/grpc/poller.h"
+#include "eventuals/grpc/read-ahead.h"
+#include "eventuals/grpc/recorder.h"
+#include "eventuals/grpc/tag.h"
 #include "eventuals/grpc/traits.h"
 #include "eventuals/head.h"
+#include "eventuals/interrupt.h"
 #include "eventuals/iterate.h"
 #include "eventuals/just.h"
 #include "eventuals/lock.h"
@@ -19,9 +38,11 @@
 #include "eventuals/pipe.h"
 #include "eventuals/repeat.h"
 #include "eventuals/task.h"
+#include "eventuals/terminal.h"
 #include "eventuals/then.h"
 #include "eventuals/until.h"
 #include "google/protobuf/descriptor.h"
+#include "grpcpp/alarm.h"
 #include "grpcpp/completion_queue.h"
 #include "grpcpp/generic/async_generic_service.h"
 #include "grpcpp/impl/codegen/proto_utils.h"
@@ -29,7 +50,6 @@
 #include "grpcpp/server.h"
 #include "grpcpp/server_builder.h"
 #include "grpcpp/server_context.h"
-#include "stout/notification.h"
 
 ////////////////////////////////////////////////////////////////////////
 
@@ -59,30 +79,281 @@ class Service {
     server_ = server;
   }
 
+  // Limits how many calls to 'method' (just the name of the method,
+  // not fully qualified) get handled concurrently. Must be called
+  // before the service starts serving, i.e., before
+  // 'ServerBuilder::BuildAndStart()'.
+  //
+  // NOTE: any limit set via 'ServerBuilder::SetConcurrencyLimit()'
+  // for the same method takes precedence.
+  void SetConcurrencyLimit(
+      const std::string& method,
+      ConcurrencyLimit::Options options) {
+    limits_[method] = options;
+  }
+
+  // Runs the handlers for all methods of this service on 'executor'
+  // rather than on the threads polling completion queues, which is
+  // useful for CPU heavy handlers. Must be called before the service
+  // starts serving, i.e., before 'ServerBuilder::BuildAndStart()'.
+  void SetExecutor(Executor* executor) {
+    executor_ = executor;
+  }
+
+  // Like 'SetExecutor(Executor*)' but just for 'method' (just the
+  // name of the method, not fully qualified), which takes precedence
+  // over an executor set for the whole service.
+  void SetExecutor(const std::string& method, Executor* executor) {
+    executors_[method] = executor;
+  }
+
  protected:
   Server& server() {
     return *CHECK_NOTNULL(server_);
   }
 
+  std::optional<ConcurrencyLimit::Options> ConcurrencyLimitFor(
+      const std::string& method) {
+    auto iterator = limits_.find(method);
+    if (iterator != limits_.end()) {
+      return iterator->second;
+    } else {
+      return std::nullopt;
+    }
+  }
+
+  // Returns the executor to run handlers for 'method' on, or
+  // 'nullptr' if they should run on the current thread.
+  Executor* ExecutorFor(const std::string& method) {
+    auto iterator = executors_.find(method);
+    if (iterator != executors_.end()) {
+      return iterator->second;
+    } else {
+      return executor_;
+    }
+  }
+
  private:
   Server* server_;
+
+  absl::flat_hash_map<std::string, ConcurrencyLimit::Options> limits_;
+
+  Executor* executor_ = nullptr;
+  absl::flat_hash_map<std::string, Executor*> executors_;
+};
+
+////////////////////////////////////////////////////////////////////////
+
+// Which gRPC API drives calls, see 'ServerBuilder::SetBackend()'.
+enum class ServerBackend {
+  // Our own threads poll completion queues using gRPC's asynchronous
+  // API, see 'Poller'. This is the default.
+  CompletionQueue,
+
+  // gRPC's callback API drives calls from its own internal threads,
+  // i.e., without any completion queues or threads of our own.
+  Callback,
+};
+
+////////////////////////////////////////////////////////////////////////
+
+// Operations on the underlying stream of a call which each
+// 'ServerBackend' implements. Every operation takes a 'Tag' that
+// gets invoked once the operation completes, just like a tag passed
+// to gRPC's asynchronous API.
+class ServerStream {
+ public:
+  virtual ~ServerStream() = default;
+
+  virtual void Read(
+      ::grpc::ByteBuffer* buffer,
+      Tag* tag) = 0;
+
+  virtual void Write(
+      const ::grpc::ByteBuffer& buffer,
+      ::grpc::WriteOptions options,
+      Tag* tag) = 0;
+
+  virtual void WriteLast(
+      const ::grpc::ByteBuffer& buffer,
+      ::grpc::WriteOptions options,
+      Tag* tag) = 0;
+
+  virtual void WriteAndFinish(
+      const ::grpc::ByteBuffer& buffer,
+      ::grpc::WriteOptions options,
+      const ::grpc::Status& status,
+      Tag* tag) = 0;
+
+  virtual void Finish(
+      const ::grpc::Status& status,
+      Tag* tag) = 0;
+};
+
+////////////////////////////////////////////////////////////////////////
+
+// 'ServerStream' for 'ServerBackend::CompletionQueue'.
+class CompletionQueueServerStream final : public ServerStream {
+ public:
+  CompletionQueueServerStream(::grpc::GenericServerContext* context)
+    : stream_(context) {}
+
+  ::grpc::GenericServerAsyncReaderWriter* stream() {
+    return &stream_;
+  }
+
+  void Read(
+      ::grpc::ByteBuffer* buffer,
+      Tag* tag) override {
+    stream_.Read(buffer, tag);
+  }
+
+  void Write(
+      const ::grpc::ByteBuffer& buffer,
+      ::grpc::WriteOptions options,
+      Tag* tag) override {
+    stream_.Write(buffer, options, tag);
+  }
+
+  void WriteLast(
+      const ::grpc::ByteBuffer& buffer,
+      ::grpc::WriteOptions options,
+      Tag* tag) override {
+    stream_.WriteLast(buffer, options, tag);
+  }
+
+  void WriteAndFinish(
+      const ::grpc::ByteBuffer& buffer,
+      ::grpc::WriteOptions options,
+      const ::grpc::Status& status,
+      Tag* tag) override {
+    stream_.WriteAndFinish(buffer, options, status, tag);
+  }
+
+  void Finish(
+      const ::grpc::Status& status,
+      Tag* tag) override {
+    stream_.Finish(status, tag);
+  }
+
+ private:
+  ::grpc::GenericServerAsyncReaderWriter stream_;
+};
+
+////////////////////////////////////////////////////////////////////////
+
+// Forward declaration.
+struct ServerContext;
+
+////////////////////////////////////////////////////////////////////////
+
+// 'ServerStream' for 'ServerBackend::Callback' which is also the
+// reactor that gRPC invokes as operations complete.
+//
+// NOTE: the reactor is owned by its 'ServerContext' (rather than
+// deleting itself in 'OnDone()' as is typical) so that calls have the
+// same lifetime regardless of the backend.
+class CallbackServerStream final
+  : public ServerStream,
+    public ::grpc::ServerGenericBidiReactor {
+ public:
+  CallbackServerStream(ServerContext* context)
+    : context_(context) {}
+
+  void Read(
+      ::grpc::ByteBuffer* buffer,
+      Tag* tag) override {
+    read_ = tag;
+    StartRead(buffer);
+  }
+
+  void Write(
+      const ::grpc::ByteBuffer& buffer,
+      ::grpc::WriteOptions options,
+      Tag* tag) override {
+    // NOTE: unlike the asynchronous API the callback API doesn't
+    // take a copy of the buffer so we keep one until the write is
+    // done (copying a 'ByteBuffer' only copies a reference).
+    buffer_ = buffer;
+    write_ = tag;
+    StartWrite(&buffer_, options);
+  }
+
+  void WriteLast(
+      const ::grpc::ByteBuffer& buffer,
+      ::grpc::WriteOptions options,
+      Tag* tag) override {
+    buffer_ = buffer;
+    write_ = tag;
+    StartWriteLast(&buffer_, options);
+  }
+
+  void WriteAndFinish(
+      const ::grpc::ByteBuffer& buffer,
+      ::grpc::WriteOptions options,
+      const ::grpc::Status& status,
+      Tag* tag) override {
+    buffer_ = buffer;
+    finish_ = tag;
+    StartWriteAndFinish(&buffer_, options, status);
+  }
+
+  void Finish(
+      const ::grpc::Status& status,
+      Tag* tag) override {
+    finish_ = tag;
+    ::grpc::ServerGenericBidiReactor::Finish(status);
+  }
+
+  void OnReadDone(bool ok) override {
+    (*std::exchange(read_, nullptr))(ok);
+  }
+
+  void OnWriteDone(bool ok) override {
+    (*std::exchange(write_, nullptr))(ok);
+  }
+
+  void OnCancel() override;
+
+  void OnDone() override;
+
+ private:
+  ServerContext* context_;
+
+  ::grpc::ByteBuffer buffer_;
+
+  Tag* read_ = nullptr;
+  Tag* write_ = nullptr;
+  Tag* finish_ = nullptr;
 };
 
 ////////////////////////////////////////////////////////////////////////
 
 struct ServerContext {
+  // Constructs a context for 'ServerBackend::CompletionQueue' which
+  // gets filled in by '::grpc::AsyncGenericService::RequestCall()'.
   ServerContext()
-    : stream_(&context_) {
+    : context_(std::in_place) {
+    auto stream = std::make_unique<CompletionQueueServerStream>(
+        &context_.value());
+
+    async_ = stream.get();
+    stream_ = std::move(stream);
+
+    // NOTE: a context gets constructed right before it gets passed to
+    // 'RequestCall()'.
+    Mark(CallPhases::Requested);
+
     // NOTE: according to documentation we must set up the done
-    // callback _before_ we start using the context. Thus we use a
-    // 'Notification' in order to actually queue the callback later,
-    // which also gives us the added benefit of having more than once
-    // callback.
-    done_callback_ = [this](bool) {
-      done_.Notify(context_.IsCancelled());
-    };
+    // callback _before_ we start using the context. Thus we record
+    // being done in 'state_' so that a callback can be added later,
+    // see 'OnDone()'.
+    done_ = Tag(this, [](void* context, bool) {
+      auto* self = static_cast<ServerContext*>(context);
+      self->NotifyDone(self->context_->IsCancelled());
+    });
 
-    context_.AsyncNotifyWhenDone(&done_callback_);
+    context_->AsyncNotifyWhenDone(&done_);
 
     // NOTE: it's possible that after doing a shutdown of the server
     // gRPC won't give us a done notification as per the bug at:
@@ -92,8 +363,39 @@ struct ServerContext {
     // up don't get executed.
   }
 
-  void OnDone(std::function<void(bool)>&& f) {
-    done_.Watch(std::move(f));
+  // Constructs a context for 'ServerBackend::Callback' where
+  // 'context' is owned by gRPC and valid until the call is done.
+  ServerContext(::grpc::GenericCallbackServerContext* context)
+    : callback_context_(CHECK_NOTNULL(context)) {
+    auto stream = std::make_unique<CallbackServerStream>(this);
+
+    reactor_ = stream.get();
+    stream_ = std::move(stream);
+  }
+
+  // Invokes 'f' with whether or not the call was cancelled once the
+  // call is done, or immediately if it is already done.
+  //
+  // NOTE: at most one callback can wait for the call to be done,
+  // e.g., via 'ServerCall::WaitForDone()'.
+  void OnDone(Callback<bool>&& f) {
+    on_done_ = std::move(f);
+    Watch();
+  }
+
+  // Records that this call has been admitted by 'limit' which gets
+  // released (along with how long the call took) once it is done.
+  void Admit(ConcurrencyLimit* limit) {
+    limit_ = limit;
+    admitted_ = std::chrono::steady_clock::now();
+
+    uint8_t previous = state_.fetch_or(kAdmitted, std::memory_order_acq_rel);
+
+    CHECK(!(previous & kAdmitted)) << "call admitted more than once";
+
+    if (previous & kDone) {
+      Release(previous & kCancelled);
+    }
   }
 
   // Performs 'Finish()' then 'OnDone()' in sequence to overcome the
@@ -103,54 +405,311 @@ struct ServerContext {
   // NOTE: it's remarkably surprising behavior that grpc will invoke
   // the finish callback _after_ the done callback!!!!!! This function
   // lets you get around that by sequencing the two callbacks.
-  void FinishThenOnDone(::grpc::Status status, std::function<void(bool)>&& f) {
-    CHECK(!finish_callback_)
+  void FinishThenOnDone(::grpc::Status status, Callback<bool>&& f) {
+    CHECK(!finish_)
         << "attempted to call FinishThenOnDone more than once";
 
-    finish_on_done_ = std::move(f);
+    // NOTE: 'f' only starts waiting for done once finished.
+    on_done_ = std::move(f);
 
-    finish_callback_ = [this](bool) {
-      OnDone(std::move(finish_on_done_));
-    };
+    finish_ = Tag(this, [](void* context, bool) {
+      static_cast<ServerContext*>(context)->Watch();
+    });
 
     EVENTUALS_GRPC_LOG(1)
         << "Finishing call (" << this << ")"
         << " for host = " << host()
         << " and path = " << method();
 
-    stream_.Finish(status, &finish_callback_);
+    Mark(CallPhases::Finishing);
+    Log(CallLog::Phase::Finish, status.error_code());
+
+    stream_->Finish(status, &finish_);
   }
 
+  // NOTE: returns 'nullptr' for 'ServerBackend::Callback' as gRPC
+  // uses a different type of context, see 'base()'.
   ::grpc::GenericServerContext* context() {
-    return &context_;
+    return context_ ? &context_.value() : nullptr;
   }
 
-  ::grpc::GenericServerAsyncReaderWriter* stream() {
-    return &stream_;
+  // Returns the underlying context regardless of the backend.
+  ::grpc::ServerContextBase* base() {
+    if (context_) {
+      return &context_.value();
+    } else {
+      return callback_context_;
+    }
   }
 
-  std::string method() const {
-    return context_.method();
+  ServerStream* stream() {
+    return stream_.get();
   }
 
-  std::string host() const {
-    return context_.host();
+  // Returns the stream that must be passed to
+  // '::grpc::AsyncGenericService::RequestCall()'.
+  ::grpc::GenericServerAsyncReaderWriter* async_stream() {
+    return CHECK_NOTNULL(async_)->stream();
+  }
+
+  // Returns the reactor that must be returned from
+  // '::grpc::CallbackGenericService::CreateReactor()'.
+  ::grpc::ServerGenericBidiReactor* reactor() {
+    return CHECK_NOTNULL(reactor_);
+  }
+
+  const std::string& method() const {
+    return context_ ? context_->method() : callback_context_->method();
+  }
+
+  const std::string& host() const {
+    return context_ ? context_->host() : callback_context_->host();
+  }
+
+  bool DeadlineExceeded() {
+    return base()->deadline() <= std::chrono::system_clock::now();
+  }
+
+  // Returns true if the call has been cancelled, either by the client
+  // or because the deadline was exceeded.
+  //
+  // NOTE: unlike '::grpc::ServerContext::IsCancelled()' this is safe
+  // to call at any time.
+  bool Cancelled() const {
+    return state_.load(std::memory_order_acquire) & kCancelled;
+  }
+
+  // Interrupt that gets triggered when the call gets cancelled, see
+  // 'ServerCall::Interruptible()'.
+  Interrupt& interrupt() {
+    return interrupt_;
+  }
+
+  // Records this call with 'recorder', and from now on each of its
+  // requests via 'Record(const ::grpc::ByteBuffer&)', see
+  // 'ServerBuilder::SetRecording()'.
+  void Record(Recorder* recorder) {
+    recorder_ = recorder;
+    recording_ = recorder_->Call(method(), host());
+  }
+
+  // Records 'request' if this call is being recorded.
+  void Record(const ::grpc::ByteBuffer& request) {
+    if (recorder_ != nullptr) {
+      recorder_->Request(recording_, request);
+    }
+  }
+
+  // Logs this call to 'log', and from now on the rest of its
+  // lifecycle via 'Log(CallLog::Phase, ...)', see
+  // 'ServerBuilder::SetCallLog()'.
+  void Log(CallLog* log) {
+    log_ = log;
+    logging_ = log_->Call(method(), host());
+  }
+
+  // Logs 'phase' of this call if it is being logged.
+  void Log(CallLog::Phase phase, uint32_t value = 0) {
+    if (log_ != nullptr) {
+      log_->Log(logging_, phase, value);
+    }
+  }
+
+  // Logs a message read or written by this call if it is being
+  // logged.
+  void Log(CallLog::Phase phase, const ::grpc::ByteBuffer& message) {
+    if (log_ != nullptr) {
+      log_->Message(logging_, phase, message);
+    }
+  }
+
+  // Timestamps this call reaching 'mark', see 'CallPhases'.
+  void Mark(CallPhases::Mark mark) {
+    timeline_.Mark(mark);
+  }
+
+  // Aggregates how long this call spent in each phase into 'phases'
+  // once it is done, see 'Server::Phases()'.
+  void Aggregate(CallPhases::Histograms* phases) {
+    phases_.store(phases, std::memory_order_release);
   }
 
  private:
-  ::grpc::GenericServerContext context_;
-  ::grpc::GenericServerAsyncReaderWriter stream_;
+  friend class CallbackServerStream;
+
+  // The lifecycle of a call is tracked with bits in 'state_', each of
+  // which gets set at most once, so that whichever of being notified
+  // and waiting for done happens second (possibly on different
+  // threads) invokes the waiting callback without needing a lock.
+  enum : uint8_t {
+    // The call has been cancelled (including when the deadline has
+    // been exceeded) and 'interrupt_' has been triggered.
+    kCancelled = 1 << 0,
+
+    // The call is done, i.e., gRPC won't use it anymore.
+    kDone = 1 << 1,
+
+    // The call has been admitted by 'limit_' which must be released
+    // once the call is done.
+    kAdmitted = 1 << 2,
+
+    // 'on_done_' is waiting to be invoked once the call is done.
+    kWatching = 1 << 3,
+
+    // 'NotifyDone()' is finished with this context, i.e., 'on_done_'
+    // can be invoked (which might destruct this context).
+    kNotified = 1 << 4,
+  };
+
+  void NotifyCancelled() {
+    uint8_t previous = state_.fetch_or(kCancelled, std::memory_order_acq_rel);
+    if (!(previous & kCancelled)) {
+      Log(CallLog::Phase::Cancelled);
+      interrupt_.Trigger();
+    }
+  }
+
+  void NotifyDone(bool cancelled) {
+    if (cancelled) {
+      NotifyCancelled();
+    }
+
+    Mark(CallPhases::Done);
+
+    Measure();
+
+    Log(CallLog::Phase::Done, cancelled);
+
+    // NOTE: 'kDone' only decides whether we or 'Admit()' releases the
+    // concurrency limit, nobody waiting for done can see it so this
+    // context stays valid until we set 'kNotified' below.
+    uint8_t previous = state_.fetch_or(kDone, std::memory_order_acq_rel);
+
+    CHECK(!(previous & kDone)) << "call done more than once";
+
+    if (previous & kAdmitted) {
+      Release(cancelled);
+    }
+
+    previous = state_.fetch_or(kNotified, std::memory_order_acq_rel);
+
+    if (previous & kWatching) {
+      // NOTE: invoking might destruct this context, so we move the
+      // callback out first and must not touch any members after.
+      auto f = std::move(on_done_);
+      f(cancelled);
+    }
+  }
+
+  void Watch() {
+    uint8_t previous = state_.fetch_or(kWatching, std::memory_order_acq_rel);
+
+    CHECK(!(previous & kWatching))
+        << "more than one callback waiting for call to be done";
 
-  Callback<bool> done_callback_;
-  Callback<bool> finish_callback_;
+    if (previous & kNotified) {
+      // NOTE: see comment in 'NotifyDone()'.
+      auto f = std::move(on_done_);
+      f(previous & kCancelled);
+    }
+  }
+
+  // Aggregates (see 'Aggregate()') and logs (see 'Log()') how long
+  // this call spent in each phase.
+  void Measure() {
+    auto* phases = phases_.load(std::memory_order_acquire);
+
+    if (phases == nullptr && log_ == nullptr) {
+      return;
+    }
+
+    CallPhases::Durations durations = timeline_.Measure();
+
+    if (phases != nullptr) {
+      phases->Record(durations);
+    }
+
+    if (log_ != nullptr) {
+      int64_t nanoseconds[CallPhases::kPhases];
+      for (size_t i = 0; i < CallPhases::kPhases; i++) {
+        nanoseconds[i] = durations[i].count();
+      }
+
+      log_->Log(
+          logging_,
+          CallLog::Phase::Phases,
+          0,
+          std::string_view(
+              reinterpret_cast<const char*>(nanoseconds),
+              sizeof(nanoseconds)));
+    }
+  }
+
+  void Release(bool cancelled) {
+    limit_->Release(std::chrono::steady_clock::now() - admitted_, cancelled);
+  }
 
-  std::function<void(bool)> finish_on_done_;
+  // Only for 'ServerBackend::CompletionQueue'.
+  std::optional<::grpc::GenericServerContext> context_;
+  CompletionQueueServerStream* async_ = nullptr;
 
-  stout::Notification<bool> done_;
+  // Only for 'ServerBackend::Callback'.
+  ::grpc::GenericCallbackServerContext* callback_context_ = nullptr;
+  CallbackServerStream* reactor_ = nullptr;
+
+  std::unique_ptr<ServerStream> stream_;
+
+  std::atomic<uint8_t> state_ = 0;
+
+  Interrupt interrupt_;
+
+  Tag done_;
+  Tag finish_;
+
+  // Invoked once the call is done, see 'OnDone()'.
+  Callback<bool> on_done_;
+
+  // Only valid with 'kAdmitted', see 'Admit()'.
+  ConcurrencyLimit* limit_ = nullptr;
+  std::chrono::steady_clock::time_point admitted_;
+
+  Recorder* recorder_ = nullptr;
+  uint64_t recording_ = 0;
+
+  CallLog* log_ = nullptr;
+  uint64_t logging_ = 0;
+
+  CallPhases::Timeline timeline_;
+
+  // Only set once this call has an endpoint, see 'Aggregate()'.
+  std::atomic<CallPhases::Histograms*> phases_ = nullptr;
 };
 
 ////////////////////////////////////////////////////////////////////////
 
+inline void CallbackServerStream::OnCancel() {
+  context_->NotifyCancelled();
+}
+
+////////////////////////////////////////////////////////////////////////
+
+inline void CallbackServerStream::OnDone() {
+  // NOTE: gRPC only invokes 'OnDone()' once the call has been
+  // finished so unlike the completion queue backend the finish
+  // callback always gets invoked _before_ the done callback.
+  bool cancelled = context_->base()->IsCancelled();
+
+  if (finish_ != nullptr) {
+    (*std::exchange(finish_, nullptr))(true);
+  }
+
+  // NOTE: notifying done might destruct the 'ServerContext', and thus
+  // this reactor, so it must be the last thing we do.
+  context_->NotifyDone(cancelled);
+}
+
+////////////////////////////////////////////////////////////////////////
+
 // 'ServerReader' abstraction acts like the synchronous
 // '::grpc::ServerReader' but instead of a blocking 'Read()' call we
 // return a stream!
@@ -164,34 +723,96 @@ class ServerReader {
     : context_(context) {}
 
   auto Read() {
+    return ReadImpl(/* recycle = */ false);
+  }
+
+  // Like 'Read()' but rather than emitting a new request each time
+  // emits the same request object (as an lvalue) which gets reused,
+  // keeping the capacity of its strings and repeated fields, for the
+  // next request. This avoids allocating for each request of a high
+  // rate stream of similarly shaped requests.
+  //
+  // NOTE: the emitted request is only valid until the next request
+  // gets read so it must be copied (or moved) if it needs to be kept.
+  auto ReadRecycled() {
+    return ReadImpl(/* recycle = */ true);
+  }
+
+  // Like 'Read()' but keeps reading ahead of the consumer into a
+  // buffer bounded by 'options', see 'ReadAhead()'.
+  auto Read(ReadAheadOptions options) {
+    return ReadAhead<RequestType_, ::grpc::ByteBuffer>(
+        options,
+        [this](::grpc::ByteBuffer* buffer, Tag* tag) {
+          context_->stream()->Read(buffer, tag);
+        },
+        [](const ::grpc::ByteBuffer& buffer) {
+          return buffer.Length();
+        },
+        [this](::grpc::ByteBuffer&& buffer) {
+          context_->Record(buffer);
+          context_->Log(CallLog::Phase::Read, buffer);
+          std::optional<RequestType_> request(std::in_place);
+          if (deserialize(&buffer, &request.value())) {
+            EVENTUALS_GRPC_LOG(1)
+                << "Received request for call ("
+                << context_ << ")"
+                << " for host = " << context_->host()
+                << " and path = " << context_->method()
+                << " and request =\n"
+                << request->DebugString();
+          } else {
+            request.reset();
+          }
+          return request;
+        });
+  }
+
+ private:
+  auto ReadImpl(bool recycle) {
     struct Data {
       ServerReader* reader = nullptr;
       ::grpc::ByteBuffer buffer;
+      RequestType_ request;
+      bool recycle = false;
       void* k = nullptr;
     };
     return eventuals::Stream<RequestType_>()
         .next([this,
                data = Data{},
-               callback = Callback<bool>()](auto& k) mutable {
+               tag = Tag(),
+               recycle](auto& k) mutable {
           using K = std::decay_t<decltype(k)>;
 
-          if (!callback) {
+          if (!tag) {
             data.reader = this;
+            data.recycle = recycle;
             data.k = &k;
-            callback = [&data](bool ok) mutable {
-              auto& k = *reinterpret_cast<K*>(data.k);
+            tag = Tag(&data, [](void* d, bool ok) {
+              auto& data = *static_cast<Data*>(d);
+              auto& k = *static_cast<K*>(data.k);
               if (ok) {
-                RequestType_ request;
-                if (deserialize(&data.buffer, &request)) {
+                // NOTE: must record (and log) before deserializing
+                // which consumes the buffer.
+                data.reader->context_->Record(data.buffer);
+                data.reader->context_->Log(CallLog::Phase::Read, data.buffer);
+
+                // NOTE: deserializing clears 'data.request' first but
+                // keeps its capacity (if it wasn't moved out).
+                if (deserialize(&data.buffer, &data.request)) {
                   EVENTUALS_GRPC_LOG(1)
                       << "Received request for call ("
                       << data.reader->context_ << ")"
                       << " for host = " << data.reader->context_->host()
                       << " and path = " << data.reader->context_->method()
                       << " and request =\n"
-                      << request.DebugString();
+                      << data.request.DebugString();
 
-                  k.Emit(std::move(request));
+                  if (data.recycle) {
+                    k.Emit(data.request);
+                  } else {
+                    k.Emit(std::move(data.request));
+                  }
                 } else {
                   k.Fail(std::runtime_error("Failed to deserialize request"));
                 }
@@ -205,14 +826,13 @@ class ServerReader {
                 // Signify end of stream (or error).
                 k.Ended();
               }
-            };
+            });
           }
 
-          context_->stream()->Read(&data.buffer, &callback);
+          context_->stream()->Read(&data.buffer, &tag);
         });
   }
 
- private:
   template <typename T>
   static bool deserialize(::grpc::ByteBuffer* buffer, T* t) {
     auto status = ::grpc::SerializationTraits<T>::Deserialize(
@@ -255,18 +875,20 @@ class ServerWriter {
         .raises<std::runtime_error>()
         .start(
             [this,
-             callback = Callback<bool>(),
+             tag = Tag(),
              response = std::move(response),
              options = std::move(options)](auto& k) mutable {
               ::grpc::ByteBuffer buffer;
               if (serialize(response, &buffer)) {
-                callback = [&k](bool ok) mutable {
+                using K = std::decay_t<decltype(k)>;
+                tag = Tag(&k, [](void* k, bool ok) {
                   if (ok) {
-                    k.Start();
+                    static_cast<K*>(k)->Start();
                   } else {
-                    k.Fail(std::runtime_error("Failed to write"));
+                    static_cast<K*>(k)->Fail(
+                        std::runtime_error("Failed to write"));
                   }
-                };
+                });
 
                 EVENTUALS_GRPC_LOG(1)
                     << "Sending response for call (" << context_ << ")"
@@ -275,7 +897,9 @@ class ServerWriter {
                     << " and response =\n"
                     << response.DebugString();
 
-                context_->stream()->Write(buffer, options, &callback);
+                context_->Log(CallLog::Phase::Write, buffer);
+
+                context_->stream()->Write(buffer, options, &tag);
               } else {
                 k.Fail(std::runtime_error("Failed to serialize response"));
               }
@@ -289,7 +913,7 @@ class ServerWriter {
         .raises<std::runtime_error>()
         .start(
             [this,
-             callback = Callback<bool>(),
+             tag = Tag(),
              response = std::move(response),
              options = std::move(options)](auto& k) mutable {
               ::grpc::ByteBuffer buffer;
@@ -304,8 +928,11 @@ class ServerWriter {
                 // NOTE: 'WriteLast()' will block until calling
                 // 'Finish()' so we start the next continuation and
                 // expect any errors to come from 'Finish()'.
-                callback = [](bool ok) mutable {};
-                context_->stream()->WriteLast(buffer, options, &callback);
+                context_->Mark(CallPhases::WritingLast);
+                context_->Log(CallLog::Phase::Write, buffer);
+
+                tag = Tag(nullptr, [](void*, bool) {});
+                context_->stream()->WriteLast(buffer, options, &tag);
                 k.Start();
               } else {
                 k.Fail(std::runtime_error("Failed to serialize response"));
@@ -313,6 +940,73 @@ class ServerWriter {
             });
   }
 
+  // Writes 'response' and finishes the call with 'status' in a single
+  // batch, i.e., with only one completion queue event rather than one
+  // for 'WriteLast()' and another for 'ServerCall::Finish()'.
+  //
+  // NOTE: if 'response' can't be serialized the call gets finished
+  // with an 'UNKNOWN' status instead, just as it would if the failure
+  // from 'WriteLast()' was caught and passed to 'Finish()'.
+  auto WriteAndFinish(
+      ResponseType_ response,
+      ::grpc::Status status,
+      ::grpc::WriteOptions options = ::grpc::WriteOptions()) {
+    return Eventual<void>()
+        .raises<std::runtime_error>()
+        .start(
+            [this,
+             tag = Tag(),
+             response = std::move(response),
+             status = std::move(status),
+             options = std::move(options)](auto& k) mutable {
+              using K = std::decay_t<decltype(k)>;
+              tag = Tag(&k, [](void* k, bool ok) {
+                if (ok) {
+                  static_cast<K*>(k)->Start();
+                } else {
+                  static_cast<K*>(k)->Fail(
+                      std::runtime_error("failed to finish"));
+                }
+              });
+
+              ::grpc::ByteBuffer buffer;
+              if (serialize(response, &buffer)) {
+                EVENTUALS_GRPC_LOG(1)
+                    << "Sending last response and finishing call ("
+                    << context_ << ")"
+                    << " for host = " << context_->host()
+                    << " and path = " << context_->method()
+                    << " and response =\n"
+                    << response.DebugString();
+
+                context_->Mark(CallPhases::Finishing);
+                context_->Log(CallLog::Phase::Write, buffer);
+                context_->Log(CallLog::Phase::Finish, status.error_code());
+
+                context_->stream()->WriteAndFinish(
+                    buffer,
+                    options,
+                    status,
+                    &tag);
+              } else {
+                EVENTUALS_GRPC_LOG(1)
+                    << "Finishing call (" << context_ << ")"
+                    << " for host = " << context_->host()
+                    << " and path = " << context_->method()
+                    << " after failing to serialize response";
+
+                context_->Mark(CallPhases::Finishing);
+                context_->Log(CallLog::Phase::Finish, ::grpc::UNKNOWN);
+
+                context_->stream()->Finish(
+                    ::grpc::Status(
+                        ::grpc::UNKNOWN,
+                        "Failed to serialize response"),
+                    &tag);
+              }
+            });
+  }
+
  private:
   template <typename T>
   static bool serialize(const T& t, ::grpc::ByteBuffer* buffer) {
@@ -340,6 +1034,40 @@ class ServerWriter {
 
 ////////////////////////////////////////////////////////////////////////
 
+// The context that a generated service passes to each handler, which
+// converts to whichever of the contexts the handler takes: the
+// '::grpc::GenericServerContext*' (and thus a '::grpc::ServerContext*')
+// with 'ServerBackend::CompletionQueue', or the
+// '::grpc::ServerContextBase*' that every backend has.
+//
+// NOTE: there isn't a '::grpc::GenericServerContext' with
+// 'ServerBackend::Callback' (converts to 'nullptr') so handlers of a
+// service served with it need to take a '::grpc::ServerContextBase*'.
+class HandlerContext {
+ public:
+  HandlerContext(
+      ::grpc::GenericServerContext* context,
+      ::grpc::ServerContextBase* base)
+    : context_(context),
+      base_(base) {}
+
+  operator ::grpc::GenericServerContext*() const {
+    return context_;
+  }
+
+  // NOTE: preferred (by overload resolution) for a handler that takes
+  // a '::grpc::ServerContextBase*' since it doesn't need a conversion.
+  operator ::grpc::ServerContextBase*() const {
+    return base_;
+  }
+
+ private:
+  ::grpc::GenericServerContext* context_;
+  ::grpc::ServerContextBase* base_;
+};
+
+////////////////////////////////////////////////////////////////////////
+
 // 'ServerCall' provides reading, writing, and finishing
 // functionality for a gRPC call.
 //
@@ -374,10 +1102,23 @@ class ServerCall {
       reader_(context_.get()),
       writer_(context_.get()) {}
 
+  // NOTE: returns 'nullptr' for 'ServerBackend::Callback', see
+  // 'base()'.
   auto* context() {
     return context_->context();
   }
 
+  // Returns the underlying context regardless of the backend.
+  auto* base() {
+    return context_->base();
+  }
+
+  // Returns what a generated service passes to a handler, see
+  // 'HandlerContext'.
+  HandlerContext handler_context() {
+    return HandlerContext(context(), base());
+  }
+
   auto& Reader() {
     return reader_;
   }
@@ -391,28 +1132,149 @@ class ServerCall {
         .raises<std::runtime_error>()
         .start(
             [this,
-             callback = Callback<bool>(),
+             tag = Tag(),
              status](auto& k, auto&&...) mutable {
-              callback = [&k](bool ok) {
+              using K = std::decay_t<decltype(k)>;
+              tag = Tag(&k, [](void* k, bool ok) {
                 if (ok) {
-                  k.Start();
+                  static_cast<K*>(k)->Start();
                 } else {
-                  k.Fail(std::runtime_error("failed to finish"));
+                  static_cast<K*>(k)->Fail(
+                      std::runtime_error("failed to finish"));
                 }
-              };
+              });
 
               EVENTUALS_GRPC_LOG(1)
                   << "Finishing call (" << context_.get() << ")"
                   << " for host = " << context_->host()
                   << " and path = " << context_->method();
 
+              context_->Mark(CallPhases::Finishing);
+              context_->Log(CallLog::Phase::Finish, status.error_code());
+
               // TODO(benh): why aren't we calling 'FinishThenOnDone()'
               // defind in _our_ 'ServerContext' in order to overcome the
               // deficincies discussed there?
-              context_->stream()->Finish(status, &callback);
+              context_->stream()->Finish(status, &tag);
             });
   }
 
+  // Returns an eventual that runs 'task' with an interrupt that gets
+  // triggered if this call gets cancelled, either by the client or
+  // because the deadline was exceeded, or if the returned eventual
+  // itself gets interrupted.
+  //
+  // A 'task' that stops because it was interrupted gets propagated as
+  // a failure so that 'UnaryEpilogue()' and 'StreamingEpilogue()'
+  // still finish the call.
+  template <typename T>
+  auto Interruptible(Task::Of<T>&& task) {
+    return Eventual<std::decay_t<T>>()
+        .template raises<std::runtime_error>()
+        .context(std::move(task))
+        .start([this](auto& task, auto& k, auto& handler) {
+          if (handler && !handler->Install()) {
+            k.Stop();
+            return;
+          }
+
+          task.Start(
+              context_->interrupt(),
+              [&k](auto&&... value) {
+                k.Start(std::forward<decltype(value)>(value)...);
+              },
+              [&k](std::exception_ptr e) {
+                k.Fail(std::move(e));
+              },
+              [&k, this]() {
+                EVENTUALS_GRPC_LOG(1)
+                    << "Interrupted call (" << context_.get() << ")"
+                    << " for host = " << context_->host()
+                    << " and path = " << context_->method();
+
+                k.Fail(std::runtime_error("Call was interrupted"));
+              });
+        })
+        .interrupt([this](auto&, auto&) {
+          context_->interrupt().Trigger();
+        });
+  }
+
+  // Like 'Interruptible(Task::Of<T>&&)' but for any eventual 'e' that
+  // produces a 'T', which lets 'e' be composed without type erasing
+  // it (and heap allocating it) as a task. This is what statically
+  // dispatched services generated by 'protoc-gen-eventuals' use.
+  template <typename T, typename E>
+  auto Interruptible(E e) {
+    static_assert(!std::is_void_v<T>, "use 'Task::Of<void>' instead");
+
+    // NOTE: 'e' needs to be built before we know the type of 'k' so
+    // we forward to 'k' via function pointers rather than a
+    // 'Callback' in order to avoid any allocations.
+    auto terminal = [](auto* data) {
+      return Terminal()
+          .start([data](auto&&... value) {
+            data->start(data->k, T(std::forward<decltype(value)>(value)...));
+          })
+          .fail([data](auto&&... errors) {
+            data->fail(
+                data->k,
+                ExceptionPtr(std::forward<decltype(errors)>(errors)...));
+          })
+          .stop([data]() {
+            EVENTUALS_GRPC_LOG(1)
+                << "Interrupted call (" << data->context << ")"
+                << " for host = " << data->context->host()
+                << " and path = " << data->context->method();
+
+            data->fail(
+                data->k,
+                std::make_exception_ptr(
+                    std::runtime_error("Call was interrupted")));
+          });
+    };
+
+    struct Data {
+      E e;
+      ServerContext* context = nullptr;
+      void* k = nullptr;
+      void (*start)(void*, T&&) = nullptr;
+      void (*fail)(void*, std::exception_ptr) = nullptr;
+      std::optional<decltype(Build(
+          std::declval<E>() | terminal(std::declval<Data*>())))>
+          adapted;
+    };
+
+    return Eventual<T>()
+        .template raises<std::runtime_error>()
+        .context(Data{std::move(e), context_.get()})
+        .start([terminal](auto& data, auto& k, auto& handler) {
+          using K = std::decay_t<decltype(k)>;
+
+          if (handler && !handler->Install()) {
+            k.Stop();
+            return;
+          }
+
+          data.k = &k;
+
+          data.start = [](void* k, T&& value) {
+            static_cast<K*>(k)->Start(std::move(value));
+          };
+
+          data.fail = [](void* k, std::exception_ptr e) {
+            static_cast<K*>(k)->Fail(std::move(e));
+          };
+
+          data.adapted.emplace(Build(std::move(data.e) | terminal(&data)));
+          data.adapted->Register(data.context->interrupt());
+          data.adapted->Start();
+        })
+        .interrupt([](auto& data, auto&) {
+          data.context->interrupt().Trigger();
+        });
+  }
+
   auto WaitForDone() {
     return Eventual<bool>(
         [this](auto& k, auto&&...) mutable {
@@ -431,15 +1293,54 @@ class ServerCall {
   std::unique_ptr<ServerContext> context_;
   ServerReader<RequestType_> reader_;
   ServerWriter<ResponseType_> writer_;
+
+  static std::exception_ptr ExceptionPtr(std::exception_ptr e) {
+    return e;
+  }
+
+  template <typename Error>
+  static std::exception_ptr ExceptionPtr(Error&& error) {
+    return std::make_exception_ptr(std::forward<Error>(error));
+  }
 };
 
 ////////////////////////////////////////////////////////////////////////
 
 class Endpoint : public Synchronizable {
  public:
-  Endpoint(std::string&& path, std::string&& host)
+  // NOTE: 'phases' (if any) must outlive this endpoint and any of
+  // its calls, see 'ServerContext::Aggregate()'.
+  Endpoint(
+      std::string&& path,
+      std::string&& host,
+      std::optional<ConcurrencyLimit::Options> limit = std::nullopt,
+      CallPhases::Histograms* phases = nullptr)
     : path_(std::move(path)),
-      host_(std::move(host)) {}
+      host_(std::move(host)),
+      limit_(
+          limit
+              ? std::make_unique<ConcurrencyLimit>(limit.value())
+              : nullptr),
+      phases_(phases) {}
+
+  // Returns false if the call should be rejected because this
+  // endpoint is at its concurrency limit and configured to reject
+  // rather than have calls wait.
+  bool Admit(ServerContext* context) {
+    context->Mark(CallPhases::LookedUp);
+
+    if (phases_ != nullptr) {
+      context->Aggregate(phases_);
+    }
+
+    if (limit_ && limit_->options().reject) {
+      if (!limit_->TryAcquire()) {
+        return false;
+      }
+      context->Admit(limit_.get());
+    }
+    return true;
+  }
 
   auto Enqueue(std::unique_ptr<ServerContext>&& context) {
     EVENTUALS_GRPC_LOG(1)
@@ -451,8 +1352,15 @@ class Endpoint : public Synchronizable {
   }
 
   // NOTE: returns a stream rather than a single eventual context.
+  //
+  // If this endpoint has a concurrency limit (and isn't rejecting)
+  // we wait to get the next context until we're below the limit
+  // which leaves any other calls waiting in the pipe.
   auto Dequeue() {
-    return pipe_.Read();
+    return pipe_.Read()
+        | Map([this](auto&& context) {
+             return Admitted(std::move(context));
+           });
   }
 
   auto Shutdown() {
@@ -467,15 +1375,180 @@ class Endpoint : public Synchronizable {
     return host_;
   }
 
+  // Returns 'nullptr' if this endpoint doesn't have a limit.
+  ConcurrencyLimit* limit() {
+    return limit_.get();
+  }
+
  private:
+  auto Admitted(std::unique_ptr<ServerContext>&& context) {
+    return Eventual<std::unique_ptr<ServerContext>>()
+        .context(std::move(context))
+        .start([this](auto& context, auto& k) {
+          if (!limit_ || limit_->options().reject) {
+            context->Mark(CallPhases::Dequeued);
+            k.Start(std::move(context));
+          } else {
+            limit_->Acquire([this, &context, &k]() {
+              context->Admit(limit_.get());
+              context->Mark(CallPhases::Dequeued);
+              k.Start(std::move(context));
+            });
+          }
+        });
+  }
+
   const std::string path_;
   const std::string host_;
 
+  std::unique_ptr<ConcurrencyLimit> limit_;
+
+  CallPhases::Histograms* phases_;
+
   Pipe<std::unique_ptr<ServerContext>> pipe_;
 };
 
 ////////////////////////////////////////////////////////////////////////
 
+// Endpoints keyed by path and host. A 'Server' has one set of
+// endpoints shared by all of its completion queues plus, when built
+// with 'ServerBuilder::SetThreadPerCore()', a set per completion
+// queue, see 'Server::Accept()'.
+class Endpoints : public Synchronizable {
+ public:
+  auto Insert(std::unique_ptr<Endpoint>&& endpoint) {
+    return Synchronized(
+        Eventual<void>()
+            .raises<std::runtime_error>()
+            .start([this, endpoint = std::move(endpoint)](auto& k) mutable {
+              if (frozen()) {
+                k.Fail(std::runtime_error(
+                    "Can't serve " + endpoint->path()
+                    + " for host " + endpoint->host()
+                    + " from frozen endpoints"));
+                return;
+              }
+
+              auto key = std::make_pair(endpoint->path(), endpoint->host());
+
+              auto [_, inserted] =
+                  endpoints_.try_emplace(key, std::move(endpoint));
+
+              if (!inserted) {
+                k.Fail(std::runtime_error(
+                    "Already serving " + endpoint->path()
+                    + " for host " + endpoint->host()));
+              } else {
+                EVENTUALS_GRPC_LOG(1)
+                    << "Serving endpoint"
+                    << " for host = " << key.second
+                    << " and path = " << key.first;
+
+                size_.fetch_add(1, std::memory_order_relaxed);
+
+                k.Start();
+              }
+            }));
+  }
+
+  // Makes these endpoints immutable so that they can be read with
+  // 'Find()' without being synchronized, e.g., by the thread that
+  // owns them when built with 'ServerBuilder::SetThreadPerCore()'.
+  // Any 'Insert()' after this fails.
+  void Freeze() {
+    frozen_.store(true, std::memory_order_release);
+  }
+
+  bool frozen() const {
+    return frozen_.load(std::memory_order_acquire);
+  }
+
+  // Returns true if no endpoint has been inserted, which can be
+  // checked without being synchronized (e.g., to skip a 'Lookup()'
+  // that can't find anything).
+  bool empty() const {
+    return size_.load(std::memory_order_relaxed) == 0;
+  }
+
+  // Returns an eventual that produces the endpoint for the call's
+  // path and host (or any host, i.e., "*"), or 'nullptr' if there
+  // isn't one.
+  auto Lookup(ServerContext* context) {
+    // NOTE: 'context' is stored in a 'Closure()' so safe to capture
+    // as a reference here.
+    return Synchronized(Then([this, context]() {
+      return Find(context->method(), context->host());
+    }));
+  }
+
+  // Like 'Lookup(ServerContext*)' but for an explicit path and host.
+  auto Lookup(std::string path, std::string host) {
+    return Synchronized(
+        Then([this, path = std::move(path), host = std::move(host)]() {
+          return Find(path, host);
+        }));
+  }
+
+  auto Shutdown() {
+    return Synchronized(Then([this]() {
+      return Iterate(endpoints_)
+          | Map([](auto& entry) {
+               auto& [_, endpoint] = entry;
+               return endpoint->Shutdown();
+             })
+          | Loop();
+    }));
+  }
+
+  // Returns the endpoint for 'path' and 'host' (or any host, i.e.,
+  // "*"), or 'nullptr' if there isn't one.
+  //
+  // NOTE: expects to be called while synchronized unless frozen.
+  Endpoint* Find(std::string_view path, std::string_view host) {
+    auto iterator = endpoints_.find(std::make_pair(path, host));
+
+    if (iterator == endpoints_.end()) {
+      iterator = endpoints_.find(std::make_pair(path, std::string_view("*")));
+    }
+
+    return iterator != endpoints_.end() ? iterator->second.get() : nullptr;
+  }
+
+ private:
+  // NOTE: path and host are viewed (rather than copied) for a lookup
+  // via these "transparent" functors, i.e., heterogeneous lookup.
+  using View = std::pair<std::string_view, std::string_view>;
+
+  struct Hash {
+    using is_transparent = void;
+
+    size_t operator()(const View& key) const {
+      return absl::Hash<View>()(key);
+    }
+  };
+
+  struct Equal {
+    using is_transparent = void;
+
+    bool operator()(const View& lhs, const View& rhs) const {
+      return lhs == rhs;
+    }
+  };
+
+  absl::flat_hash_map<
+      std::pair<std::string, std::string>,
+      std::unique_ptr<Endpoint>,
+      Hash,
+      Equal>
+      endpoints_;
+
+  std::atomic<size_t> size_ = 0;
+
+  std::atomic<bool> frozen_ = false;
+};
+
+////////////////////////////////////////////////////////////////////////
+
 class ServerStatus {
  public:
   static ServerStatus Ok() {
@@ -512,38 +1585,119 @@ class Server : public Synchronizable {
 
   void Wait();
 
+  // NOTE: a 'limit' set via 'ServerBuilder::SetConcurrencyLimit()'
+  // for the same method takes precedence over the one passed here.
   template <typename Service, typename Request, typename Response>
-  auto Accept(std::string name, std::string host = "*");
+  auto Accept(
+      std::string name,
+      std::string host = "*",
+      std::optional<ConcurrencyLimit::Options> limit = std::nullopt);
 
   template <typename Request, typename Response>
-  auto Accept(std::string name, std::string host = "*");
+  auto Accept(
+      std::string name,
+      std::string host = "*",
+      std::optional<ConcurrencyLimit::Options> limit = std::nullopt);
+
+  // Returns how long calls to each endpoint (i.e., each path and host
+  // that has been accepted) have spent in each phase, see
+  // 'CallPhases'.
+  std::vector<EndpointPhases> Phases();
+
+  // NOTE: one 'Poller' per completion queue which can be used to
+  // register maintenance if the server was built with a tick, see
+  // 'ServerBuilder::SetCompletionQueueTick()'.
+  const std::vector<std::unique_ptr<Poller>>& pollers() {
+    return pollers_;
+  }
 
  private:
   friend class ServerBuilder;
 
+  // Implements 'ServerBackend::Callback', see server.cc.
+  class CallbackService;
+
   Server(
       std::vector<Service*>&& services,
       std::unique_ptr<::grpc::AsyncGenericService>&& service,
+      std::unique_ptr<CallbackService>&& callbackService,
       std::unique_ptr<::grpc::Server>&& server,
       std::vector<std::unique_ptr<::grpc::ServerCompletionQueue>>&& cqs,
-      std::vector<std::thread>&& threads);
+      std::vector<std::unique_ptr<Poller>>&& pollers,
+      std::vector<std::thread>&& threads,
+      absl::flat_hash_map<
+          std::string,
+          ConcurrencyLimit::Options>&& limits,
+      std::unique_ptr<Recorder>&& recorder,
+      std::unique_ptr<CallLog>&& log,
+      bool threadPerCore);
 
   template <typename Request, typename Response>
   auto Validate(const std::string& name);
 
-  auto Insert(std::unique_ptr<Endpoint>&& endpoint);
-
   auto ShutdownEndpoints();
 
+  // Returns the endpoints that 'Accept()' should insert into, i.e.,
+  // those of the completion queue being polled by the current thread
+  // when built with 'ServerBuilder::SetThreadPerCore()' while the
+  // server is starting, otherwise those shared by all completion
+  // queues.
+  Endpoints* CurrentEndpoints();
+
   auto RequestCall(ServerContext* context, ::grpc::ServerCompletionQueue* cq);
 
-  auto Lookup(ServerContext* context);
+  // Looks up the endpoint for a call first in 'shard' (if any),
+  // which must be frozen and is read without being synchronized, and
+  // then (if there are any) in the endpoints shared by all completion
+  // queues.
+  auto Lookup(ServerContext* context, Endpoints* shard = nullptr);
+
+  auto Reject(ServerContext* context, Endpoint* endpoint);
+
+  // Looks up the endpoint for a call from 'ServerBackend::Callback'
+  // and either enqueues or rejects it, without blocking the calling
+  // thread (which is one of gRPC's).
+  void Dispatch(std::unique_ptr<ServerContext>&& context);
+
+  // Marks the call as accepted, records it if built with
+  // 'ServerBuilder::SetRecording()', and logs it if built with
+  // 'ServerBuilder::SetCallLog()'.
+  void Record(ServerContext* context) {
+    context->Mark(CallPhases::Accepted);
+    if (recorder_) {
+      context->Record(recorder_.get());
+    }
+    if (log_) {
+      context->Log(log_.get());
+    }
+  }
 
-  auto Unimplemented(ServerContext* context);
+  // Returns the histograms for calls to 'path' and 'host' which are
+  // shared by all endpoints for them, i.e., by the endpoint of each
+  // completion queue when built with 'ServerBuilder::SetThreadPerCore()'.
+  CallPhases::Histograms* Histograms(
+      const std::string& path,
+      const std::string& host);
 
+  // NOTE: declared first so that they get destructed last, i.e.,
+  // after any calls that might still be recording, logging, or
+  // aggregating their phases.
+  std::unique_ptr<Recorder> recorder_;
+  std::unique_ptr<CallLog> log_;
+
+  std::mutex phases_mutex_;
+  absl::flat_hash_map<
+      std::pair<std::string, std::string>,
+      std::unique_ptr<CallPhases::Histograms>>
+      phases_;
+
+  // NOTE: only one of 'service_' or 'callback_service_' is set
+  // depending on the backend.
   std::unique_ptr<::grpc::AsyncGenericService> service_;
+  std::unique_ptr<CallbackService> callback_service_;
   std::unique_ptr<::grpc::Server> server_;
   std::vector<std::unique_ptr<::grpc::ServerCompletionQueue>> cqs_;
+  std::vector<std::unique_ptr<Poller>> pollers_;
   std::vector<std::thread> threads_;
 
   struct Serve {
@@ -551,6 +1705,16 @@ class Server : public Synchronizable {
     Interrupt interrupt;
     std::optional<Task::Of<void>> task;
     std::atomic<bool> done = false;
+
+    // Only for 'ServerBuilder::SetThreadPerCore()', used to start
+    // 'task' from the thread polling the completion queue.
+    //
+    // NOTE: 'start' just invokes 'started' as this only happens once
+    // per service when the server starts so there's no need to avoid
+    // the type-erased 'Callback<bool>'.
+    std::optional<::grpc::Alarm> alarm;
+    Tag start;
+    Callback<bool> started;
   };
 
   std::vector<std::unique_ptr<Serve>> serves_;
@@ -563,10 +1727,16 @@ class Server : public Synchronizable {
 
   std::vector<std::unique_ptr<Worker>> workers_;
 
-  absl::flat_hash_map<
-      std::pair<std::string, std::string>,
-      std::unique_ptr<Endpoint>>
-      endpoints_;
+  // Concurrency limits keyed by fully qualified method name.
+  absl::flat_hash_map<std::string, ConcurrencyLimit::Options> limits_;
+
+  Endpoints endpoints_;
+
+  // One per completion queue (in the same order as 'cqs_') when
+  // built with 'ServerBuilder::SetThreadPerCore()', otherwise empty.
+  // Each gets frozen once every service has started, before any call
+  // is requested, so that looking up a call never synchronizes.
+  std::vector<std::unique_ptr<Endpoints>> shards_;
 };
 
 ////////////////////////////////////////////////////////////////////////
@@ -585,6 +1755,37 @@ class ServerBuilder {
   // TODO(benh): Provide a 'setMaximumThreadsPerCompletionQueue' as well.
   ServerBuilder& SetMinimumThreadsPerCompletionQueue(size_t n);
 
+  // Poll each completion queue with 'AsyncNext()' waking up at least
+  // every 'tick' so that maintenance can be run, see 'Poller'.
+  ServerBuilder& SetCompletionQueueTick(std::chrono::nanoseconds tick);
+
+  // Defaults to 'ServerBackend::CompletionQueue'.
+  //
+  // NOTE: none of the completion queue options above can be used
+  // with 'ServerBackend::Callback'.
+  ServerBuilder& SetBackend(ServerBackend backend);
+
+  // Runs the server "shared-nothing" with one thread per completion
+  // queue (and by default one completion queue per core) where each
+  // thread is pinned to a core (best effort). Services get served
+  // once per completion queue, from the thread polling it, so every
+  // call is accepted, handled, and finished on the same thread
+  // without going through any endpoints shared with other threads.
+  //
+  // NOTE: endpoints accepted via 'Server::Accept()' from any other
+  // thread, or after the server has started, are still shared by all
+  // completion queues (and the shared endpoints only get looked up,
+  // with synchronization, for calls that aren't served by the
+  // completion queue's own endpoints).
+  ServerBuilder& SetThreadPerCore();
+
+  // Limits how many calls to the fully qualified method 'name', e.g.,
+  // "helloworld.Greeter.SayHello", get handled concurrently. Takes
+  // precedence over any limit set by a 'Service' or via 'Accept()'.
+  ServerBuilder& SetConcurrencyLimit(
+      const std::string& name,
+      ConcurrencyLimit::Options options);
+
   ServerBuilder& AddListeningPort(
       const std::string& address,
       std::shared_ptr<::grpc::ServerCredentials> credentials,
@@ -592,14 +1793,38 @@ class ServerBuilder {
 
   ServerBuilder& RegisterService(Service* service);
 
+  // Records every call (when it was received, its method and host)
+  // and each of its requests (as serialized) to the file at 'path'
+  // so that the calls can be replayed later, e.g., with
+  // '//benchmarks:replay'. See 'Recording' for the format.
+  //
+  // NOTE: recording costs a copy of each request and a lock.
+  ServerBuilder& SetRecording(const std::string& path);
+
+  // Logs the lifecycle of every call (when it was accepted, each
+  // message read and written, when it was finished, cancelled, and
+  // done) to a memory mapped ring buffer at 'path', see 'CallLog' for
+  // the format and '//benchmarks:decode-call-log' for reading it.
+  //
+  // NOTE: unlike recording, logging is cheap enough to leave on.
+  ServerBuilder& SetCallLog(
+      const std::string& path,
+      CallLogOptions options = CallLogOptions());
+
   ServerStatusOrServer BuildAndStart();
 
  private:
   ServerStatus status_ = ServerStatus::Ok();
   std::optional<size_t> numberOfCompletionQueues_;
   std::optional<size_t> minimumThreadsPerCompletionQueue_;
+  std::optional<std::chrono::nanoseconds> completionQueueTick_;
+  std::optional<ServerBackend> backend_;
+  bool threadPerCore_ = false;
+  std::optional<std::string> recording_;
+  std::optional<std::pair<std::string, CallLogOptions>> log_;
   std::vector<std::string> addresses_;
   std::vector<Service*> services_;
+  absl::flat_hash_map<std::string, ConcurrencyLimit::Options> limits_;
 
   ::grpc::ServerBuilder builder_;
 };
@@ -631,61 +1856,57 @@ auto Server::Validate(const std::string& name) {
 
 ////////////////////////////////////////////////////////////////////////
 
-inline auto Server::Insert(std::unique_ptr<Endpoint>&& endpoint) {
-  return Synchronized(
-      Eventual<void>()
-          .raises<std::runtime_error>()
-          .start([this, endpoint = std::move(endpoint)](auto& k) mutable {
-            auto key = std::make_pair(endpoint->path(), endpoint->host());
-
-            auto [_, inserted] =
-                endpoints_.try_emplace(key, std::move(endpoint));
-
-            if (!inserted) {
-              k.Fail(std::runtime_error(
-                  "Already serving " + endpoint->path()
-                  + " for host " + endpoint->host()));
-            } else {
-              EVENTUALS_GRPC_LOG(1)
-                  << "Serving endpoint"
-                  << " for host = " << key.second
-                  << " and path = " << key.first;
-
-              k.Start();
-            }
-          }));
+inline auto Server::ShutdownEndpoints() {
+  return endpoints_.Shutdown()
+      | Then([this]() {
+           return Iterate(shards_)
+               | Map([](auto& shard) {
+                    return shard->Shutdown();
+                  })
+               | Loop();
+         });
 }
 
 ////////////////////////////////////////////////////////////////////////
 
-inline auto Server::ShutdownEndpoints() {
-  return Synchronized(Then([this]() {
-    return Iterate(endpoints_)
-        | Map([](auto& entry) {
-             auto& [_, endpoint] = entry;
-             return endpoint->Shutdown();
-           })
-        | Loop();
-  }));
+inline Endpoints* Server::CurrentEndpoints() {
+  // NOTE: 'shards_' and 'pollers_' are only written during
+  // construction so it's safe to read them without synchronization.
+  if (!shards_.empty()) {
+    Poller* poller = Poller::Current();
+    for (size_t i = 0; i < pollers_.size(); i++) {
+      if (pollers_[i].get() == poller && !shards_[i]->frozen()) {
+        return shards_[i].get();
+      }
+    }
+  }
+  return &endpoints_;
 }
 
 ////////////////////////////////////////////////////////////////////////
 
 template <typename Service, typename Request, typename Response>
-auto Server::Accept(std::string name, std::string host) {
+auto Server::Accept(
+    std::string name,
+    std::string host,
+    std::optional<ConcurrencyLimit::Options> limit) {
   static_assert(
       IsService<Service>::value,
       "expecting \"Service\" type to be a protobuf 'Service'");
 
   return Accept<Request, Response>(
       std::string(Service::service_full_name()) + "." + name,
-      std::move(host));
+      std::move(host),
+      std::move(limit));
 }
 
 ////////////////////////////////////////////////////////////////////////
 
 template <typename Request, typename Response>
-auto Server::Accept(std::string name, std::string host) {
+auto Server::Accept(
+    std::string name,
+    std::string host,
+    std::optional<ConcurrencyLimit::Options> limit) {
   static_assert(
       IsMessage<Request>::value,
       "expecting \"request\" type to be a protobuf 'Message'");
@@ -698,7 +1919,20 @@ auto Server::Accept(std::string name, std::string host) {
   size_t index = path.find_last_of(".");
   path.replace(index, 1, "/");
 
-  auto endpoint = std::make_unique<Endpoint>(std::move(path), std::move(host));
+  // NOTE: 'limits_' is only written during construction so it's
+  // safe to read without synchronization.
+  auto iterator = limits_.find(name);
+  if (iterator != limits_.end()) {
+    limit = iterator->second;
+  }
+
+  auto* phases = Histograms(path, host);
+
+  auto endpoint = std::make_unique<Endpoint>(
+      std::move(path),
+      std::move(host),
+      std::move(limit),
+      phases);
 
   // NOTE: we need a generic/untyped "server context" object to be
   // able to store generic/untyped "endpoints" but we want to expose
@@ -710,13 +1944,47 @@ auto Server::Accept(std::string name, std::string host) {
   // 'Insert()' fails so we won't be using a dangling pointer.
   auto Dequeue = [endpoint = endpoint.get()]() {
     return endpoint->Dequeue()
+        | Filter([](auto& context) {
+             // Drop calls that the client has already abandoned while
+             // they were waiting to be dequeued rather than wasting
+             // any time handling them.
+             bool cancelled = context->Cancelled();
+             if (cancelled || context->DeadlineExceeded()) {
+               EVENTUALS_GRPC_LOG(1)
+                   << "Dropping " << (cancelled ? "cancelled" : "expired")
+                   << " call (" << context.get() << ")"
+                   << " for host = " << context->host()
+                   << " and path = " << context->method();
+
+               auto status = cancelled
+                   ? ::grpc::Status::CANCELLED
+                   : ::grpc::Status(
+                       ::grpc::DEADLINE_EXCEEDED,
+                       "Deadline exceeded before call was handled");
+
+               auto* dropped = context.release();
+
+               dropped->FinishThenOnDone(status, [dropped](bool) {
+                 delete dropped;
+               });
+
+               return false;
+             }
+             return true;
+           })
         | Map([](auto&& context) {
              return ServerCall<Request, Response>(std::move(context));
            });
   };
 
+  // NOTE: we pick which endpoints to insert into when the insert
+  // runs, not now, because something asynchronous might happen first
+  // so that we're no longer on the thread we've been composed on or
+  // that thread's endpoints have since been frozen.
   return Validate<Request, Response>(name)
-      | Insert(std::move(endpoint))
+      | Then([this, endpoint = std::move(endpoint)]() mutable {
+           return CurrentEndpoints()->Insert(std::move(endpoint));
+         })
       | Dequeue();
 }
 
@@ -733,27 +2001,48 @@ auto UnaryPrologue(ServerCall<Request, Response>& call) {
 
 // Helper that does the writing and finishing for a unary call as well
 // as catching failures and handling appropriately.
+//
+// NOTE: the response is held until we know the call succeeded so
+// that it can be written and the call finished in a single batch via
+// 'ServerWriter::WriteAndFinish()'.
 template <typename Request, typename Response>
 auto UnaryEpilogue(ServerCall<Request, Response>& call) {
-  return Then([&](auto&& response) {
-           return call.Writer().WriteLast(
-               std::forward<decltype(response)>(response));
-         })
-      | Just(::grpc::Status::OK)
-      | Catch()
-            .raised<std::exception>([](std::exception&& e) {
-              return ::grpc::Status(::grpc::UNKNOWN, e.what());
-            })
-      | Then([&](auto&& status) {
-           return call.Finish(status)
-               | call.WaitForDone();
-         });
+  using ResponseType = typename ServerCall<Request, Response>::ResponseType_;
+  return Closure([&call, response = std::optional<ResponseType>()]() mutable {
+    return Then([&](auto&& value) {
+             response.emplace(std::forward<decltype(value)>(value));
+           })
+        | Just(::grpc::Status::OK)
+        | Catch()
+              .raised<std::exception>([](std::exception&& e) {
+                return ::grpc::Status(::grpc::UNKNOWN, e.what());
+              })
+        | Conditional(
+               [&](auto& status) {
+                 return response.has_value();
+               },
+               [&](auto&& status) {
+                 return call.Writer().WriteAndFinish(
+                     std::move(response.value()),
+                     status);
+               },
+               [&](auto&& status) {
+                 return call.Finish(status);
+               })
+        | call.WaitForDone();
+  });
 }
 
 ////////////////////////////////////////////////////////////////////////
 
 // Helper that does the writing and finishing for a server streaming
 // call as well as catching failures and handling appropriately.
+//
+// NOTE: unlike 'UnaryEpilogue()' each response gets written as soon
+// as it's produced (rather than holding on to it to write it and
+// finish in a single batch) as a stream might produce its next
+// response much later (or never, e.g., a watch), and any responses
+// produced before a failure still get written before finishing.
 template <typename Request, typename Response>
 auto StreamingEpilogue(ServerCall<Request, Response>& call) {
   return Map([&](auto&& response) {
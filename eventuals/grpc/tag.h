@@ -0,0 +1,62 @@
+#pragma once
+
+#include "glog/logging.h"
+
+////////////////////////////////////////////////////////////////////////
+
+namespace eventuals {
+namespace grpc {
+
+////////////////////////////////////////////////////////////////////////
+
+// 'Tag' is what we use as the "tag" for every operation on a
+// completion queue (and for every operation on a 'ServerStream' or
+// 'CallbackClientStream'), i.e., it gets invoked with 'ok' once the
+// operation completes, see 'Poller'.
+//
+// A 'Tag' is just a function pointer and a pointer to whatever data
+// the function needs (usually the continuation), both stored in place
+// by whoever is waiting for the operation, so setting one up never
+// allocates and invoking one is a single indirect call (vs a
+// type-erased 'Callback<bool>').
+//
+// Since the function must be a plain function pointer it can be
+// written as a lambda without any captures:
+//
+//   using K = std::decay_t<decltype(k)>;
+//   tag = Tag(&k, [](void* k, bool ok) {
+//     static_cast<K*>(k)->Start();
+//   });
+//
+// NOTE: just like a 'Callback<bool>' that was used as a tag a 'Tag'
+// and its data must not be moved or destructed until it has been
+// invoked.
+class Tag {
+ public:
+  using Function = void (*)(void* data, bool ok);
+
+  Tag() = default;
+
+  Tag(void* data, Function function)
+    : data_(data),
+      function_(CHECK_NOTNULL(function)) {}
+
+  void operator()(bool ok) {
+    function_(data_, ok);
+  }
+
+  explicit operator bool() const {
+    return function_ != nullptr;
+  }
+
+ private:
+  void* data_ = nullptr;
+  Function function_ = nullptr;
+};
+
+////////////////////////////////////////////////////////////////////////
+
+} // namespace grpc
+} // namespace eventuals
+
+////////////////////////////////////////////////////////////////////////
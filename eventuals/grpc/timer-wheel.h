@@ -0,0 +1,290 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+#include "eventuals/callback.h"
+#include "glog/logging.h"
+
+////////////////////////////////////////////////////////////////////////
+
+namespace eventuals {
+namespace grpc {
+
+////////////////////////////////////////////////////////////////////////
+
+// Hierarchical timer wheel (a la Varghese and Lauck) with constant
+// time insert and cancel. Each 'Poller' owns a 'TimerWheel' that it
+// advances every time it polls so that timers fire on the same thread
+// as the rest of the completion queue's events.
+//
+// Timers are stored intrusively, i.e., the caller owns each 'Entry'
+// and must keep it alive (and not move it) until it has either fired
+// or been cancelled.
+class TimerWheel {
+ public:
+  // NOTE: a monotonic clock so that timers neither fire early nor
+  // stall when the wall clock gets adjusted.
+  using Clock = std::chrono::steady_clock;
+
+  using TimePoint = std::chrono::time_point<Clock, std::chrono::nanoseconds>;
+
+  class Entry;
+
+  TimerWheel(std::chrono::nanoseconds resolution)
+    : resolution_(resolution) {
+    CHECK(resolution_.count() > 0) << "resolution must be positive";
+
+    for (auto& level : slots_) {
+      for (auto& slot : level) {
+        slot.prev = &slot;
+        slot.next = &slot;
+      }
+    }
+
+    current_ = Ticks(Clock::now());
+  }
+
+  TimerWheel(const TimerWheel&) = delete;
+
+  ~TimerWheel() {
+    // NOTE: any timers still pending will never fire, just like any
+    // other outstanding events on a completion queue that has been
+    // shutdown, but we unlink them so their entries can be destructed.
+    for (auto& level : slots_) {
+      for (auto& slot : level) {
+        while (slot.next != &slot) {
+          Remove(static_cast<Entry*>(slot.next));
+        }
+      }
+    }
+  }
+
+  std::chrono::nanoseconds resolution() const {
+    return resolution_;
+  }
+
+  size_t size() {
+    std::scoped_lock lock(mutex_);
+    return size_;
+  }
+
+  // Schedules 'callback' to be invoked from 'Advance()' once
+  // 'deadline' has passed (rounded up to the wheel's resolution).
+  void Insert(Entry* entry, TimePoint deadline, Callback<>&& callback);
+
+  // Returns true if 'entry' was cancelled before it fired, in which
+  // case its callback will never be invoked.
+  bool Cancel(Entry* entry);
+
+  // Fires every timer whose deadline is at or before 'now'.
+  //
+  // NOTE: callbacks are invoked without holding any locks so they
+  // may insert or cancel timers. If another thread is already
+  // advancing the wheel this is a no-op.
+  void Advance(TimePoint now);
+
+ private:
+  struct Link {
+    Link* prev = nullptr;
+    Link* next = nullptr;
+  };
+
+ public:
+  class Entry : private Link {
+   public:
+    Entry() = default;
+
+    // NOTE: only an entry that isn't pending can be moved which lets
+    // an 'Entry' be used as the context of an eventual.
+    Entry(Entry&& that)
+      : callback_(std::move(that.callback_)) {
+      CHECK(!that.pending()) << "moving a pending timer";
+    }
+
+    ~Entry() {
+      CHECK(!pending()) << "destructing a pending timer";
+    }
+
+    bool pending() const {
+      return next != nullptr;
+    }
+
+   private:
+    friend class TimerWheel;
+
+    uint64_t expiry_ = 0;
+    Callback<> callback_;
+  };
+
+ private:
+  static constexpr size_t kLevels = 4;
+  static constexpr size_t kBits = 6;
+  static constexpr size_t kSlots = 1 << kBits;
+  static constexpr uint64_t kMask = kSlots - 1;
+
+  // Largest number of ticks in the future that can be placed without
+  // needing to be re-cascaded from the last level.
+  static constexpr uint64_t kSpan = (uint64_t(1) << (kBits * kLevels)) - 1;
+
+  uint64_t Ticks(TimePoint time) const {
+    return time.time_since_epoch() / resolution_;
+  }
+
+  static void Append(Link* slot, Entry* entry) {
+    entry->prev = slot->prev;
+    entry->next = slot;
+    slot->prev->next = entry;
+    slot->prev = entry;
+  }
+
+  static void Remove(Entry* entry) {
+    entry->prev->next = entry->next;
+    entry->next->prev = entry->prev;
+    entry->prev = nullptr;
+    entry->next = nullptr;
+  }
+
+  // Puts 'entry' in the slot determined by how far in the future it
+  // expires relative to 'current_'.
+  void Place(Entry* entry) {
+    uint64_t expiry = std::max(entry->expiry_, current_);
+    uint64_t delta = expiry - current_;
+
+    for (size_t level = 0; level < kLevels; level++) {
+      if (delta < (uint64_t(1) << (kBits * (level + 1)))) {
+        Append(&slots_[level][(expiry >> (kBits * level)) & kMask], entry);
+        return;
+      }
+    }
+
+    // Too far in the future, put it in the last slot it can be in and
+    // it will get re-placed when it gets cascaded.
+    expiry = current_ + kSpan;
+    Append(
+        &slots_[kLevels - 1][(expiry >> (kBits * (kLevels - 1))) & kMask],
+        entry);
+  }
+
+  // Re-places every entry in the specified slot, moving them closer
+  // to level 0. Returns the index of the slot.
+  size_t Cascade(size_t level) {
+    size_t index = (current_ >> (kBits * level)) & kMask;
+
+    Link* slot = &slots_[level][index];
+
+    while (slot->next != slot) {
+      auto* entry = static_cast<Entry*>(slot->next);
+      Remove(entry);
+      Place(entry);
+    }
+
+    return index;
+  }
+
+  const std::chrono::nanoseconds resolution_;
+
+  std::mutex mutex_;
+
+  // Next tick to be processed.
+  uint64_t current_ = 0;
+
+  size_t size_ = 0;
+
+  bool advancing_ = false;
+
+  Link slots_[kLevels][kSlots];
+};
+
+////////////////////////////////////////////////////////////////////////
+
+inline void TimerWheel::Insert(
+    Entry* entry,
+    TimePoint deadline,
+    Callback<>&& callback) {
+  CHECK(!entry->pending()) << "inserting a pending timer";
+
+  // Round up so that we never fire early.
+  entry->expiry_ = Ticks(deadline + resolution_ - std::chrono::nanoseconds(1));
+  entry->callback_ = std::move(callback);
+
+  std::scoped_lock lock(mutex_);
+  Place(entry);
+  size_++;
+}
+
+////////////////////////////////////////////////////////////////////////
+
+inline bool TimerWheel::Cancel(Entry* entry) {
+  std::scoped_lock lock(mutex_);
+
+  if (!entry->pending()) {
+    return false;
+  }
+
+  Remove(entry);
+  size_--;
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////
+
+inline void TimerWheel::Advance(TimePoint now) {
+  uint64_t ticks = Ticks(now);
+
+  std::unique_lock lock(mutex_);
+
+  if (advancing_) {
+    return;
+  }
+
+  advancing_ = true;
+
+  while (current_ <= ticks) {
+    // Fast path when there is nothing to fire.
+    if (size_ == 0) {
+      current_ = ticks + 1;
+      break;
+    }
+
+    size_t index = current_ & kMask;
+
+    if (index == 0) {
+      for (size_t level = 1; level < kLevels; level++) {
+        if (Cascade(level) != 0) {
+          break;
+        }
+      }
+    }
+
+    current_++;
+
+    Link* slot = &slots_[0][index];
+
+    while (slot->next != slot) {
+      auto* entry = static_cast<Entry*>(slot->next);
+      Remove(entry);
+      size_--;
+
+      // NOTE: after unlinking the entry's owner may destruct it as
+      // soon as we release the lock so we move the callback out.
+      Callback<> callback = std::move(entry->callback_);
+
+      lock.unlock();
+      callback();
+      lock.lock();
+    }
+  }
+
+  advancing_ = false;
+}
+
+////////////////////////////////////////////////////////////////////////
+
+} // namespace grpc
+} // namespace eventuals
+
+////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+
+#include "eventuals/eventual.h"
+#include "eventuals/grpc/poller.h"
+#include "eventuals/grpc/timer-wheel.h"
+
+////////////////////////////////////////////////////////////////////////
+
+namespace eventuals {
+namespace grpc {
+
+////////////////////////////////////////////////////////////////////////
+
+// Returns an eventual that completes once 'duration' has elapsed.
+//
+// The timer gets inserted into the 'TimerWheel' of the 'Poller'
+// running on the current thread, i.e., it fires on a thread polling
+// the same completion queue as the call that started it rather than
+// on some separate timer thread. Interrupting the eventual cancels
+// the timer.
+//
+// NOTE: fails unless started from a thread polling a completion
+// queue with a tick, see 'Poller' and
+// 'ServerBuilder::SetCompletionQueueTick()'.
+inline auto Timer(std::chrono::nanoseconds duration) {
+  // NOTE: 'timers' and 'interrupted' get handed off between the
+  // thread that starts the timer and the thread that interrupts it.
+  struct Data {
+    Data() = default;
+
+    // NOTE: only ever moved before being started.
+    Data(Data&&) {}
+
+    std::atomic<TimerWheel*> timers = nullptr;
+    std::atomic<bool> interrupted = false;
+    TimerWheel::Entry entry;
+  };
+
+  return Eventual<void>()
+      .raises<std::runtime_error>()
+      .context(Data())
+      .start([duration](auto& data, auto& k, auto& handler) {
+        auto* poller = Poller::Current();
+
+        if (poller == nullptr || !poller->tick()) {
+          k.Fail(std::runtime_error(
+              "Timer must be started from a completion queue "
+              "that is polled with a tick"));
+          return;
+        }
+
+        if (handler && !handler->Install()) {
+          k.Stop();
+          return;
+        }
+
+        auto* timers = &poller->timers();
+
+        timers->Insert(
+            &data.entry,
+            TimerWheel::Clock::now() + duration,
+            [&k]() {
+              k.Start();
+            });
+
+        data.timers.store(timers);
+
+        // NOTE: an interrupt that happened before we stored 'timers'
+        // couldn't cancel the timer so we do it for them. At most one
+        // of us can successfully cancel it (and stop the continuation)
+        // and if neither does then the timer has fired.
+        if (data.interrupted.load() && timers->Cancel(&data.entry)) {
+          k.Stop();
+        }
+      })
+      .interrupt([](auto& data, auto& k) {
+        data.interrupted.store(true);
+
+        // NOTE: if we fail to cancel then the timer has already
+        // fired (or is about to), or hasn't been inserted yet and
+        // will be cancelled once it has been (see above).
+        auto* timers = data.timers.load();
+        if (timers != nullptr && timers->Cancel(&data.entry)) {
+          k.Stop();
+        }
+      });
+}
+
+////////////////////////////////////////////////////////////////////////
+
+} // namespace grpc
+} // namespace eventuals
+
+////////////////////////////////////////////////////////////////////////
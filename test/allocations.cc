@@ -0,0 +1,464 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "eventuals/closure.h"
+#include "eventuals/grpc/client.h"
+#include "eventuals/grpc/server.h"
+#include "eventuals/iterate.h"
+#include "eventuals/let.h"
+#include "eventuals/loop.h"
+#include "eventuals/map.h"
+#include "eventuals/terminal.h"
+#include "eventuals/then.h"
+#include "examples/protos/helloworld.grpc.pb.h"
+#include "examples/protos/keyvaluestore.grpc.pb.h"
+#include "examples/protos/route_guide.grpc.pb.h"
+#include "gtest/gtest.h"
+#include "test/test.h"
+
+using helloworld::Greeter;
+using helloworld::HelloReply;
+using helloworld::HelloRequest;
+
+using routeguide::Feature;
+using routeguide::Point;
+using routeguide::Rectangle;
+using routeguide::RouteSummary;
+
+using stout::Borrowable;
+
+using eventuals::Closure;
+using eventuals::Iterate;
+using eventuals::Let;
+using eventuals::Loop;
+using eventuals::Map;
+using eventuals::Terminate;
+using eventuals::Then;
+
+using eventuals::grpc::Client;
+using eventuals::grpc::CompletionPool;
+using eventuals::grpc::Server;
+using eventuals::grpc::ServerBuilder;
+using eventuals::grpc::Stream;
+
+////////////////////////////////////////////////////////////////////////
+
+// Tests that fail if a call of each kind (unary, client streaming,
+// server streaming, and bidirectional streaming) does more heap
+// allocations, or allocates more bytes, than its budget.
+//
+// Allocations are counted by replacing the global 'operator new' (all
+// of the replaceable overloads, including the aligned ones) for this
+// test binary (which is why these tests aren't part of
+// '//test:grpc') so they include everything allocated by the client
+// and the server (which run in the same process) in C++ but not what
+// the grpc core library allocates with 'gpr_malloc()'.
+//
+// NOTE: if a change lowers the allocations of a call lower its budget
+// too so that they can't silently creep back up; only raise a budget
+// if the extra allocations are intended (and say why in the commit).
+
+////////////////////////////////////////////////////////////////////////
+
+struct Budget {
+  size_t allocations;
+  size_t bytes;
+};
+
+// NOTE: these are provisional upper bounds, not measurements. Each
+// test records (as the 'allocations_per_call' and 'bytes_per_call'
+// properties in its XML output) what it measured; replace each budget
+// with its measured numbers plus about 10% of headroom.
+static constexpr Budget kUnaryBudget{100, 16 * 1024};
+static constexpr Budget kClientStreamingBudget{150, 24 * 1024};
+static constexpr Budget kServerStreamingBudget{150, 24 * 1024};
+static constexpr Budget kBidiStreamingBudget{200, 32 * 1024};
+
+// Number of messages sent in each streaming direction of a call.
+static constexpr size_t kMessages = 4;
+
+////////////////////////////////////////////////////////////////////////
+
+static std::atomic<size_t> allocations = 0;
+static std::atomic<size_t> allocated = 0;
+
+static void* Allocate(size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  allocated.fetch_add(size, std::memory_order_relaxed);
+  // NOTE: 'malloc(0)' may return 'nullptr' but 'new' must not.
+  if (void* p = std::malloc(size == 0 ? 1 : size)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+// NOTE: 'aligned_alloc()' requires 'size' to be a multiple of
+// 'alignment'.
+static void* Allocate(size_t size, std::align_val_t alignment) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  allocated.fetch_add(size, std::memory_order_relaxed);
+  size_t align = static_cast<size_t>(alignment);
+  size = (std::max<size_t>(size, 1) + align - 1) / align * align;
+  if (void* p = std::aligned_alloc(align, size)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void* operator new(size_t size) {
+  return Allocate(size);
+}
+
+void* operator new[](size_t size) {
+  return Allocate(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+  try {
+    return Allocate(size);
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+  try {
+    return Allocate(size);
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+void operator delete(void* p) noexcept {
+  std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+  std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+  std::free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+  std::free(p);
+}
+
+void* operator new(size_t size, std::align_val_t alignment) {
+  return Allocate(size, alignment);
+}
+
+void* operator new[](size_t size, std::align_val_t alignment) {
+  return Allocate(size, alignment);
+}
+
+void* operator new(
+    size_t size,
+    std::align_val_t alignment,
+    const std::nothrow_t&) noexcept {
+  try {
+    return Allocate(size, alignment);
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+void* operator new[](
+    size_t size,
+    std::align_val_t alignment,
+    const std::nothrow_t&) noexcept {
+  try {
+    return Allocate(size, alignment);
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+  std::free(p);
+}
+
+void operator delete[](void* p, std::align_val_t) noexcept {
+  std::free(p);
+}
+
+void operator delete(void* p, size_t, std::align_val_t) noexcept {
+  std::free(p);
+}
+
+void operator delete[](void* p, size_t, std::align_val_t) noexcept {
+  std::free(p);
+}
+
+////////////////////////////////////////////////////////////////////////
+
+class AllocationsTest : public EventualsGrpcTest {
+ protected:
+  void SetUp() override {
+    EventualsGrpcTest::SetUp();
+
+    ServerBuilder builder;
+
+    builder.AddListeningPort(
+        "0.0.0.0:0",
+        grpc::InsecureServerCredentials(),
+        &port_);
+
+    auto build = builder.BuildAndStart();
+
+    ASSERT_TRUE(build.status.ok()) << build.status.error();
+
+    server_ = std::move(build.server);
+
+    client_.emplace(
+        "0.0.0.0:" + std::to_string(port_),
+        grpc::InsecureChannelCredentials(),
+        pool_.Borrow());
+  }
+
+  void TearDown() override {
+    client_.reset();
+    server_.reset();
+
+    EventualsGrpcTest::TearDown();
+  }
+
+  // Expects that calls made with 'call' (which should return whether
+  // or not the call succeeded) while serving with 'serve' stay within
+  // 'budget' on average.
+  template <typename E, typename F>
+  void ExpectWithinBudget(const Budget& budget, E serve, F call) {
+    auto [served, k] = Terminate(std::move(serve));
+
+    k.Start();
+
+    Measure(budget, call);
+
+    // NOTE: need to shutdown here rather than in 'TearDown()' since
+    // 'k' must outlive serving.
+    client_.reset();
+    server_->Shutdown();
+    server_->Wait();
+  }
+
+  Client& client() {
+    return client_.value();
+  }
+
+  Server& server() {
+    return *server_;
+  }
+
+ private:
+  // Some calls are made before measuring so that any one time
+  // initialization (e.g., of the channel or the endpoint) isn't
+  // counted.
+  template <typename F>
+  void Measure(const Budget& budget, F& call) {
+    static constexpr size_t kWarmups = 10;
+    static constexpr size_t kCalls = 100;
+
+    for (size_t i = 0; i < kWarmups; i++) {
+      ASSERT_TRUE(call());
+    }
+
+    size_t before_allocations = allocations.load();
+    size_t before_allocated = allocated.load();
+
+    for (size_t i = 0; i < kCalls; i++) {
+      ASSERT_TRUE(call());
+    }
+
+    double per_call_allocations =
+        static_cast<double>(allocations.load() - before_allocations)
+        / kCalls;
+
+    double per_call_bytes =
+        static_cast<double>(allocated.load() - before_allocated)
+        / kCalls;
+
+    // Reported (e.g., in the test's XML output) so that budgets can
+    // be recorded, and tightened when they're met with room to spare.
+    RecordProperty(
+        "allocations_per_call",
+        std::to_string(per_call_allocations));
+    RecordProperty("bytes_per_call", std::to_string(per_call_bytes));
+
+    EXPECT_LE(per_call_allocations, budget.allocations)
+        << "allocations per call exceeded the budget";
+
+    EXPECT_LE(per_call_bytes, budget.bytes)
+        << "bytes allocated per call exceeded the budget";
+  }
+
+  int port_ = 0;
+  std::unique_ptr<Server> server_;
+  Borrowable<CompletionPool> pool_;
+  std::optional<Client> client_;
+};
+
+////////////////////////////////////////////////////////////////////////
+
+TEST_F(AllocationsTest, Unary) {
+  auto serve = [&]() {
+    return server().Accept<Greeter, HelloRequest, HelloReply>("SayHello")
+        | Map(Let([](auto& call) {
+             return UnaryPrologue(call)
+                 | Then([](auto&& request) {
+                      HelloReply reply;
+                      reply.set_message(request.name());
+                      return reply;
+                    })
+                 | UnaryEpilogue(call);
+           }))
+        | Loop();
+  };
+
+  ExpectWithinBudget(kUnaryBudget, serve(), [&]() {
+    auto call = [&]() {
+      HelloRequest request;
+      request.set_name("emily");
+      return client().Unary<Greeter, HelloRequest, HelloReply>(
+          "SayHello",
+          std::move(request));
+    };
+
+    return (*call()).status.ok();
+  });
+}
+
+////////////////////////////////////////////////////////////////////////
+
+TEST_F(AllocationsTest, ClientStreaming) {
+  auto serve = [&]() {
+    return server().Accept<Stream<Point>, RouteSummary>(
+               "routeguide.RouteGuide.RecordRoute")
+        | Map(Let([](auto& call) {
+             return call.Reader().Read()
+                 | Map([](auto&&) {})
+                 | Loop()
+                 | Then([]() {
+                      RouteSummary summary;
+                      summary.set_point_count(kMessages);
+                      return summary;
+                    })
+                 | UnaryEpilogue(call);
+           }))
+        | Loop();
+  };
+
+  std::vector<Point> points(kMessages);
+
+  ExpectWithinBudget(kClientStreamingBudget, serve(), [&]() {
+    auto call = [&]() {
+      return client().Call<Stream<Point>, RouteSummary>(
+                 "routeguide.RouteGuide.RecordRoute")
+          | Then(Let([&](auto& call) {
+               return Iterate(points)
+                   | Map([&](auto& point) {
+                        return call.Writer().Write(point);
+                      })
+                   | Loop()
+                   | call.WritesDone()
+                   | call.Reader().Read()
+                   | Map([](auto&&) {})
+                   | Loop()
+                   | call.Finish();
+             }));
+    };
+
+    return (*call()).ok();
+  });
+}
+
+////////////////////////////////////////////////////////////////////////
+
+TEST_F(AllocationsTest, ServerStreaming) {
+  auto serve = [&]() {
+    return server().Accept<Rectangle, Stream<Feature>>(
+               "routeguide.RouteGuide.ListFeatures")
+        | Map(Let([](auto& call) {
+             return UnaryPrologue(call)
+                 | Then([](auto&&) {})
+                 | Closure([]() {
+                      return Iterate(std::vector<Feature>(kMessages));
+                    })
+                 | StreamingEpilogue(call);
+           }))
+        | Loop();
+  };
+
+  ExpectWithinBudget(kServerStreamingBudget, serve(), [&]() {
+    auto call = [&]() {
+      return client().Call<Rectangle, Stream<Feature>>(
+                 "routeguide.RouteGuide.ListFeatures")
+          | Then(Let([](auto& call) {
+               return call.Writer().WriteLast(Rectangle())
+                   | call.Reader().Read()
+                   | Map([](auto&&) {})
+                   | Loop()
+                   | call.Finish();
+             }));
+    };
+
+    return (*call()).ok();
+  });
+}
+
+////////////////////////////////////////////////////////////////////////
+
+TEST_F(AllocationsTest, BidiStreaming) {
+  auto serve = [&]() {
+    return server().Accept<
+               Stream<keyvaluestore::Request>,
+               Stream<keyvaluestore::Response>>(
+               "keyvaluestore.KeyValueStore.GetValues")
+        | Map(Let([](auto& call) {
+             return call.Reader().Read()
+                 | Map([](auto&& request) {
+                      keyvaluestore::Response response;
+                      response.set_value(request.key());
+                      return response;
+                    })
+                 | StreamingEpilogue(call);
+           }))
+        | Loop();
+  };
+
+  std::vector<keyvaluestore::Request> requests(kMessages);
+  for (auto& request : requests) {
+    request.set_key("key");
+  }
+
+  ExpectWithinBudget(kBidiStreamingBudget, serve(), [&]() {
+    auto call = [&]() {
+      return client().Call<
+                 Stream<keyvaluestore::Request>,
+                 Stream<keyvaluestore::Response>>(
+                 "keyvaluestore.KeyValueStore.GetValues")
+          | Then(Let([&](auto& call) {
+               return Iterate(requests)
+                   | Map([&](auto& request) {
+                        return call.Writer().Write(request);
+                      })
+                   | Loop()
+                   | call.WritesDone()
+                   | call.Reader().Read()
+                   | Map([](auto&&) {})
+                   | Loop()
+                   | call.Finish();
+             }));
+    };
+
+    return (*call()).ok();
+  });
+}
+
+////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,212 @@
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "eventuals/grpc/call-log.h"
+#include "eventuals/grpc/call-phases.h"
+#include "eventuals/grpc/client.h"
+#include "eventuals/grpc/server.h"
+#include "eventuals/head.h"
+#include "eventuals/let.h"
+#include "eventuals/then.h"
+#include "examples/protos/helloworld.grpc.pb.h"
+#include "gtest/gtest.h"
+#include "test/test.h"
+
+using helloworld::Greeter;
+using helloworld::HelloReply;
+using helloworld::HelloRequest;
+
+using stout::Borrowable;
+
+using eventuals::Head;
+using eventuals::Let;
+using eventuals::Terminate;
+using eventuals::Then;
+
+using eventuals::grpc::CallLog;
+using eventuals::grpc::CallLogOptions;
+using eventuals::grpc::CallPhases;
+using eventuals::grpc::Client;
+using eventuals::grpc::CompletionPool;
+using eventuals::grpc::ServerBuilder;
+
+TEST(CallLogTest, Roundtrip) {
+  std::string path = ::testing::TempDir() + "/roundtrip.call-log";
+
+  CallLogOptions options;
+  options.rings = 2;
+  options.events = 4;
+
+  {
+    auto log = CallLog::Open(path, options);
+
+    ASSERT_TRUE(log);
+
+    auto call = log->Call("/helloworld.Greeter/SayHello", "localhost");
+
+    log->Log(call, CallLog::Phase::Finish, 0);
+
+    // Another thread writes to another ring, and more events than fit
+    // so only the most recent ones should be kept.
+    std::thread thread([&]() {
+      for (uint32_t i = 0; i < 10; i++) {
+        log->Log(call, CallLog::Phase::Write, i);
+      }
+    });
+
+    thread.join();
+
+    log->Log(call, CallLog::Phase::Done, 0);
+  }
+
+  auto reader = CallLog::Reader::Open(path);
+
+  ASSERT_TRUE(reader);
+
+  const auto& records = reader->Records();
+
+  ASSERT_EQ(7, records.size());
+
+  EXPECT_EQ(CallLog::Phase::Accepted, records[0].phase);
+  EXPECT_EQ(
+      std::string("/helloworld.Greeter/SayHello\0localhost", 38),
+      records[0].data);
+
+  EXPECT_EQ(CallLog::Phase::Finish, records[1].phase);
+
+  for (size_t i = 2; i < 6; i++) {
+    EXPECT_EQ(CallLog::Phase::Write, records[i].phase);
+    EXPECT_EQ(records[0].call, records[i].call);
+    EXPECT_EQ(i + 4, records[i].value);
+  }
+
+  EXPECT_EQ(CallLog::Phase::Done, records[6].phase);
+}
+
+TEST(CallLogTest, NotACallLog) {
+  EXPECT_FALSE(CallLog::Reader::Open("/does/not/exist"));
+}
+
+TEST_F(EventualsGrpcTest, ServerCallLog) {
+  std::string path = ::testing::TempDir() + "/server.call-log";
+
+  ServerBuilder builder;
+
+  int port = 0;
+
+  builder.AddListeningPort(
+      "0.0.0.0:0",
+      grpc::InsecureServerCredentials(),
+      &port);
+
+  CallLogOptions options;
+  options.sample = 1;
+
+  builder.SetCallLog(path, options);
+
+  auto build = builder.BuildAndStart();
+
+  ASSERT_TRUE(build.status.ok()) << build.status.error();
+
+  auto server = std::move(build.server);
+
+  auto serve = [&]() {
+    return server->Accept<Greeter, HelloRequest, HelloReply>("SayHello")
+        | Head()
+        | Then(Let([](auto& call) {
+             return UnaryPrologue(call)
+                 | Then([](auto&& request) {
+                      HelloReply reply;
+                      reply.set_message("Hello " + request.name());
+                      return reply;
+                    })
+                 | UnaryEpilogue(call);
+           }));
+  };
+
+  auto [cancelled, k] = Terminate(serve());
+
+  k.Start();
+
+  Borrowable<CompletionPool> pool;
+
+  Client client(
+      "0.0.0.0:" + std::to_string(port),
+      grpc::InsecureChannelCredentials(),
+      pool.Borrow());
+
+  auto call = [&]() {
+    HelloRequest request;
+    request.set_name("emily");
+    return client.Unary<Greeter, HelloRequest, HelloReply>(
+        "SayHello",
+        std::move(request));
+  };
+
+  auto result = *call();
+
+  ASSERT_TRUE(result.status.ok()) << result.status.error_message();
+
+  EXPECT_FALSE(cancelled.get());
+
+  server.reset();
+
+  auto reader = CallLog::Reader::Open(path);
+
+  ASSERT_TRUE(reader);
+
+  std::vector<CallLog::Phase> phases;
+  for (const auto& record : reader->Records()) {
+    phases.push_back(record.phase);
+  }
+
+  EXPECT_EQ(
+      std::vector<CallLog::Phase>({
+          CallLog::Phase::Accepted,
+          CallLog::Phase::Read,
+          CallLog::Phase::Write,
+          CallLog::Phase::Finish,
+          CallLog::Phase::Phases,
+          CallLog::Phase::Done,
+      }),
+      phases);
+
+  ASSERT_EQ(6, reader->Records().size());
+
+  const auto& read = reader->Records()[1];
+
+  // Every call is sampled so the request should be in the log.
+  HelloRequest request;
+  EXPECT_TRUE(request.ParseFromString(read.data));
+  EXPECT_EQ("emily", request.name());
+  EXPECT_EQ(read.data.size(), read.value);
+
+  EXPECT_EQ(0, reader->Records()[3].value);
+
+  // One 'int64_t' per phase.
+  EXPECT_EQ(
+      CallPhases::kPhases * sizeof(int64_t),
+      reader->Records()[4].data.size());
+
+  EXPECT_EQ(0, reader->Records()[5].value);
+}
+
+TEST_F(EventualsGrpcTest, ServerCallLogFailsToOpen) {
+  ServerBuilder builder;
+
+  builder.AddListeningPort(
+      "0.0.0.0:0",
+      grpc::InsecureServerCredentials());
+
+  builder.SetCallLog("/does/not/exist/call-log");
+
+  auto build = builder.BuildAndStart();
+
+  ASSERT_FALSE(build.status.ok());
+
+  EXPECT_EQ(
+      "Error building server: failed to open call log "
+      "'/does/not/exist/call-log'",
+      build.status.error());
+}
@@ -0,0 +1,152 @@
+#include <chrono>
+#include <string>
+
+#include "eventuals/grpc/call-phases.h"
+#include "eventuals/grpc/client.h"
+#include "eventuals/grpc/histogram.h"
+#include "eventuals/grpc/server.h"
+#include "eventuals/head.h"
+#include "eventuals/let.h"
+#include "eventuals/then.h"
+#include "examples/protos/helloworld.grpc.pb.h"
+#include "gtest/gtest.h"
+#include "test/test.h"
+
+using helloworld::Greeter;
+using helloworld::HelloReply;
+using helloworld::HelloRequest;
+
+using stout::Borrowable;
+
+using eventuals::Head;
+using eventuals::Let;
+using eventuals::Terminate;
+using eventuals::Then;
+
+using eventuals::grpc::CallPhases;
+using eventuals::grpc::Client;
+using eventuals::grpc::CompletionPool;
+using eventuals::grpc::Histogram;
+using eventuals::grpc::ServerBuilder;
+
+using std::chrono::microseconds;
+using std::chrono::nanoseconds;
+
+TEST(CallPhasesTest, Histogram) {
+  Histogram histogram;
+
+  EXPECT_EQ(nanoseconds(0), histogram.Percentile(50));
+
+  for (int i = 1; i <= 100; i++) {
+    histogram.Record(microseconds(i));
+  }
+
+  EXPECT_EQ(100, histogram.count());
+  EXPECT_EQ(microseconds(100), histogram.max());
+
+  // Buckets are at most 12.5% wide.
+  EXPECT_LE(microseconds(50), histogram.Percentile(50));
+  EXPECT_GE(nanoseconds(56250), histogram.Percentile(50));
+
+  EXPECT_LE(microseconds(99), histogram.Percentile(99));
+  EXPECT_GE(microseconds(100), histogram.Percentile(99));
+
+  EXPECT_EQ(microseconds(100), histogram.Percentile(100));
+}
+
+TEST(CallPhasesTest, Timeline) {
+  CallPhases::Timeline timeline;
+
+  timeline.Mark(CallPhases::Requested);
+  timeline.Mark(CallPhases::Accepted);
+  timeline.Mark(CallPhases::LookedUp);
+  timeline.Mark(CallPhases::Dequeued);
+
+  // NOTE: not marking 'WritingLast' like when a call is finished via
+  // 'ServerWriter::WriteAndFinish()'.
+  timeline.Mark(CallPhases::Finishing);
+  timeline.Mark(CallPhases::Done);
+
+  auto durations = timeline.Measure();
+
+  EXPECT_EQ(nanoseconds(0), durations[CallPhases::WriteLast]);
+
+  for (const auto& duration : durations) {
+    EXPECT_LE(nanoseconds(0), duration);
+  }
+}
+
+TEST_F(EventualsGrpcTest, ServerPhases) {
+  ServerBuilder builder;
+
+  int port = 0;
+
+  builder.AddListeningPort(
+      "0.0.0.0:0",
+      grpc::InsecureServerCredentials(),
+      &port);
+
+  auto build = builder.BuildAndStart();
+
+  ASSERT_TRUE(build.status.ok()) << build.status.error();
+
+  auto server = std::move(build.server);
+
+  auto serve = [&]() {
+    return server->Accept<Greeter, HelloRequest, HelloReply>("SayHello")
+        | Head()
+        | Then(Let([](auto& call) {
+             return UnaryPrologue(call)
+                 | Then([](auto&& request) {
+                      HelloReply reply;
+                      reply.set_message("Hello " + request.name());
+                      return reply;
+                    })
+                 | UnaryEpilogue(call);
+           }));
+  };
+
+  auto [cancelled, k] = Terminate(serve());
+
+  k.Start();
+
+  Borrowable<CompletionPool> pool;
+
+  Client client(
+      "0.0.0.0:" + std::to_string(port),
+      grpc::InsecureChannelCredentials(),
+      pool.Borrow());
+
+  auto call = [&]() {
+    HelloRequest request;
+    request.set_name("emily");
+    return client.Unary<Greeter, HelloRequest, HelloReply>(
+        "SayHello",
+        std::move(request));
+  };
+
+  auto result = *call();
+
+  ASSERT_TRUE(result.status.ok()) << result.status.error_message();
+
+  EXPECT_FALSE(cancelled.get());
+
+  // NOTE: the call might not be done (and thus aggregated) until
+  // after the client got its response so shutting down the server
+  // first to wait for it.
+  server->Shutdown();
+  server->Wait();
+
+  auto endpoints = server->Phases();
+
+  ASSERT_EQ(1, endpoints.size());
+
+  EXPECT_EQ("/helloworld.Greeter/SayHello", endpoints[0].path);
+  EXPECT_EQ("*", endpoints[0].host);
+
+  for (const auto& phase : endpoints[0].phases) {
+    EXPECT_EQ(1, phase.calls);
+    EXPECT_LE(phase.p50, phase.p99);
+    EXPECT_LE(phase.p99, phase.max);
+  }
+}
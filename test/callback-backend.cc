@@ -0,0 +1,467 @@
+#include "eventuals/grpc/client.h"
+#include "eventuals/grpc/server.h"
+#include "eventuals/head.h"
+#include "eventuals/let.h"
+#include "eventuals/loop.h"
+#include "eventuals/map.h"
+#include "eventuals/then.h"
+#include "examples/protos/helloworld.grpc.pb.h"
+#include "examples/protos/keyvaluestore.grpc.pb.h"
+#include "gtest/gtest.h"
+#include "test/helloworld.eventuals.h"
+#include "test/test.h"
+
+using helloworld::Greeter;
+using helloworld::HelloReply;
+using helloworld::HelloRequest;
+
+using stout::Borrowable;
+
+using eventuals::Head;
+using eventuals::Let;
+using eventuals::Loop;
+using eventuals::Map;
+using eventuals::Terminate;
+using eventuals::Then;
+
+using eventuals::grpc::Client;
+using eventuals::grpc::CompletionPool;
+using eventuals::grpc::ReadAheadOptions;
+using eventuals::grpc::ServerBackend;
+using eventuals::grpc::ServerBuilder;
+using eventuals::grpc::Stream;
+
+TEST_F(EventualsGrpcTest, CallbackBackendUnary) {
+  ServerBuilder builder;
+
+  builder.SetBackend(ServerBackend::Callback);
+
+  int port = 0;
+
+  builder.AddListeningPort(
+      "0.0.0.0:0",
+      grpc::InsecureServerCredentials(),
+      &port);
+
+  auto build = builder.BuildAndStart();
+
+  ASSERT_TRUE(build.status.ok());
+
+  auto server = std::move(build.server);
+
+  ASSERT_TRUE(server);
+
+  // NOTE: no completion queues (or threads) with the callback backend.
+  EXPECT_TRUE(server->pollers().empty());
+
+  auto serve = [&]() {
+    return server->Accept<Greeter, HelloRequest, HelloReply>("SayHello")
+        | Head()
+        | Then(Let([](auto& call) {
+             EXPECT_EQ(nullptr, call.context());
+             EXPECT_NE(nullptr, call.base());
+             return UnaryPrologue(call)
+                 | Then([](auto&& request) {
+                      HelloReply reply;
+                      std::string prefix("Hello ");
+                      reply.set_message(prefix + request.name());
+                      return reply;
+                    })
+                 | UnaryEpilogue(call);
+           }));
+  };
+
+  auto [cancelled, k] = Terminate(serve());
+
+  k.Start();
+
+  Borrowable<CompletionPool> pool;
+
+  Client client(
+      "0.0.0.0:" + std::to_string(port),
+      grpc::InsecureChannelCredentials(),
+      pool.Borrow());
+
+  auto call = [&]() {
+    return client.Call<Greeter, HelloRequest, HelloReply>("SayHello")
+        | Then(Let([](auto& call) {
+             HelloRequest request;
+             request.set_name("emily");
+             return call.Writer().WriteLast(request)
+                 | call.Reader().Read()
+                 | Map([](auto&& response) {
+                      EXPECT_EQ("Hello emily", response.message());
+                    })
+                 | Loop()
+                 | call.Finish();
+           }));
+  };
+
+  auto status = *call();
+
+  EXPECT_TRUE(status.ok());
+
+  EXPECT_FALSE(cancelled.get());
+}
+
+TEST_F(EventualsGrpcTest, CallbackBackendStreaming) {
+  ServerBuilder builder;
+
+  builder.SetBackend(ServerBackend::Callback);
+
+  int port = 0;
+
+  builder.AddListeningPort(
+      "0.0.0.0:0",
+      grpc::InsecureServerCredentials(),
+      &port);
+
+  auto build = builder.BuildAndStart();
+
+  ASSERT_TRUE(build.status.ok());
+
+  auto server = std::move(build.server);
+
+  ASSERT_TRUE(server);
+
+  auto serve = [&]() {
+    return server->Accept<
+               Stream<keyvaluestore::Request>,
+               Stream<keyvaluestore::Response>>(
+               "keyvaluestore.KeyValueStore.GetValues")
+        | Head()
+        | Then(Let([](auto& call) {
+             return call.Reader().Read()
+                 | Map([](auto&& request) {
+                      keyvaluestore::Response response;
+                      response.set_value(request.key());
+                      return response;
+                    })
+                 | StreamingEpilogue(call);
+           }));
+  };
+
+  auto [cancelled, k] = Terminate(serve());
+
+  k.Start();
+
+  Borrowable<CompletionPool> pool;
+
+  Client client(
+      "0.0.0.0:" + std::to_string(port),
+      grpc::InsecureChannelCredentials(),
+      pool.Borrow());
+
+  std::vector<std::string> values;
+
+  auto call = [&]() {
+    return client.Call<
+               Stream<keyvaluestore::Request>,
+               Stream<keyvaluestore::Response>>(
+               "keyvaluestore.KeyValueStore.GetValues")
+        | Then(Let([&](auto& call) {
+             keyvaluestore::Request request1;
+             request1.set_key("1");
+             keyvaluestore::Request request2;
+             request2.set_key("2");
+             return call.Writer().Write(request1)
+                 | call.Writer().Write(request2)
+                 | call.WritesDone()
+                 | call.Reader().Read()
+                 | Map([&](auto&& response) {
+                      values.push_back(response.value());
+                    })
+                 | Loop()
+                 | call.Finish();
+           }));
+  };
+
+  auto status = *call();
+
+  EXPECT_TRUE(status.ok()) << status.error_message();
+
+  EXPECT_EQ((std::vector<std::string>{"1", "2"}), values);
+
+  EXPECT_FALSE(cancelled.get());
+}
+
+// A service generated by 'protoc-gen-eventuals' gets the call's
+// context (rather than 'nullptr') with the callback backend too.
+class CallbackGreeterServiceImpl final
+  : public helloworld::eventuals::Greeter::Service<
+        CallbackGreeterServiceImpl> {
+ public:
+  auto SayHello(::grpc::ServerContextBase* context, HelloRequest&& request) {
+    EXPECT_NE(nullptr, context);
+    EXPECT_FALSE(context->IsCancelled());
+    HelloReply reply;
+    reply.set_message("Hello " + request.name());
+    return reply;
+  }
+};
+
+TEST_F(EventualsGrpcTest, CallbackBackendGeneratedService) {
+  ServerBuilder builder;
+
+  builder.SetBackend(ServerBackend::Callback);
+
+  int port = 0;
+
+  builder.AddListeningPort(
+      "0.0.0.0:0",
+      grpc::InsecureServerCredentials(),
+      &port);
+
+  CallbackGreeterServiceImpl service;
+
+  builder.RegisterService(&service);
+
+  auto build = builder.BuildAndStart();
+
+  ASSERT_TRUE(build.status.ok()) << build.status.error();
+
+  auto server = std::move(build.server);
+
+  ASSERT_TRUE(server);
+
+  Borrowable<CompletionPool> pool;
+
+  Client client(
+      "0.0.0.0:" + std::to_string(port),
+      grpc::InsecureChannelCredentials(),
+      pool.Borrow());
+
+  auto unary = [&]() {
+    HelloRequest request;
+    request.set_name("emily");
+    return client.Unary<Greeter, HelloRequest, HelloReply>(
+        "SayHello",
+        std::move(request));
+  };
+
+  auto result = *unary();
+
+  EXPECT_TRUE(result.status.ok()) << result.status.error_message();
+
+  EXPECT_EQ("Hello emily", result.response.message());
+}
+
+TEST_F(EventualsGrpcTest, CallbackBackendCompletionQueueOptions) {
+  ServerBuilder builder;
+
+  builder.SetBackend(ServerBackend::Callback);
+
+  builder.SetNumberOfCompletionQueues(2);
+
+  builder.AddListeningPort("0.0.0.0:0", grpc::InsecureServerCredentials());
+
+  auto build = builder.BuildAndStart();
+
+  ASSERT_FALSE(build.status.ok());
+
+  EXPECT_EQ(
+      "Error building server: "
+      "completion queue options can not be used with callback backend",
+      build.status.error());
+
+  EXPECT_FALSE(build.server);
+}
+
+TEST_F(EventualsGrpcTest, CallbackClient) {
+  ServerBuilder builder;
+
+  int port = 0;
+
+  builder.AddListeningPort(
+      "0.0.0.0:0",
+      grpc::InsecureServerCredentials(),
+      &port);
+
+  auto build = builder.BuildAndStart();
+
+  ASSERT_TRUE(build.status.ok());
+
+  auto server = std::move(build.server);
+
+  ASSERT_TRUE(server);
+
+  auto serve = [&]() {
+    return server->Accept<Greeter, HelloRequest, HelloReply>("SayHello")
+        | Map(Let([](auto& call) {
+             return UnaryPrologue(call)
+                 | Then([](auto&& request) {
+                      HelloReply reply;
+                      std::string prefix("Hello ");
+                      reply.set_message(prefix + request.name());
+                      return reply;
+                    })
+                 | UnaryEpilogue(call);
+           }))
+        | Loop();
+  };
+
+  auto [served, k] = Terminate(serve());
+
+  k.Start();
+
+  // NOTE: no 'CompletionPool' so calls use gRPC's callback API.
+  Client client(
+      "0.0.0.0:" + std::to_string(port),
+      grpc::InsecureChannelCredentials());
+
+  auto call = [&]() {
+    return client.Call<Greeter, HelloRequest, HelloReply>("SayHello")
+        | Then(Let([](auto& call) {
+             HelloRequest request;
+             request.set_name("emily");
+             return call.Writer().WriteLast(request)
+                 | call.Reader().Read()
+                 | Map([](auto&& response) {
+                      EXPECT_EQ("Hello emily", response.message());
+                    })
+                 | Loop()
+                 | call.Finish();
+           }));
+  };
+
+  auto status = *call();
+
+  EXPECT_TRUE(status.ok());
+
+  auto unary = [&]() {
+    HelloRequest request;
+    request.set_name("emily");
+    return client.Unary<Greeter, HelloRequest, HelloReply>(
+        "SayHello",
+        std::move(request));
+  };
+
+  auto result = *unary();
+
+  EXPECT_TRUE(result.status.ok());
+
+  EXPECT_EQ("Hello emily", result.response.message());
+
+  server->Shutdown();
+  server->Wait();
+}
+
+// A call using gRPC's callback API that gets destructed without being
+// finished must still get cancelled (and cleaned up) rather than
+// being held open forever.
+TEST_F(EventualsGrpcTest, CallbackClientNotFinished) {
+  ServerBuilder builder;
+
+  int port = 0;
+
+  builder.AddListeningPort(
+      "0.0.0.0:0",
+      grpc::InsecureServerCredentials(),
+      &port);
+
+  auto build = builder.BuildAndStart();
+
+  ASSERT_TRUE(build.status.ok());
+
+  auto server = std::move(build.server);
+
+  ASSERT_TRUE(server);
+
+  auto serve = [&]() {
+    return server->Accept<Greeter, HelloRequest, HelloReply>("SayHello")
+        | Head()
+        | Then(Let([](auto& call) {
+             return call.WaitForDone();
+           }));
+  };
+
+  auto [cancelled, k] = Terminate(serve());
+
+  k.Start();
+
+  // NOTE: no 'CompletionPool' so calls use gRPC's callback API.
+  Client client(
+      "0.0.0.0:" + std::to_string(port),
+      grpc::InsecureChannelCredentials());
+
+  ::grpc::ClientContext context;
+
+  auto call = [&]() {
+    return client.Call<Greeter, HelloRequest, HelloReply>(
+               "SayHello",
+               &context)
+        | Then(Let([](auto& call) {
+             HelloRequest request;
+             request.set_name("emily");
+             return call.Writer().WriteLast(request);
+           }));
+  };
+
+  *call();
+
+  EXPECT_TRUE(cancelled.get());
+}
+
+// A call using gRPC's callback API that gets destructed while a read
+// is still outstanding (here the read ahead of the first response)
+// must not leave gRPC with anything to complete into, i.e., the
+// context the call created and the message being read.
+TEST_F(EventualsGrpcTest, CallbackClientNotFinishedWhileReading) {
+  ServerBuilder builder;
+
+  int port = 0;
+
+  builder.AddListeningPort(
+      "0.0.0.0:0",
+      grpc::InsecureServerCredentials(),
+      &port);
+
+  auto build = builder.BuildAndStart();
+
+  ASSERT_TRUE(build.status.ok());
+
+  auto server = std::move(build.server);
+
+  ASSERT_TRUE(server);
+
+  auto serve = [&]() {
+    return server->Accept<
+               Stream<keyvaluestore::Request>,
+               Stream<keyvaluestore::Response>>(
+               "keyvaluestore.KeyValueStore.GetValues")
+        | Head()
+        | Then(Let([](auto& call) {
+             keyvaluestore::Response response;
+             response.set_value("1");
+             return call.Writer().Write(response)
+                 | call.WaitForDone();
+           }));
+  };
+
+  auto [cancelled, k] = Terminate(serve());
+
+  k.Start();
+
+  // NOTE: no 'CompletionPool' so calls use gRPC's callback API.
+  Client client(
+      "0.0.0.0:" + std::to_string(port),
+      grpc::InsecureChannelCredentials());
+
+  auto call = [&]() {
+    return client.Call<
+               Stream<keyvaluestore::Request>,
+               Stream<keyvaluestore::Response>>(
+               "keyvaluestore.KeyValueStore.GetValues")
+        | Then(Let([](auto& call) {
+             return call.Reader().Read(ReadAheadOptions())
+                 | Head();
+           }));
+  };
+
+  // NOTE: the call (including the context it created) gets
+  // destructed right after the first response, while the read of the
+  // second response is still outstanding.
+  EXPECT_EQ("1", (*call()).value());
+
+  EXPECT_TRUE(cancelled.get());
+}
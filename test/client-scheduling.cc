@@ -0,0 +1,262 @@
+#include "eventuals/grpc/client.h"
+#include "eventuals/grpc/poller.h"
+#include "eventuals/grpc/server.h"
+#include "eventuals/head.h"
+#include "eventuals/let.h"
+#include "eventuals/then.h"
+#include "examples/protos/helloworld.grpc.pb.h"
+#include "gtest/gtest.h"
+#include "test/test.h"
+
+using helloworld::Greeter;
+using helloworld::HelloReply;
+using helloworld::HelloRequest;
+
+using stout::Borrowable;
+
+using eventuals::Head;
+using eventuals::Let;
+using eventuals::Terminate;
+using eventuals::Then;
+
+using eventuals::grpc::Client;
+using eventuals::grpc::ClientScheduling;
+using eventuals::grpc::CompletionPool;
+using eventuals::grpc::Poller;
+using eventuals::grpc::ServerBuilder;
+
+// Tests a "proxy" whose handler issues a call to a "backend" via a
+// client that schedules calls on the completion queue of the call
+// being handled, i.e., without ever leaving the proxy's thread.
+TEST_F(EventualsGrpcTest, ClientSchedulingCurrentCompletionQueue) {
+  int backend_port = 0;
+
+  auto backend = [&]() {
+    ServerBuilder builder;
+
+    builder.AddListeningPort(
+        "0.0.0.0:0",
+        grpc::InsecureServerCredentials(),
+        &backend_port);
+
+    return builder.BuildAndStart();
+  }();
+
+  ASSERT_TRUE(backend.status.ok());
+
+  int proxy_port = 0;
+
+  auto proxy = [&]() {
+    ServerBuilder builder;
+
+    builder.AddListeningPort(
+        "0.0.0.0:0",
+        grpc::InsecureServerCredentials(),
+        &proxy_port);
+
+    return builder.BuildAndStart();
+  }();
+
+  ASSERT_TRUE(proxy.status.ok());
+
+  auto serve_backend = [&]() {
+    return backend.server->Accept<Greeter, HelloRequest, HelloReply>(
+               "SayHello")
+        | Head()
+        | Then(Let([](auto& call) {
+             return UnaryPrologue(call)
+                 | Then([](auto&& request) {
+                      HelloReply reply;
+                      reply.set_message("Hello " + request.name());
+                      return reply;
+                    })
+                 | UnaryEpilogue(call);
+           }));
+  };
+
+  auto [backend_cancelled, backend_k] = Terminate(serve_backend());
+
+  backend_k.Start();
+
+  Client downstream(
+      "0.0.0.0:" + std::to_string(backend_port),
+      grpc::InsecureChannelCredentials(),
+      ClientScheduling::CurrentCompletionQueue);
+
+  auto serve_proxy = [&]() {
+    return proxy.server->Accept<Greeter, HelloRequest, HelloReply>(
+               "SayHello")
+        | Head()
+        | Then(Let([&](auto& call) {
+             return UnaryPrologue(call)
+                 | Then([&](auto&& request) {
+                      Poller* poller = Poller::Current();
+
+                      EXPECT_NE(nullptr, poller);
+
+                      return downstream.Unary<
+                                 Greeter,
+                                 HelloRequest,
+                                 HelloReply>("SayHello", request)
+                          | Then([poller](auto&& result) {
+                               // Still on the thread that is polling
+                               // the proxy's completion queue.
+                               EXPECT_EQ(poller, Poller::Current());
+                               EXPECT_TRUE(result.status.ok());
+                               return std::move(result.response);
+                             });
+                    })
+                 | UnaryEpilogue(call);
+           }));
+  };
+
+  auto [proxy_cancelled, proxy_k] = Terminate(serve_proxy());
+
+  proxy_k.Start();
+
+  Borrowable<CompletionPool> pool;
+
+  Client client(
+      "0.0.0.0:" + std::to_string(proxy_port),
+      grpc::InsecureChannelCredentials(),
+      pool.Borrow());
+
+  auto call = [&]() {
+    HelloRequest request;
+    request.set_name("emily");
+    return client.Unary<Greeter, HelloRequest, HelloReply>(
+        "SayHello",
+        std::move(request));
+  };
+
+  auto result = *call();
+
+  ASSERT_TRUE(result.status.ok()) << result.status.error_message();
+
+  EXPECT_EQ("Hello emily", result.response.message());
+
+  EXPECT_FALSE(proxy_cancelled.get());
+  EXPECT_FALSE(backend_cancelled.get());
+}
+
+// Like 'ClientSchedulingCurrentCompletionQueue' except the call to
+// the "backend" gets composed on this thread (which isn't polling any
+// completion queue) and only started from the proxy's handler, i.e.,
+// the call must be scheduled when it's started, not when composed.
+TEST_F(EventualsGrpcTest, ClientSchedulingCurrentCompletionQueueOnStart) {
+  int backend_port = 0;
+
+  auto backend = [&]() {
+    ServerBuilder builder;
+
+    builder.AddListeningPort(
+        "0.0.0.0:0",
+        grpc::InsecureServerCredentials(),
+        &backend_port);
+
+    return builder.BuildAndStart();
+  }();
+
+  ASSERT_TRUE(backend.status.ok());
+
+  int proxy_port = 0;
+
+  auto proxy = [&]() {
+    ServerBuilder builder;
+
+    builder.AddListeningPort(
+        "0.0.0.0:0",
+        grpc::InsecureServerCredentials(),
+        &proxy_port);
+
+    return builder.BuildAndStart();
+  }();
+
+  ASSERT_TRUE(proxy.status.ok());
+
+  auto serve_backend = [&]() {
+    return backend.server->Accept<Greeter, HelloRequest, HelloReply>(
+               "SayHello")
+        | Head()
+        | Then(Let([](auto& call) {
+             return UnaryPrologue(call)
+                 | Then([](auto&& request) {
+                      HelloReply reply;
+                      reply.set_message("Hello " + request.name());
+                      return reply;
+                    })
+                 | UnaryEpilogue(call);
+           }));
+  };
+
+  auto [backend_cancelled, backend_k] = Terminate(serve_backend());
+
+  backend_k.Start();
+
+  Client downstream(
+      "0.0.0.0:" + std::to_string(backend_port),
+      grpc::InsecureChannelCredentials(),
+      ClientScheduling::CurrentCompletionQueue);
+
+  ASSERT_EQ(nullptr, Poller::Current());
+
+  HelloRequest downstream_request;
+  downstream_request.set_name("emily");
+
+  auto downstream_call = downstream.Unary<
+      Greeter,
+      HelloRequest,
+      HelloReply>("SayHello", std::move(downstream_request));
+
+  auto serve_proxy = [&]() {
+    return proxy.server->Accept<Greeter, HelloRequest, HelloReply>(
+               "SayHello")
+        | Head()
+        | Then(Let([&](auto& call) {
+             return UnaryPrologue(call)
+                 | Then([&](auto&&) {
+                      Poller* poller = Poller::Current();
+
+                      EXPECT_NE(nullptr, poller);
+
+                      return std::move(downstream_call)
+                          | Then([poller](auto&& result) {
+                               // Still on the thread that is polling
+                               // the proxy's completion queue.
+                               EXPECT_EQ(poller, Poller::Current());
+                               EXPECT_TRUE(result.status.ok());
+                               return std::move(result.response);
+                             });
+                    })
+                 | UnaryEpilogue(call);
+           }));
+  };
+
+  auto [proxy_cancelled, proxy_k] = Terminate(serve_proxy());
+
+  proxy_k.Start();
+
+  Borrowable<CompletionPool> pool;
+
+  Client client(
+      "0.0.0.0:" + std::to_string(proxy_port),
+      grpc::InsecureChannelCredentials(),
+      pool.Borrow());
+
+  auto call = [&]() {
+    HelloRequest request;
+    request.set_name("emily");
+    return client.Unary<Greeter, HelloRequest, HelloReply>(
+        "SayHello",
+        std::move(request));
+  };
+
+  auto result = *call();
+
+  ASSERT_TRUE(result.status.ok()) << result.status.error_message();
+
+  EXPECT_EQ("Hello emily", result.response.message());
+
+  EXPECT_FALSE(proxy_cancelled.get());
+  EXPECT_FALSE(backend_cancelled.get());
+}
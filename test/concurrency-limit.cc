@@ -0,0 +1,314 @@
+#include <atomic>
+#include <future>
+
+#include "eventuals/concurrent.h"
+#include "eventuals/conditional.h"
+#include "eventuals/grpc/client.h"
+#include "eventuals/grpc/server.h"
+#include "eventuals/let.h"
+#include "eventuals/loop.h"
+#include "eventuals/map.h"
+#include "eventuals/terminal.h"
+#include "eventuals/then.h"
+#include "examples/protos/helloworld.grpc.pb.h"
+#include "gtest/gtest.h"
+#include "test/test.h"
+
+using helloworld::Greeter;
+using helloworld::HelloReply;
+using helloworld::HelloRequest;
+
+using stout::Borrowable;
+
+using eventuals::Concurrent;
+using eventuals::Conditional;
+using eventuals::Let;
+using eventuals::Loop;
+using eventuals::Map;
+using eventuals::Terminate;
+using eventuals::Then;
+
+using eventuals::grpc::Client;
+using eventuals::grpc::CompletionPool;
+using eventuals::grpc::ConcurrencyLimit;
+using eventuals::grpc::ServerBuilder;
+
+// Serves 'SayHello' with a limit of one concurrent call where the
+// first call doesn't get a response (it waits until its deadline is
+// exceeded) and every other call gets a response immediately.
+void TestConcurrencyLimit(
+    bool reject,
+    grpc::StatusCode expected,
+    std::chrono::milliseconds minimum) {
+  ServerBuilder builder;
+
+  int port = 0;
+
+  builder.AddListeningPort(
+      "0.0.0.0:0",
+      grpc::InsecureServerCredentials(),
+      &port);
+
+  ConcurrencyLimit::Options options;
+  options.limit = 1;
+  options.reject = reject;
+
+  builder.SetConcurrencyLimit("helloworld.Greeter.SayHello", options);
+
+  auto build = builder.BuildAndStart();
+
+  ASSERT_TRUE(build.status.ok());
+
+  auto server = std::move(build.server);
+
+  ASSERT_TRUE(server);
+
+  std::atomic<size_t> handled = 0;
+
+  std::promise<void> handling;
+
+  auto serve = [&]() {
+    return server->Accept<Greeter, HelloRequest, HelloReply>("SayHello")
+        | Concurrent([&]() {
+             return Map(Let([&](auto& call) {
+               return UnaryPrologue(call)
+                   | Conditional(
+                        [&](auto&) {
+                          return handled++ == 0;
+                        },
+                        [&](auto&&) {
+                          handling.set_value();
+                          return call.WaitForDone()
+                              | Then([](bool) {});
+                        },
+                        [&](auto&& request) {
+                          HelloReply reply;
+                          reply.set_message("Hello " + request.name());
+                          return call.Writer().WriteLast(reply)
+                              | call.Finish(::grpc::Status::OK)
+                              | call.WaitForDone()
+                              | Then([](bool) {});
+                        });
+             }));
+           })
+        | Loop();
+  };
+
+  auto [served, k] = Terminate(serve());
+
+  k.Start();
+
+  Borrowable<CompletionPool> pool;
+
+  Client client(
+      "0.0.0.0:" + std::to_string(port),
+      grpc::InsecureChannelCredentials(),
+      pool.Borrow());
+
+  auto call = [&](std::optional<std::chrono::milliseconds> timeout) {
+    return client.Context()
+        | Then([&, timeout](auto* context) {
+             if (timeout) {
+               auto now = std::chrono::system_clock::now();
+               context->set_deadline(now + timeout.value());
+             }
+
+             return client.Call<Greeter, HelloRequest, HelloReply>(
+                        "SayHello",
+                        context)
+                 | Then(Let([](auto& call) {
+                      HelloRequest request;
+                      request.set_name("emily");
+                      return call.Writer().WriteLast(request)
+                          | call.Reader().Read()
+                          | Loop()
+                          | call.Finish();
+                    }));
+           });
+  };
+
+  auto start = std::chrono::steady_clock::now();
+
+  auto [first, k1] = Terminate(call(std::chrono::milliseconds(500)));
+
+  k1.Start();
+
+  handling.get_future().wait();
+
+  auto status = *call(std::nullopt);
+
+  EXPECT_EQ(expected, status.error_code());
+
+  auto elapsed = std::chrono::steady_clock::now() - start;
+
+  EXPECT_LE(minimum, elapsed);
+
+  if (reject) {
+    // Should have been rejected well before the first call finished.
+    EXPECT_GT(std::chrono::milliseconds(500), elapsed);
+  }
+
+  EXPECT_EQ(grpc::DEADLINE_EXCEEDED, first.get().error_code());
+}
+
+TEST_F(EventualsGrpcTest, ConcurrencyLimitWait) {
+  // The second call can't be handled until the first call is done.
+  TestConcurrencyLimit(
+      /* reject = */ false,
+      grpc::OK,
+      std::chrono::milliseconds(500));
+}
+
+TEST_F(EventualsGrpcTest, ConcurrencyLimitReject) {
+  TestConcurrencyLimit(
+      /* reject = */ true,
+      grpc::RESOURCE_EXHAUSTED,
+      std::chrono::milliseconds(0));
+}
+
+TEST_F(EventualsGrpcTest, InvalidConcurrencyLimit) {
+  ServerBuilder builder;
+
+  builder.AddListeningPort("0.0.0.0:0", grpc::InsecureServerCredentials());
+
+  builder.SetConcurrencyLimit(
+      "helloworld.Greeter.SayHello",
+      ConcurrencyLimit::Options());
+
+  auto build = builder.BuildAndStart();
+
+  ASSERT_FALSE(build.status.ok());
+
+  EXPECT_EQ(
+      "Error building server: concurrency limit must be positive",
+      build.status.error());
+}
+
+TEST(ConcurrencyLimitTest, Adaptive) {
+  ConcurrencyLimit::Options options;
+  options.limit = 10;
+  options.adaptive = true;
+  options.minimum = 2;
+  options.maximum = 11;
+  options.latency = std::chrono::milliseconds(10);
+
+  ConcurrencyLimit limit(options);
+
+  for (size_t i = 0; i < 10; i++) {
+    EXPECT_TRUE(limit.TryAcquire());
+  }
+
+  EXPECT_FALSE(limit.TryAcquire());
+
+  size_t started = 0;
+
+  limit.Acquire([&]() {
+    started++;
+  });
+
+  EXPECT_EQ(0, started);
+
+  // A slow call decreases the limit so releasing doesn't admit the
+  // waiting call.
+  limit.Release(std::chrono::milliseconds(100), false);
+
+  EXPECT_EQ(9, limit.limit());
+  EXPECT_EQ(0, started);
+
+  // Fast calls additively increase the limit.
+  for (size_t i = 0; i < 3; i++) {
+    limit.Release(std::chrono::milliseconds(1), false);
+  }
+
+  EXPECT_EQ(9, limit.limit());
+  EXPECT_EQ(1, started);
+  EXPECT_EQ(7, limit.inflight());
+
+  // Cancelled calls decrease the limit too.
+  limit.Release(std::chrono::milliseconds(1), true);
+
+  EXPECT_EQ(8, limit.limit());
+}
+
+// Each call is done (releasing its concurrency limit and logging)
+// while its handler is waiting for it to be done, after which the
+// handler immediately destructs the call, so that any use of the call
+// after it was notified as done gets caught (e.g., by ASAN).
+TEST_F(EventualsGrpcTest, ConcurrencyLimitWaitForDone) {
+  ServerBuilder builder;
+
+  int port = 0;
+
+  builder.AddListeningPort(
+      "0.0.0.0:0",
+      grpc::InsecureServerCredentials(),
+      &port);
+
+  ConcurrencyLimit::Options options;
+  options.limit = 4;
+
+  builder.SetConcurrencyLimit("helloworld.Greeter.SayHello", options);
+
+  builder.SetCallLog(::testing::TempDir() + "/wait-for-done.call-log");
+
+  auto build = builder.BuildAndStart();
+
+  ASSERT_TRUE(build.status.ok()) << build.status.error();
+
+  auto server = std::move(build.server);
+
+  auto serve = [&]() {
+    return server->Accept<Greeter, HelloRequest, HelloReply>("SayHello")
+        | Concurrent([&]() {
+             return Map(Let([&](auto& call) {
+               return UnaryPrologue(call)
+                   | Then([&](auto&& request) {
+                        HelloReply reply;
+                        reply.set_message("Hello " + request.name());
+                        return call.Writer().WriteLast(reply)
+                            | call.Finish(::grpc::Status::OK)
+                            | call.WaitForDone()
+                            | Then([](bool) {});
+                      });
+             }));
+           })
+        | Loop();
+  };
+
+  auto [served, k] = Terminate(serve());
+
+  k.Start();
+
+  Borrowable<CompletionPool> pool;
+
+  Client client(
+      "0.0.0.0:" + std::to_string(port),
+      grpc::InsecureChannelCredentials(),
+      pool.Borrow());
+
+  const size_t calls = 100;
+
+  for (size_t i = 0; i < calls; i++) {
+    HelloRequest request;
+    request.set_name("emily");
+
+    auto result = *client.Unary<Greeter, HelloRequest, HelloReply>(
+        "SayHello",
+        std::move(request));
+
+    ASSERT_TRUE(result.status.ok()) << result.status.error_message();
+  }
+
+  server->Shutdown();
+  server->Wait();
+
+  // Every call was released (otherwise the limit would have stalled
+  // the later calls) and aggregated its phases.
+  auto endpoints = server->Phases();
+
+  ASSERT_EQ(1, endpoints.size());
+
+  for (const auto& phase : endpoints[0].phases) {
+    EXPECT_EQ(calls, phase.calls);
+  }
+}
@@ -0,0 +1,154 @@
+#include "eventuals/grpc/executor.h"
+
+#include <atomic>
+#include <thread>
+
+#include "eventuals/grpc/client.h"
+#include "eventuals/grpc/server.h"
+#include "eventuals/let.h"
+#include "eventuals/loop.h"
+#include "eventuals/map.h"
+#include "eventuals/then.h"
+#include "gtest/gtest.h"
+#include "test/helloworld.eventuals.h"
+#include "test/test.h"
+
+using helloworld::HelloReply;
+using helloworld::HelloRequest;
+
+using helloworld::eventuals::Greeter;
+
+using stout::Borrowable;
+
+using eventuals::Let;
+using eventuals::Loop;
+using eventuals::Map;
+using eventuals::Then;
+
+using eventuals::grpc::Client;
+using eventuals::grpc::CompletionPool;
+using eventuals::grpc::Executor;
+using eventuals::grpc::OnExecutor;
+using eventuals::grpc::ServerBuilder;
+
+TEST(ExecutorTest, Submit) {
+  std::atomic<size_t> ran = 0;
+
+  {
+    Executor executor(4);
+
+    EXPECT_EQ(4u, executor.size());
+
+    for (size_t i = 0; i < 100; i++) {
+      executor.Submit([&]() {
+        EXPECT_EQ(&executor, Executor::Current());
+
+        // Work submitted from one of the executor's own threads goes
+        // on that thread's deque from which the others can steal.
+        for (size_t j = 0; j < 10; j++) {
+          Executor::Current()->Submit([&]() {
+            ran++;
+          });
+        }
+
+        ran++;
+      });
+    }
+
+    // NOTE: destructing the executor runs all submitted work.
+  }
+
+  EXPECT_EQ(1100u, ran);
+  EXPECT_EQ(nullptr, Executor::Current());
+}
+
+TEST(ExecutorTest, OnExecutor) {
+  Executor executor(2);
+
+  auto e = [&]() {
+    return OnExecutor(&executor, []() {
+      return Executor::Current();
+    });
+  };
+
+  EXPECT_EQ(&executor, *e());
+
+  auto inline_ = []() {
+    return OnExecutor(nullptr, []() {
+      return std::this_thread::get_id();
+    });
+  };
+
+  EXPECT_EQ(std::this_thread::get_id(), *inline_());
+}
+
+class ExecutorGreeterServiceImpl final
+  : public Greeter::Service<ExecutorGreeterServiceImpl> {
+ public:
+  ExecutorGreeterServiceImpl(Executor* executor)
+    : executor_(executor) {}
+
+  auto SayHello(::grpc::ServerContext* context, HelloRequest&& request) {
+    EXPECT_EQ(executor_, Executor::Current());
+    HelloReply reply;
+    reply.set_message("Hello " + request.name());
+    return reply;
+  }
+
+ private:
+  Executor* executor_;
+};
+
+TEST_F(EventualsGrpcTest, ServiceOnExecutor) {
+  Executor executor(2);
+
+  ExecutorGreeterServiceImpl service(&executor);
+
+  service.SetExecutor("SayHello", &executor);
+
+  ServerBuilder builder;
+
+  int port = 0;
+
+  builder.AddListeningPort(
+      "0.0.0.0:0",
+      grpc::InsecureServerCredentials(),
+      &port);
+
+  builder.RegisterService(&service);
+
+  auto build = builder.BuildAndStart();
+
+  ASSERT_TRUE(build.status.ok());
+
+  auto server = std::move(build.server);
+
+  ASSERT_TRUE(server);
+
+  Borrowable<CompletionPool> pool;
+
+  Client client(
+      "0.0.0.0:" + std::to_string(port),
+      grpc::InsecureChannelCredentials(),
+      pool.Borrow());
+
+  auto call = [&]() {
+    return client.Call<helloworld::Greeter, HelloRequest, HelloReply>(
+               "SayHello")
+        | Then(Let([](auto& call) {
+             HelloRequest request;
+             request.set_name("emily");
+             return call.Writer().WriteLast(request)
+                 | call.Reader().Read()
+                 | Map([](auto&& response) {
+                      EXPECT_EQ("Hello emily", response.message());
+                    })
+                 | Loop()
+                 | call.Finish();
+           }));
+  };
+
+  auto status = *call();
+
+  EXPECT_TRUE(status.ok());
+}
@@ -34,10 +34,18 @@ class GreeterServiceImpl final : public Greeter::Service<GreeterServiceImpl> {
   }
 };
 
-TEST_F(EventualsGrpcTest, Greeter) {
-  std::string server_address("0.0.0.0:50051");
-  GreeterServiceImpl service;
+class TypeErasedGreeterServiceImpl final
+  : public Greeter::TypeErased<TypeErasedGreeterServiceImpl> {
+ public:
+  auto SayHello(::grpc::ServerContext* context, HelloRequest&& request) {
+    std::string prefix("Hello ");
+    HelloReply reply;
+    reply.set_message(prefix + request.name());
+    return reply;
+  }
+};
 
+static void ExpectGreets(eventuals::grpc::Service* service) {
   ServerBuilder builder;
 
   int port = 0;
@@ -47,7 +55,7 @@ TEST_F(EventualsGrpcTest, Greeter) {
       grpc::InsecureServerCredentials(),
       &port);
 
-  builder.RegisterService(&service);
+  builder.RegisterService(service);
 
   auto build = builder.BuildAndStart();
 
@@ -83,3 +91,13 @@ TEST_F(EventualsGrpcTest, Greeter) {
 
   EXPECT_TRUE(status.ok());
 }
+
+TEST_F(EventualsGrpcTest, Greeter) {
+  GreeterServiceImpl service;
+  ExpectGreets(&service);
+}
+
+TEST_F(EventualsGrpcTest, GreeterTypeErased) {
+  TypeErasedGreeterServiceImpl service;
+  ExpectGreets(&service);
+}
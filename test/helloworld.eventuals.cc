@@ -19,6 +19,8 @@ using eventuals::Map;
 using eventuals::Task;
 using eventuals::Then;
 
+using eventuals::grpc::OnExecutor;
+
 ////////////////////////////////////////////////////////////////////////
 
 namespace helloworld {
@@ -34,13 +36,20 @@ Task::Of<void> Greeter::TypeErasedService::Serve() {
                    .Accept<
                        helloworld::Greeter,
                        helloworld::HelloRequest,
-                       helloworld::HelloReply>("SayHello")
+                       helloworld::HelloReply>(
+                       "SayHello",
+                       "*",
+                       ConcurrencyLimitFor("SayHello"))
                | Concurrent([this]() {
-                   return Map(Let([this](auto& call) {
+                   return Map(Let([this,
+                                   executor = ExecutorFor("SayHello")](
+                                      auto& call) {
                      return UnaryPrologue(call)
                          | Then(Let([&](auto& request) {
                               return Then(
                                   [this,
+                                   &call,
+                                   &executor,
                                    // NOTE: using a tuple because need
                                    // to pass more than one
                                    // argument. Also 'this' will be
@@ -48,9 +57,11 @@ Task::Of<void> Greeter::TypeErasedService::Serve() {
                                    // 'TypeErasedSayHello()'.
                                    args = std::tuple{
                                        this,
-                                       call.context(),
+                                       call.handler_context(),
                                        &request}]() mutable {
-                                    return TypeErasedSayHello(&args);
+                                    return OnExecutor(executor)
+                                        | call.Interruptible(
+                                            TypeErasedSayHello(&args));
                                   });
                             }))
                          | UnaryEpilogue(call);
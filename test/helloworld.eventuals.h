@@ -1,8 +1,16 @@
 #pragma once
 
 #include <tuple>
+#include <type_traits>
+#include <utility>
 
+#include "eventuals/concurrent.h"
+#include "eventuals/do-all.h"
 #include "eventuals/grpc/server.h"
+#include "eventuals/just.h"
+#include "eventuals/let.h"
+#include "eventuals/loop.h"
+#include "eventuals/map.h"
 #include "eventuals/task.h"
 #include "eventuals/then.h"
 #include "examples/protos/helloworld.grpc.pb.h"
@@ -30,23 +38,80 @@ class Greeter {
     virtual ::eventuals::Task::Of<HelloReply> TypeErasedSayHello(
         std::tuple<
             TypeErasedService*, // this
-            ::grpc::GenericServerContext*,
+            ::eventuals::grpc::HandlerContext,
             HelloRequest*>* args) = 0;
   };
 
+  // Statically dispatches each call directly to the corresponding
+  // method of 'Implementation' so that nothing gets type erased (or
+  // heap allocated) per call.
   template <typename Implementation>
-  class Service : public TypeErasedService {
+  class Service : public ::eventuals::grpc::Service {
+   public:
+    ::eventuals::Task::Of<void> Serve() override {
+      return [this]() {
+        return ::eventuals::DoAll(
+                   // SayHello
+                   server()
+                       .Accept<
+                           helloworld::Greeter,
+                           helloworld::HelloRequest,
+                           helloworld::HelloReply>(
+                           "SayHello",
+                           "*",
+                           ConcurrencyLimitFor("SayHello"))
+                   | ::eventuals::Concurrent([this]() {
+                       return ::eventuals::Map(::eventuals::Let(
+                           [this, executor = ExecutorFor("SayHello")](
+                               auto& call) {
+                             return ::eventuals::grpc::UnaryPrologue(call)
+                                 | ::eventuals::Then(::eventuals::Let(
+                                     [&](auto& request) {
+                                       return call.template Interruptible<
+                                           HelloReply>(
+                                           ::eventuals::grpc::OnExecutor(
+                                               executor,
+                                               [&]() {
+                                                 return implementation()
+                                                     ->SayHello(
+                                                         call.handler_context(),
+                                                         std::move(request));
+                                               }));
+                                     }))
+                                 | ::eventuals::grpc::UnaryEpilogue(call);
+                           }));
+                     })
+                   | ::eventuals::Loop())
+            | ::eventuals::Just(); // Return 'void'.
+      };
+    }
+
+    char const* name() override {
+      return Greeter::service_full_name();
+    }
+
+   private:
+    Implementation* implementation() {
+      static_assert(std::is_base_of_v<Service, Implementation>);
+      return static_cast<Implementation*>(this);
+    }
+  };
+
+  // Opt-in alternative to 'Service' that type erases each call as a
+  // 'Task' via the virtual methods of 'TypeErasedService'.
+  template <typename Implementation>
+  class TypeErased : public TypeErasedService {
     ::eventuals::Task::Of<HelloReply> TypeErasedSayHello(
         std::tuple<
             TypeErasedService*,
-            ::grpc::GenericServerContext*,
+            ::eventuals::grpc::HandlerContext,
             HelloRequest*>* args) override {
       return [args]() {
         return ::eventuals::Then([args]() mutable {
           return std::apply(
-              [](auto* implementation, auto* context, auto* request) {
-                static_assert(std::is_base_of_v<Service, Implementation>);
-                return dynamic_cast<Implementation*>(implementation)
+              [](auto* implementation, auto context, auto* request) {
+                static_assert(std::is_base_of_v<TypeErased, Implementation>);
+                return static_cast<Implementation*>(implementation)
                     ->SayHello(context, std::move(*request));
               },
               *args);
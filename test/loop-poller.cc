@@ -0,0 +1,118 @@
+#include <thread>
+
+#include "eventuals/grpc/client.h"
+#include "eventuals/grpc/loop-poller.h"
+#include "eventuals/grpc/server.h"
+#include "eventuals/head.h"
+#include "eventuals/let.h"
+#include "eventuals/then.h"
+#include "examples/protos/helloworld.grpc.pb.h"
+#include "gtest/gtest.h"
+#include "test/test.h"
+#include "uv.h"
+
+using helloworld::Greeter;
+using helloworld::HelloReply;
+using helloworld::HelloRequest;
+
+using eventuals::Head;
+using eventuals::Let;
+using eventuals::Terminate;
+using eventuals::Then;
+
+using eventuals::grpc::Client;
+using eventuals::grpc::ClientScheduling;
+using eventuals::grpc::LoopPoller;
+using eventuals::grpc::Poller;
+using eventuals::grpc::ServerBuilder;
+
+// Tests that a call started on the thread running a libuv loop with
+// a 'LoopPoller' completes on that same thread.
+TEST_F(EventualsGrpcTest, LoopPoller) {
+  ServerBuilder builder;
+
+  int port = 0;
+
+  builder.AddListeningPort(
+      "0.0.0.0:0",
+      grpc::InsecureServerCredentials(),
+      &port);
+
+  auto build = builder.BuildAndStart();
+
+  ASSERT_TRUE(build.status.ok());
+
+  auto server = std::move(build.server);
+
+  auto serve = [&]() {
+    return server->Accept<Greeter, HelloRequest, HelloReply>("SayHello")
+        | Head()
+        | Then(Let([](auto& call) {
+             return UnaryPrologue(call)
+                 | Then([](auto&& request) {
+                      HelloReply reply;
+                      reply.set_message("Hello " + request.name());
+                      return reply;
+                    })
+                 | UnaryEpilogue(call);
+           }));
+  };
+
+  auto [cancelled, k] = Terminate(serve());
+
+  k.Start();
+
+  uv_loop_t loop;
+
+  ASSERT_EQ(0, uv_loop_init(&loop));
+
+  auto poller = std::make_unique<LoopPoller>(&loop);
+
+  poller->Start();
+
+  Client client(
+      "0.0.0.0:" + std::to_string(port),
+      grpc::InsecureChannelCredentials(),
+      ClientScheduling::CurrentCompletionQueue);
+
+  auto thread = std::this_thread::get_id();
+
+  auto call = [&]() {
+    HelloRequest request;
+    request.set_name("emily");
+    return client.Unary<Greeter, HelloRequest, HelloReply>(
+               "SayHello",
+               std::move(request))
+        | Then([&](auto&& result) {
+             EXPECT_EQ(thread, std::this_thread::get_id());
+             EXPECT_EQ(&poller->poller(), Poller::Current());
+
+             // Nothing else to poll for so shutdown which lets
+             // 'uv_run()' return once the completion queue has been
+             // drained.
+             poller->Shutdown();
+
+             return std::move(result);
+           });
+  };
+
+  auto [future, call_k] = Terminate(call());
+
+  // NOTE: starting the call on the thread that will run the loop.
+  call_k.Start();
+
+  uv_run(&loop, UV_RUN_DEFAULT);
+
+  auto result = future.get();
+
+  EXPECT_TRUE(result.status.ok()) << result.status.error_message();
+  EXPECT_EQ("Hello emily", result.response.message());
+
+  EXPECT_EQ(nullptr, Poller::Current());
+
+  poller.reset();
+
+  EXPECT_EQ(0, uv_loop_close(&loop));
+
+  EXPECT_FALSE(cancelled.get());
+}
@@ -0,0 +1,95 @@
+#include <future>
+#include <thread>
+
+#include "eventuals/grpc/completion-pool.h"
+#include "eventuals/grpc/server.h"
+#include "gtest/gtest.h"
+#include "test/test.h"
+
+using stout::Borrowable;
+
+using eventuals::grpc::CompletionPool;
+using eventuals::grpc::Poller;
+using eventuals::grpc::ServerBuilder;
+
+TEST_F(EventualsGrpcTest, CompletionPoolMaintenance) {
+  // NOTE: declared before 'pool' so that they outlive any
+  // maintenance that runs before the pool gets shutdown.
+  std::promise<std::thread::id> promise;
+
+  size_t count = 0;
+
+  Borrowable<CompletionPool> pool(std::chrono::milliseconds(1));
+
+  ASSERT_FALSE(pool->pollers().empty());
+
+  auto& poller = pool->pollers().front();
+
+  poller->Every(
+      std::chrono::milliseconds(5),
+      [&, poller = poller.get()]() {
+        EXPECT_EQ(poller, Poller::Current());
+        if (++count == 3) {
+          promise.set_value(std::this_thread::get_id());
+        }
+      });
+
+  auto id = promise.get_future().get();
+
+  EXPECT_NE(std::this_thread::get_id(), id);
+}
+
+TEST_F(EventualsGrpcTest, ServerMaintenance) {
+  // NOTE: declared before 'server' so that they outlive any
+  // maintenance that runs before the server gets shutdown.
+  std::promise<void> promises[2];
+
+  ServerBuilder builder;
+
+  builder.AddListeningPort("0.0.0.0:0", grpc::InsecureServerCredentials());
+
+  builder.SetNumberOfCompletionQueues(2);
+
+  builder.SetCompletionQueueTick(std::chrono::milliseconds(1));
+
+  auto build = builder.BuildAndStart();
+
+  ASSERT_TRUE(build.status.ok());
+
+  auto server = std::move(build.server);
+
+  ASSERT_TRUE(server);
+
+  ASSERT_EQ(2, server->pollers().size());
+
+  for (size_t i = 0; i < 2; i++) {
+    server->pollers()[i]->Every(
+        std::chrono::milliseconds(1),
+        [&promise = promises[i], done = false]() mutable {
+          if (!done) {
+            promise.set_value();
+            done = true;
+          }
+        });
+  }
+
+  for (auto& promise : promises) {
+    promise.get_future().wait();
+  }
+}
+
+TEST_F(EventualsGrpcTest, ServerInvalidCompletionQueueTick) {
+  ServerBuilder builder;
+
+  builder.AddListeningPort("0.0.0.0:0", grpc::InsecureServerCredentials());
+
+  builder.SetCompletionQueueTick(std::chrono::milliseconds(0));
+
+  auto build = builder.BuildAndStart();
+
+  ASSERT_FALSE(build.status.ok());
+
+  EXPECT_EQ(
+      "Error building server: completion queue tick must be positive",
+      build.status.error());
+}
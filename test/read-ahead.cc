@@ -0,0 +1,339 @@
+#include <memory>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "eventuals/grpc/client.h"
+#include "eventuals/grpc/read-ahead.h"
+#include "eventuals/grpc/server.h"
+#include "eventuals/head.h"
+#include "eventuals/iterate.h"
+#include "eventuals/let.h"
+#include "eventuals/loop.h"
+#include "eventuals/map.h"
+#include "eventuals/then.h"
+#include "examples/protos/keyvaluestore.grpc.pb.h"
+#include "gtest/gtest.h"
+#include "test/test.h"
+
+using stout::Borrowable;
+
+using eventuals::Head;
+using eventuals::Iterate;
+using eventuals::Let;
+using eventuals::Loop;
+using eventuals::Map;
+using eventuals::Terminate;
+using eventuals::Then;
+
+using eventuals::grpc::Client;
+using eventuals::grpc::ClientReader;
+using eventuals::grpc::CompletionPool;
+using eventuals::grpc::ReadAheadOptions;
+using eventuals::grpc::ServerBuilder;
+using eventuals::grpc::ServerReader;
+using eventuals::grpc::Stream;
+using eventuals::grpc::Tag;
+using eventuals::grpc::_ReadAhead;
+
+// 'Read({})' must read ahead with the default options rather than
+// resolve to some other overload of 'Read()'.
+static_assert(!std::is_void_v<decltype(
+                  std::declval<ServerReader<keyvaluestore::Request>&>()
+                      .Read({}))>);
+
+static_assert(!std::is_void_v<decltype(
+                  std::declval<ClientReader<keyvaluestore::Response>&>()
+                      .Read({}))>);
+
+// Tests reading ahead on both the server and the client with a buffer
+// that is much smaller than the number of messages so that reading
+// ahead has to stop (and later resume) on both sides.
+TEST_F(EventualsGrpcTest, ReadAhead) {
+  ServerBuilder builder;
+
+  int port = 0;
+
+  builder.AddListeningPort(
+      "0.0.0.0:0",
+      grpc::InsecureServerCredentials(),
+      &port);
+
+  auto build = builder.BuildAndStart();
+
+  ASSERT_TRUE(build.status.ok());
+
+  auto server = std::move(build.server);
+
+  ASSERT_TRUE(server);
+
+  auto serve = [&]() {
+    return server->Accept<
+               Stream<keyvaluestore::Request>,
+               Stream<keyvaluestore::Response>>(
+               "keyvaluestore.KeyValueStore.GetValues")
+        | Head()
+        | Then(Let([](auto& call) {
+             return call.Reader().Read(ReadAheadOptions{2, 1024})
+                 | Map([](auto&& request) {
+                      keyvaluestore::Response response;
+                      response.set_value(request.key());
+                      return response;
+                    })
+                 | StreamingEpilogue(call);
+           }));
+  };
+
+  auto [cancelled, k] = Terminate(serve());
+
+  k.Start();
+
+  Borrowable<CompletionPool> pool;
+
+  Client client(
+      "0.0.0.0:" + std::to_string(port),
+      grpc::InsecureChannelCredentials(),
+      pool.Borrow());
+
+  std::vector<std::string> keys;
+  for (size_t i = 0; i < 10; i++) {
+    keys.push_back(std::to_string(i));
+  }
+
+  std::vector<std::string> values;
+
+  auto call = [&]() {
+    return client.Call<
+               Stream<keyvaluestore::Request>,
+               Stream<keyvaluestore::Response>>(
+               "keyvaluestore.KeyValueStore.GetValues")
+        | Then(Let([&](auto& call) {
+             return Iterate(keys)
+                 | Map([&](auto& key) {
+                      keyvaluestore::Request request;
+                      request.set_key(key);
+                      return call.Writer().Write(request);
+                    })
+                 | Loop()
+                 | call.WritesDone()
+                 | call.Reader().Read(ReadAheadOptions{3, 16})
+                 | Map([&](auto&& response) {
+                      values.push_back(response.value());
+                    })
+                 | Loop()
+                 | call.Finish();
+           }));
+  };
+
+  auto status = *call();
+
+  EXPECT_TRUE(status.ok()) << status.error_message();
+
+  EXPECT_EQ(keys, values);
+
+  EXPECT_FALSE(cancelled.get());
+}
+
+////////////////////////////////////////////////////////////////////////
+
+// Reads whose completion is up to the test (rather than gRPC) so that
+// exactly when reads get issued, and thus what gets buffered ahead of
+// the consumer, can be observed.
+struct Reads {
+  bool outstanding() const {
+    return tag != nullptr;
+  }
+
+  // Completes the outstanding read with 'message', or with 'ok' being
+  // false (i.e., the end of the stream) if there isn't one.
+  void Complete(std::optional<std::string> message) {
+    ASSERT_TRUE(outstanding());
+    Tag* completed = std::exchange(tag, nullptr);
+    if (message) {
+      *buffer = std::move(message.value());
+      (*completed)(true);
+    } else {
+      (*completed)(false);
+    }
+  }
+
+  std::string* buffer = nullptr;
+  Tag* tag = nullptr;
+  size_t issued = 0;
+};
+
+// Stands in for the continuation that consumes what gets read.
+struct Consumer {
+  void Emit(std::string&& value) {
+    values.push_back(std::move(value));
+  }
+
+  void Ended() {
+    ended = true;
+  }
+
+  template <typename Error>
+  void Fail(Error&&) {
+    ADD_FAILURE() << "Unexpected failure";
+  }
+
+  std::vector<std::string> values;
+  bool ended = false;
+};
+
+static auto ReadingAhead(ReadAheadOptions options, Reads& reads) {
+  auto read = [&reads](std::string* buffer, Tag* tag) {
+    EXPECT_FALSE(reads.outstanding()) << "more than one read outstanding";
+    reads.buffer = buffer;
+    reads.tag = tag;
+    reads.issued++;
+  };
+
+  auto size = [](const std::string& buffer) {
+    return buffer.size();
+  };
+
+  auto parse = [](std::string&& buffer) {
+    return std::optional<std::string>(std::move(buffer));
+  };
+
+  using State = _ReadAhead::State<
+      std::string,
+      std::string,
+      decltype(read),
+      decltype(size),
+      decltype(parse)>;
+
+  return std::make_shared<State>(options, read, size, parse);
+}
+
+////////////////////////////////////////////////////////////////////////
+
+// Reading ahead issues the next read before the consumer asks for it,
+// stops once 'messages' are buffered, and resumes as soon as the
+// consumer takes one.
+TEST_F(EventualsGrpcTest, ReadAheadBoundedByMessages) {
+  Reads reads;
+
+  auto state = ReadingAhead(ReadAheadOptions{3, 1024}, reads);
+
+  Consumer consumer;
+
+  // Nothing gets read until the consumer first asks.
+  EXPECT_EQ(0, reads.issued);
+
+  state->Next(consumer);
+
+  EXPECT_EQ(1, reads.issued);
+
+  reads.Complete("0");
+
+  // The first message went straight to the consumer, which hasn't
+  // asked for another one yet but the next read is already issued.
+  EXPECT_EQ(std::vector<std::string>({"0"}), consumer.values);
+  EXPECT_TRUE(reads.outstanding());
+
+  reads.Complete("1");
+  reads.Complete("2");
+
+  EXPECT_EQ(2, state->buffered.size());
+  EXPECT_TRUE(reads.outstanding());
+
+  reads.Complete("3");
+
+  // At most 'messages' get buffered, after which reading stops.
+  EXPECT_EQ(3, state->buffered.size());
+  EXPECT_FALSE(reads.outstanding());
+  EXPECT_EQ(4, reads.issued);
+
+  // Taking a message resumes reading.
+  state->Next(consumer);
+
+  EXPECT_EQ(std::vector<std::string>({"0", "1"}), consumer.values);
+  EXPECT_EQ(2, state->buffered.size());
+  EXPECT_TRUE(reads.outstanding());
+  EXPECT_EQ(5, reads.issued);
+
+  // End of stream, everything buffered still gets consumed.
+  reads.Complete(std::nullopt);
+
+  state->Next(consumer);
+  state->Next(consumer);
+
+  EXPECT_FALSE(consumer.ended);
+
+  state->Next(consumer);
+
+  EXPECT_EQ(
+      std::vector<std::string>({"0", "1", "2", "3"}),
+      consumer.values);
+  EXPECT_TRUE(consumer.ended);
+  EXPECT_FALSE(reads.outstanding());
+  EXPECT_EQ(5, reads.issued);
+}
+
+////////////////////////////////////////////////////////////////////////
+
+// Reading ahead stops once 'bytes' are buffered (even though fewer
+// than 'messages' are) and resumes once some have been consumed. A
+// message larger than 'bytes' still gets read once the buffer is
+// empty.
+TEST_F(EventualsGrpcTest, ReadAheadBoundedByBytes) {
+  Reads reads;
+
+  auto state = ReadingAhead(ReadAheadOptions{16, 4}, reads);
+
+  Consumer consumer;
+
+  state->Next(consumer);
+
+  reads.Complete("aa");
+
+  EXPECT_EQ(std::vector<std::string>({"aa"}), consumer.values);
+
+  reads.Complete("bb");
+
+  EXPECT_EQ(2, state->bytes);
+  EXPECT_TRUE(reads.outstanding());
+
+  reads.Complete("cc");
+
+  // At most 'bytes' get buffered, after which reading stops.
+  EXPECT_EQ(2, state->buffered.size());
+  EXPECT_EQ(4, state->bytes);
+  EXPECT_FALSE(reads.outstanding());
+
+  // Taking a message resumes reading.
+  state->Next(consumer);
+
+  EXPECT_EQ(2, state->bytes);
+  EXPECT_TRUE(reads.outstanding());
+
+  reads.Complete("dddddd");
+
+  EXPECT_EQ(8, state->bytes);
+  EXPECT_FALSE(reads.outstanding());
+
+  // Still over 'bytes' after taking a message so no read ...
+  state->Next(consumer);
+
+  EXPECT_EQ(6, state->bytes);
+  EXPECT_FALSE(reads.outstanding());
+
+  // ... until the buffer is empty.
+  state->Next(consumer);
+
+  EXPECT_EQ(0, state->bytes);
+  EXPECT_TRUE(reads.outstanding());
+
+  reads.Complete(std::nullopt);
+
+  state->Next(consumer);
+
+  EXPECT_EQ(
+      std::vector<std::string>({"aa", "bb", "cc", "dddddd"}),
+      consumer.values);
+  EXPECT_TRUE(consumer.ended);
+}
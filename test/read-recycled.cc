@@ -0,0 +1,129 @@
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "eventuals/grpc/client.h"
+#include "eventuals/grpc/server.h"
+#include "eventuals/head.h"
+#include "eventuals/iterate.h"
+#include "eventuals/let.h"
+#include "eventuals/loop.h"
+#include "eventuals/map.h"
+#include "eventuals/then.h"
+#include "examples/protos/keyvaluestore.grpc.pb.h"
+#include "gtest/gtest.h"
+#include "test/test.h"
+
+using stout::Borrowable;
+
+using eventuals::Head;
+using eventuals::Iterate;
+using eventuals::Let;
+using eventuals::Loop;
+using eventuals::Map;
+using eventuals::Terminate;
+using eventuals::Then;
+
+using eventuals::grpc::Client;
+using eventuals::grpc::CompletionPool;
+using eventuals::grpc::ServerBuilder;
+using eventuals::grpc::Stream;
+
+// Tests that both the server and the client emit the same (reused)
+// message object for every message while still emitting the right
+// contents for each.
+TEST_F(EventualsGrpcTest, ReadRecycled) {
+  ServerBuilder builder;
+
+  int port = 0;
+
+  builder.AddListeningPort(
+      "0.0.0.0:0",
+      grpc::InsecureServerCredentials(),
+      &port);
+
+  auto build = builder.BuildAndStart();
+
+  ASSERT_TRUE(build.status.ok());
+
+  auto server = std::move(build.server);
+
+  ASSERT_TRUE(server);
+
+  auto serve = [&]() {
+    return server->Accept<
+               Stream<keyvaluestore::Request>,
+               Stream<keyvaluestore::Response>>(
+               "keyvaluestore.KeyValueStore.GetValues")
+        | Head()
+        | Then(Let([](auto& call) {
+             return call.Reader().ReadRecycled()
+                 | Map([recycled = (const void*) nullptr](
+                           auto&& request) mutable {
+                      if (recycled == nullptr) {
+                        recycled = &request;
+                      }
+                      EXPECT_EQ(recycled, &request);
+                      keyvaluestore::Response response;
+                      response.set_value(request.key());
+                      return response;
+                    })
+                 | StreamingEpilogue(call);
+           }));
+  };
+
+  auto [cancelled, k] = Terminate(serve());
+
+  k.Start();
+
+  Borrowable<CompletionPool> pool;
+
+  Client client(
+      "0.0.0.0:" + std::to_string(port),
+      grpc::InsecureChannelCredentials(),
+      pool.Borrow());
+
+  std::vector<std::string> keys;
+  for (size_t i = 0; i < 10; i++) {
+    keys.push_back(std::to_string(i));
+  }
+
+  std::vector<std::string> values;
+
+  std::optional<const void*> recycled;
+
+  auto call = [&]() {
+    return client.Call<
+               Stream<keyvaluestore::Request>,
+               Stream<keyvaluestore::Response>>(
+               "keyvaluestore.KeyValueStore.GetValues")
+        | Then(Let([&](auto& call) {
+             return Iterate(keys)
+                 | Map([&](auto& key) {
+                      keyvaluestore::Request request;
+                      request.set_key(key);
+                      return call.Writer().Write(request);
+                    })
+                 | Loop()
+                 | call.WritesDone()
+                 | call.Reader().ReadRecycled()
+                 | Map([&](auto&& response) {
+                      if (!recycled) {
+                        recycled = &response;
+                      }
+                      EXPECT_EQ(recycled.value(), &response);
+                      values.push_back(response.value());
+                    })
+                 | Loop()
+                 | call.Finish();
+           }));
+  };
+
+  auto status = *call();
+
+  EXPECT_TRUE(status.ok()) << status.error_message();
+
+  EXPECT_EQ(keys, values);
+
+  EXPECT_FALSE(cancelled.get());
+}
@@ -0,0 +1,185 @@
+#include <string>
+
+#include "eventuals/grpc/client.h"
+#include "eventuals/grpc/recorder.h"
+#include "eventuals/grpc/server.h"
+#include "eventuals/head.h"
+#include "eventuals/let.h"
+#include "eventuals/then.h"
+#include "examples/protos/helloworld.grpc.pb.h"
+#include "gtest/gtest.h"
+#include "test/test.h"
+
+using helloworld::Greeter;
+using helloworld::HelloReply;
+using helloworld::HelloRequest;
+
+using stout::Borrowable;
+
+using eventuals::Head;
+using eventuals::Let;
+using eventuals::Terminate;
+using eventuals::Then;
+
+using eventuals::grpc::Client;
+using eventuals::grpc::CompletionPool;
+using eventuals::grpc::Recorder;
+using eventuals::grpc::Recording;
+using eventuals::grpc::ServerBuilder;
+
+TEST(RecordingTest, Roundtrip) {
+  std::string path = ::testing::TempDir() + "/roundtrip.recording";
+
+  {
+    auto recorder = Recorder::Open(path);
+
+    ASSERT_TRUE(recorder);
+
+    auto call = recorder->Call("/helloworld.Greeter/SayHello", "localhost");
+
+    HelloRequest request;
+    request.set_name("emily");
+
+    ::grpc::ByteBuffer buffer;
+    bool own = true;
+    ASSERT_TRUE(::grpc::SerializationTraits<HelloRequest>::Serialize(
+                    request,
+                    &buffer,
+                    &own)
+                    .ok());
+
+    recorder->Request(call, buffer);
+  }
+
+  auto reader = Recording::Reader::Open(path);
+
+  ASSERT_TRUE(reader);
+
+  auto record = reader->Next();
+
+  ASSERT_TRUE(record);
+  EXPECT_EQ(Recording::Type::Call, record->type);
+  EXPECT_EQ("/helloworld.Greeter/SayHello", record->method);
+  EXPECT_EQ("localhost", record->host);
+
+  auto call = record->call;
+
+  record = reader->Next();
+
+  ASSERT_TRUE(record);
+  EXPECT_EQ(Recording::Type::Request, record->type);
+  EXPECT_EQ(call, record->call);
+
+  HelloRequest request;
+  EXPECT_TRUE(request.ParseFromString(record->request));
+  EXPECT_EQ("emily", request.name());
+
+  EXPECT_FALSE(reader->Next());
+}
+
+TEST(RecordingTest, NotARecording) {
+  EXPECT_FALSE(Recording::Reader::Open("/does/not/exist"));
+}
+
+TEST_F(EventualsGrpcTest, ServerRecording) {
+  std::string path = ::testing::TempDir() + "/server.recording";
+
+  ServerBuilder builder;
+
+  int port = 0;
+
+  builder.AddListeningPort(
+      "0.0.0.0:0",
+      grpc::InsecureServerCredentials(),
+      &port);
+
+  builder.SetRecording(path);
+
+  auto build = builder.BuildAndStart();
+
+  ASSERT_TRUE(build.status.ok()) << build.status.error();
+
+  auto server = std::move(build.server);
+
+  auto serve = [&]() {
+    return server->Accept<Greeter, HelloRequest, HelloReply>("SayHello")
+        | Head()
+        | Then(Let([](auto& call) {
+             return UnaryPrologue(call)
+                 | Then([](auto&& request) {
+                      HelloReply reply;
+                      reply.set_message("Hello " + request.name());
+                      return reply;
+                    })
+                 | UnaryEpilogue(call);
+           }));
+  };
+
+  auto [cancelled, k] = Terminate(serve());
+
+  k.Start();
+
+  Borrowable<CompletionPool> pool;
+
+  Client client(
+      "0.0.0.0:" + std::to_string(port),
+      grpc::InsecureChannelCredentials(),
+      pool.Borrow());
+
+  auto call = [&]() {
+    HelloRequest request;
+    request.set_name("emily");
+    return client.Unary<Greeter, HelloRequest, HelloReply>(
+        "SayHello",
+        std::move(request));
+  };
+
+  auto result = *call();
+
+  ASSERT_TRUE(result.status.ok()) << result.status.error_message();
+
+  EXPECT_FALSE(cancelled.get());
+
+  // Destructing the server closes (and thus flushes) the recording.
+  server.reset();
+
+  auto reader = Recording::Reader::Open(path);
+
+  ASSERT_TRUE(reader);
+
+  auto record = reader->Next();
+
+  ASSERT_TRUE(record);
+  EXPECT_EQ(Recording::Type::Call, record->type);
+  EXPECT_EQ("/helloworld.Greeter/SayHello", record->method);
+
+  record = reader->Next();
+
+  ASSERT_TRUE(record);
+  EXPECT_EQ(Recording::Type::Request, record->type);
+
+  HelloRequest request;
+  EXPECT_TRUE(request.ParseFromString(record->request));
+  EXPECT_EQ("emily", request.name());
+
+  EXPECT_FALSE(reader->Next());
+}
+
+TEST_F(EventualsGrpcTest, ServerRecordingFailsToOpen) {
+  ServerBuilder builder;
+
+  builder.AddListeningPort(
+      "0.0.0.0:0",
+      grpc::InsecureServerCredentials());
+
+  builder.SetRecording("/does/not/exist/recording");
+
+  auto build = builder.BuildAndStart();
+
+  ASSERT_FALSE(build.status.ok());
+
+  EXPECT_EQ(
+      "Error building server: failed to open recording "
+      "'/does/not/exist/recording'",
+      build.status.error());
+}
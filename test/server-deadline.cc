@@ -0,0 +1,194 @@
+#include <atomic>
+#include <future>
+
+#include "eventuals/grpc/client.h"
+#include "eventuals/grpc/server.h"
+#include "eventuals/grpc/timer.h"
+#include "eventuals/head.h"
+#include "eventuals/let.h"
+#include "eventuals/loop.h"
+#include "eventuals/map.h"
+#include "eventuals/task.h"
+#include "eventuals/terminal.h"
+#include "eventuals/then.h"
+#include "examples/protos/helloworld.grpc.pb.h"
+#include "gtest/gtest.h"
+#include "test/test.h"
+
+using helloworld::Greeter;
+using helloworld::HelloReply;
+using helloworld::HelloRequest;
+
+using stout::Borrowable;
+
+using eventuals::Head;
+using eventuals::Let;
+using eventuals::Loop;
+using eventuals::Map;
+using eventuals::Task;
+using eventuals::Terminate;
+using eventuals::Then;
+
+using eventuals::grpc::Client;
+using eventuals::grpc::CompletionPool;
+using eventuals::grpc::ServerBuilder;
+using eventuals::grpc::Timer;
+
+TEST_F(EventualsGrpcTest, DropExpiredBeforeDequeue) {
+  ServerBuilder builder;
+
+  int port = 0;
+
+  builder.AddListeningPort(
+      "0.0.0.0:0",
+      grpc::InsecureServerCredentials(),
+      &port);
+
+  auto build = builder.BuildAndStart();
+
+  ASSERT_TRUE(build.status.ok());
+
+  auto server = std::move(build.server);
+
+  ASSERT_TRUE(server);
+
+  std::atomic<size_t> handled = 0;
+
+  std::promise<void> handling;
+
+  // Handle calls one at a time so that the second call has to wait in
+  // the endpoint until the first call is done.
+  auto serve = [&]() {
+    return server->Accept<Greeter, HelloRequest, HelloReply>("SayHello")
+        | Map(Let([&](auto& call) {
+             if (handled++ == 0) {
+               handling.set_value();
+             }
+             return call.WaitForDone();
+           }))
+        | Loop();
+  };
+
+  auto [served, k] = Terminate(serve());
+
+  k.Start();
+
+  Borrowable<CompletionPool> pool;
+
+  Client client(
+      "0.0.0.0:" + std::to_string(port),
+      grpc::InsecureChannelCredentials(),
+      pool.Borrow());
+
+  auto call = [&](std::chrono::milliseconds timeout) {
+    return client.Context()
+        | Then([&, timeout](auto* context) {
+             auto now = std::chrono::system_clock::now();
+             context->set_deadline(now + timeout);
+
+             return client.Call<Greeter, HelloRequest, HelloReply>(
+                        "SayHello",
+                        context)
+                 | Then(Let([](auto& call) {
+                      HelloRequest request;
+                      request.set_name("emily");
+                      return call.Writer().WriteLast(request)
+                          | call.Finish();
+                    }));
+           });
+  };
+
+  auto [first, k1] = Terminate(call(std::chrono::milliseconds(500)));
+
+  k1.Start();
+
+  handling.get_future().wait();
+
+  auto [second, k2] = Terminate(call(std::chrono::milliseconds(100)));
+
+  k2.Start();
+
+  EXPECT_EQ(grpc::DEADLINE_EXCEEDED, first.get().error_code());
+  EXPECT_EQ(grpc::DEADLINE_EXCEEDED, second.get().error_code());
+
+  server->Shutdown();
+  server->Wait();
+
+  EXPECT_EQ(1, handled.load());
+}
+
+TEST_F(EventualsGrpcTest, InterruptedByDeadline) {
+  ServerBuilder builder;
+
+  int port = 0;
+
+  builder.AddListeningPort(
+      "0.0.0.0:0",
+      grpc::InsecureServerCredentials(),
+      &port);
+
+  builder.SetCompletionQueueTick(std::chrono::milliseconds(1));
+
+  auto build = builder.BuildAndStart();
+
+  ASSERT_TRUE(build.status.ok());
+
+  auto server = std::move(build.server);
+
+  ASSERT_TRUE(server);
+
+  auto serve = [&]() {
+    return server->Accept<Greeter, HelloRequest, HelloReply>("SayHello")
+        | Head()
+        | Then(Let([](auto& call) {
+             return UnaryPrologue(call)
+                 | Then([&](auto&&) {
+                      return call.Interruptible(
+                          Task::Of<HelloReply>([]() {
+                            return Timer(std::chrono::seconds(10))
+                                | Then([]() {
+                                     return HelloReply();
+                                   });
+                          }));
+                    })
+                 | UnaryEpilogue(call);
+           }));
+  };
+
+  auto [cancelled, k] = Terminate(serve());
+
+  k.Start();
+
+  Borrowable<CompletionPool> pool;
+
+  Client client(
+      "0.0.0.0:" + std::to_string(port),
+      grpc::InsecureChannelCredentials(),
+      pool.Borrow());
+
+  auto call = [&]() {
+    return client.Context()
+        | Then([&](auto* context) {
+             auto now = std::chrono::system_clock::now();
+             context->set_deadline(now + std::chrono::milliseconds(100));
+
+             return client.Call<Greeter, HelloRequest, HelloReply>(
+                        "SayHello",
+                        context)
+                 | Then(Let([](auto& call) {
+                      HelloRequest request;
+                      request.set_name("emily");
+                      return call.Writer().WriteLast(request)
+                          | call.Finish();
+                    }));
+           });
+  };
+
+  auto status = *call();
+
+  EXPECT_EQ(grpc::DEADLINE_EXCEEDED, status.error_code());
+
+  // Wouldn't complete for 10 seconds if the timer wasn't interrupted
+  // and the test would time out.
+  EXPECT_TRUE(cancelled.get());
+}
@@ -1,11 +1,19 @@
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
 #include "eventuals/closure.h"
+#include "eventuals/conditional.h"
 #include "eventuals/grpc/client.h"
 #include "eventuals/grpc/server.h"
 #include "eventuals/head.h"
 #include "eventuals/iterate.h"
+#include "eventuals/just.h"
 #include "eventuals/let.h"
 #include "eventuals/loop.h"
 #include "eventuals/map.h"
+#include "eventuals/raise.h"
 #include "eventuals/then.h"
 #include "examples/protos/keyvaluestore.grpc.pb.h"
 #include "gtest/gtest.h"
@@ -14,11 +22,14 @@
 using stout::Borrowable;
 
 using eventuals::Closure;
+using eventuals::Conditional;
 using eventuals::Head;
 using eventuals::Iterate;
+using eventuals::Just;
 using eventuals::Let;
 using eventuals::Loop;
 using eventuals::Map;
+using eventuals::Raise;
 using eventuals::Terminate;
 using eventuals::Then;
 
@@ -369,3 +380,136 @@ TEST_F(EventualsGrpcTest, Streaming_WritesDone_BeforeReply_TwoRequests) {
             | call.Finish();
       })));
 }
+
+// Serves 'GetValues' by responding to each request via
+// 'StreamingEpilogue()' where a request for the key "fail" fails the
+// call, and then runs 'handler' as the client with a deadline so that
+// a response that never gets written fails rather than hangs.
+template <typename Handler>
+void test_streaming_epilogue(Handler handler, grpc::StatusCode expected) {
+  ServerBuilder builder;
+
+  int port = 0;
+
+  builder.AddListeningPort(
+      "0.0.0.0:0",
+      grpc::InsecureServerCredentials(),
+      &port);
+
+  auto build = builder.BuildAndStart();
+
+  ASSERT_TRUE(build.status.ok());
+
+  auto server = std::move(build.server);
+
+  ASSERT_TRUE(server);
+
+  auto serve = [&]() {
+    return server->Accept<
+               Stream<keyvaluestore::Request>,
+               Stream<keyvaluestore::Response>>(
+               "keyvaluestore.KeyValueStore.GetValues")
+        | Head()
+        | Then(Let([](auto& call) {
+             return call.Reader().Read()
+                 | Map(Conditional(
+                     [](auto& request) {
+                       return request.key() == "fail";
+                     },
+                     [](auto&&) {
+                       return Raise(std::runtime_error("fail"));
+                     },
+                     [](auto&& request) {
+                       keyvaluestore::Response response;
+                       response.set_value(request.key());
+                       return Just(std::move(response));
+                     }))
+                 | StreamingEpilogue(call);
+           }));
+  };
+
+  auto [cancelled, k] = Terminate(serve());
+
+  k.Start();
+
+  Borrowable<CompletionPool> pool;
+
+  Client client(
+      "0.0.0.0:" + std::to_string(port),
+      grpc::InsecureChannelCredentials(),
+      pool.Borrow());
+
+  auto call = [&]() {
+    return client.Context()
+        | Then([&](auto* context) {
+             context->set_deadline(
+                 std::chrono::system_clock::now()
+                 + std::chrono::seconds(5));
+             return client.Call<
+                        Stream<keyvaluestore::Request>,
+                        Stream<keyvaluestore::Response>>(
+                        "keyvaluestore.KeyValueStore.GetValues",
+                        context)
+                 | std::move(handler);
+           });
+  };
+
+  auto status = *call();
+
+  EXPECT_EQ(expected, status.error_code()) << status.error_message();
+
+  EXPECT_FALSE(cancelled.get());
+}
+
+// Each response must be written as soon as it's produced, i.e., the
+// client gets the response to its first request before it sends the
+// next one.
+TEST_F(EventualsGrpcTest, StreamingEpilogue_WritesEachResponse) {
+  test_streaming_epilogue(
+      Then(Let([](auto& call) {
+        keyvaluestore::Request request1;
+        request1.set_key("1");
+        return call.Writer().Write(request1)
+            | call.Reader().Read()
+            | Head()
+            | Then([&](auto&& response) {
+                 EXPECT_EQ("1", response.value());
+                 keyvaluestore::Request request2;
+                 request2.set_key("2");
+                 return call.Writer().WriteLast(request2);
+               })
+            | call.Reader().Read()
+            | Head()
+            | Then([](auto&& response) {
+                 EXPECT_EQ("2", response.value());
+               })
+            | call.Finish();
+      })),
+      grpc::OK);
+}
+
+// Responses produced before a failure must still be written.
+TEST_F(EventualsGrpcTest, StreamingEpilogue_Failure) {
+  std::vector<std::string> values;
+
+  test_streaming_epilogue(
+      Then(Let([&](auto& call) {
+        keyvaluestore::Request request1;
+        request1.set_key("1");
+        return call.Writer().Write(request1)
+            | Then([&]() {
+                 keyvaluestore::Request request2;
+                 request2.set_key("fail");
+                 return call.Writer().WriteLast(request2);
+               })
+            | call.Reader().Read()
+            | Map([&](auto&& response) {
+                 values.push_back(response.value());
+               })
+            | Loop()
+            | call.Finish();
+      })),
+      grpc::UNKNOWN);
+
+  EXPECT_EQ(std::vector<std::string>({"1"}), values);
+}
@@ -0,0 +1,332 @@
+#include <chrono>
+#include <future>
+
+#include "eventuals/eventual.h"
+#include "eventuals/grpc/client.h"
+#include "eventuals/grpc/poller.h"
+#include "eventuals/grpc/server.h"
+#include "eventuals/head.h"
+#include "eventuals/let.h"
+#include "eventuals/task.h"
+#include "eventuals/then.h"
+#include "grpcpp/alarm.h"
+#include "gtest/gtest.h"
+#include "test/expect-throw-what.h"
+#include "test/helloworld.eventuals.h"
+#include "test/test.h"
+
+using helloworld::HelloReply;
+using helloworld::HelloRequest;
+
+using helloworld::eventuals::Greeter;
+
+using stout::Borrowable;
+
+using eventuals::Eventual;
+using eventuals::Head;
+using eventuals::Let;
+using eventuals::Task;
+using eventuals::Terminate;
+using eventuals::Then;
+
+using eventuals::grpc::Client;
+using eventuals::grpc::CompletionPool;
+using eventuals::grpc::Endpoint;
+using eventuals::grpc::Endpoints;
+using eventuals::grpc::Poller;
+using eventuals::grpc::ServerBuilder;
+using eventuals::grpc::Tag;
+
+class ThreadPerCoreGreeterServiceImpl final
+  : public Greeter::Service<ThreadPerCoreGreeterServiceImpl> {
+ public:
+  auto SayHello(::grpc::ServerContext* context, HelloRequest&& request) {
+    // Handled on the same thread that polls the completion queue the
+    // call was accepted on.
+    EXPECT_NE(nullptr, Poller::Current());
+    HelloReply reply;
+    reply.set_message("Hello " + request.name());
+    return reply;
+  }
+};
+
+TEST_F(EventualsGrpcTest, ThreadPerCoreService) {
+  ThreadPerCoreGreeterServiceImpl service;
+
+  ServerBuilder builder;
+
+  builder.SetThreadPerCore();
+
+  builder.SetNumberOfCompletionQueues(4);
+
+  int port = 0;
+
+  builder.AddListeningPort(
+      "0.0.0.0:0",
+      grpc::InsecureServerCredentials(),
+      &port);
+
+  builder.RegisterService(&service);
+
+  auto build = builder.BuildAndStart();
+
+  ASSERT_TRUE(build.status.ok());
+
+  auto server = std::move(build.server);
+
+  ASSERT_TRUE(server);
+
+  Borrowable<CompletionPool> pool;
+
+  Client client(
+      "0.0.0.0:" + std::to_string(port),
+      grpc::InsecureChannelCredentials(),
+      pool.Borrow());
+
+  for (size_t i = 0; i < 16; i++) {
+    auto call = [&]() {
+      HelloRequest request;
+      request.set_name("emily");
+      return client.Unary<helloworld::Greeter, HelloRequest, HelloReply>(
+          "SayHello",
+          std::move(request));
+    };
+
+    auto result = *call();
+
+    ASSERT_TRUE(result.status.ok()) << result.status.error_message();
+
+    EXPECT_EQ("Hello emily", result.response.message());
+  }
+}
+
+TEST_F(EventualsGrpcTest, ThreadPerCoreSharedAccept) {
+  ServerBuilder builder;
+
+  builder.SetThreadPerCore();
+
+  builder.SetNumberOfCompletionQueues(2);
+
+  int port = 0;
+
+  builder.AddListeningPort(
+      "0.0.0.0:0",
+      grpc::InsecureServerCredentials(),
+      &port);
+
+  auto build = builder.BuildAndStart();
+
+  ASSERT_TRUE(build.status.ok());
+
+  auto server = std::move(build.server);
+
+  ASSERT_TRUE(server);
+
+  // Accepting from a thread that isn't polling one of the server's
+  // completion queues gets calls from all of them.
+  auto serve = [&]() {
+    return server->Accept<helloworld::Greeter, HelloRequest, HelloReply>(
+               "SayHello")
+        | Head()
+        | Then(Let([](auto& call) {
+             return UnaryPrologue(call)
+                 | Then([](auto&& request) {
+                      HelloReply reply;
+                      reply.set_message("Hello " + request.name());
+                      return reply;
+                    })
+                 | UnaryEpilogue(call);
+           }));
+  };
+
+  auto [cancelled, k] = Terminate(serve());
+
+  k.Start();
+
+  Borrowable<CompletionPool> pool;
+
+  Client client(
+      "0.0.0.0:" + std::to_string(port),
+      grpc::InsecureChannelCredentials(),
+      pool.Borrow());
+
+  auto call = [&]() {
+    HelloRequest request;
+    request.set_name("emily");
+    return client.Unary<helloworld::Greeter, HelloRequest, HelloReply>(
+        "SayHello",
+        std::move(request));
+  };
+
+  auto result = *call();
+
+  ASSERT_TRUE(result.status.ok()) << result.status.error_message();
+
+  EXPECT_EQ("Hello emily", result.response.message());
+
+  EXPECT_FALSE(cancelled.get());
+}
+
+// Serves 'SayHello' only after an asynchronous step that doesn't
+// complete until 'Resume()' gets called, which continues serving on
+// the thread polling the completion queue it started on and waits
+// until it has (synchronously) accepted.
+class DeferredGreeterService final : public eventuals::grpc::Service {
+ public:
+  Task::Of<void> Serve() override {
+    return [this]() {
+      return Eventual<void>()
+                 .start([this](auto& k) {
+                   using K = std::decay_t<decltype(k)>;
+                   resume_ = Tag(&k, [](void* k, bool ok) {
+                     static_cast<K*>(k)->Start();
+                   });
+                   cq_ = Poller::Current()->cq();
+                   started_.set_value();
+                 })
+          | server().Accept<helloworld::Greeter, HelloRequest, HelloReply>(
+              "SayHello")
+          | Head()
+          | Then(Let([](auto& call) {
+               return UnaryPrologue(call)
+                   | Then([](auto&& request) {
+                        HelloReply reply;
+                        reply.set_message("Hello " + request.name());
+                        return reply;
+                      })
+                   | UnaryEpilogue(call);
+             }));
+    };
+  }
+
+  char const* name() override {
+    return "DeferredGreeterService";
+  }
+
+  void Resume() {
+    started_.get_future().wait();
+
+    alarmed_ = Tag(this, [](void* service, bool ok) {
+      auto* deferred = static_cast<DeferredGreeterService*>(service);
+      deferred->resume_(ok);
+      deferred->resumed_.set_value();
+    });
+
+    alarm_.Set(cq_, std::chrono::system_clock::now(), &alarmed_);
+
+    resumed_.get_future().wait();
+  }
+
+ private:
+  std::promise<void> started_;
+  std::promise<void> resumed_;
+  ::grpc::CompletionQueue* cq_ = nullptr;
+  Tag resume_;
+  Tag alarmed_;
+  ::grpc::Alarm alarm_;
+};
+
+// A service that accepts after something asynchronous, i.e., after
+// its completion queue's endpoints have been frozen, gets calls via
+// the shared endpoints instead.
+TEST_F(EventualsGrpcTest, ThreadPerCoreAcceptAfterAsynchronous) {
+  DeferredGreeterService service;
+
+  ServerBuilder builder;
+
+  builder.SetThreadPerCore();
+
+  builder.SetNumberOfCompletionQueues(1);
+
+  int port = 0;
+
+  builder.AddListeningPort(
+      "0.0.0.0:0",
+      grpc::InsecureServerCredentials(),
+      &port);
+
+  builder.RegisterService(&service);
+
+  auto build = builder.BuildAndStart();
+
+  ASSERT_TRUE(build.status.ok());
+
+  auto server = std::move(build.server);
+
+  ASSERT_TRUE(server);
+
+  // The server has started, and thus frozen the endpoints of each of
+  // its completion queues, before the service accepts.
+  service.Resume();
+
+  Borrowable<CompletionPool> pool;
+
+  Client client(
+      "0.0.0.0:" + std::to_string(port),
+      grpc::InsecureChannelCredentials(),
+      pool.Borrow());
+
+  auto call = [&]() {
+    HelloRequest request;
+    request.set_name("emily");
+    return client.Unary<helloworld::Greeter, HelloRequest, HelloReply>(
+        "SayHello",
+        std::move(request));
+  };
+
+  auto result = *call();
+
+  ASSERT_TRUE(result.status.ok()) << result.status.error_message();
+
+  EXPECT_EQ("Hello emily", result.response.message());
+}
+
+// Each completion queue's endpoints get frozen once the server has
+// started so that they can be looked up without synchronization.
+TEST_F(EventualsGrpcTest, ThreadPerCoreFrozenEndpoints) {
+  Endpoints endpoints;
+
+  EXPECT_TRUE(endpoints.empty());
+
+  *endpoints.Insert(
+      std::make_unique<Endpoint>("/helloworld.Greeter/SayHello", "*"));
+
+  endpoints.Freeze();
+
+  EXPECT_FALSE(endpoints.empty());
+
+  auto* endpoint = endpoints.Find("/helloworld.Greeter/SayHello", "host");
+
+  ASSERT_NE(nullptr, endpoint);
+
+  EXPECT_EQ("*", endpoint->host());
+
+  EXPECT_EQ(nullptr, endpoints.Find("/helloworld.Greeter/Other", "host"));
+
+  EXPECT_THROW_WHAT(
+      *endpoints.Insert(
+          std::make_unique<Endpoint>("/helloworld.Greeter/Other", "*")),
+      "Can't serve /helloworld.Greeter/Other for host * "
+      "from frozen endpoints");
+}
+
+TEST_F(EventualsGrpcTest, ThreadPerCoreThreadsPerCompletionQueue) {
+  ServerBuilder builder;
+
+  builder.SetThreadPerCore();
+
+  builder.SetMinimumThreadsPerCompletionQueue(2);
+
+  builder.AddListeningPort("0.0.0.0:0", grpc::InsecureServerCredentials());
+
+  auto build = builder.BuildAndStart();
+
+  ASSERT_FALSE(build.status.ok());
+
+  EXPECT_EQ(
+      "Error building server: "
+      "thread per core requires one thread per completion queue",
+      build.status.error());
+
+  EXPECT_FALSE(build.server);
+}
@@ -0,0 +1,221 @@
+#include "eventuals/grpc/timer.h"
+
+#include "eventuals/grpc/client.h"
+#include "eventuals/grpc/server.h"
+#include "eventuals/head.h"
+#include "eventuals/let.h"
+#include "eventuals/loop.h"
+#include "eventuals/map.h"
+#include "eventuals/then.h"
+#include "examples/protos/helloworld.grpc.pb.h"
+#include "gtest/gtest.h"
+#include "test/test.h"
+
+using helloworld::Greeter;
+using helloworld::HelloReply;
+using helloworld::HelloRequest;
+
+using stout::Borrowable;
+
+using eventuals::Head;
+using eventuals::Let;
+using eventuals::Loop;
+using eventuals::Map;
+using eventuals::Terminate;
+using eventuals::Then;
+
+using eventuals::grpc::Client;
+using eventuals::grpc::CompletionPool;
+using eventuals::grpc::ServerBuilder;
+using eventuals::grpc::Timer;
+using eventuals::grpc::TimerWheel;
+
+TEST(TimerWheelTest, InsertCancelAdvance) {
+  TimerWheel wheel(std::chrono::milliseconds(1));
+
+  TimerWheel::TimePoint now = TimerWheel::Clock::now();
+
+  std::vector<int> fired;
+
+  TimerWheel::Entry entries[4];
+
+  // Spread across the levels of the wheel.
+  wheel.Insert(&entries[0], now + std::chrono::milliseconds(5), [&]() {
+    fired.push_back(0);
+  });
+
+  wheel.Insert(&entries[1], now + std::chrono::seconds(2), [&]() {
+    fired.push_back(1);
+  });
+
+  wheel.Insert(&entries[2], now + std::chrono::minutes(10), [&]() {
+    fired.push_back(2);
+  });
+
+  wheel.Insert(&entries[3], now + std::chrono::seconds(1), [&]() {
+    fired.push_back(3);
+  });
+
+  EXPECT_EQ(4, wheel.size());
+
+  EXPECT_TRUE(wheel.Cancel(&entries[3]));
+  EXPECT_FALSE(wheel.Cancel(&entries[3]));
+
+  wheel.Advance(now + std::chrono::milliseconds(4));
+  EXPECT_TRUE(fired.empty());
+
+  wheel.Advance(now + std::chrono::milliseconds(6));
+  EXPECT_EQ(std::vector<int>({0}), fired);
+
+  wheel.Advance(now + std::chrono::seconds(3));
+  EXPECT_EQ(std::vector<int>({0, 1}), fired);
+
+  wheel.Advance(now + std::chrono::minutes(11));
+  EXPECT_EQ(std::vector<int>({0, 1, 2}), fired);
+
+  EXPECT_EQ(0, wheel.size());
+
+  EXPECT_FALSE(wheel.Cancel(&entries[2]));
+}
+
+TEST_F(EventualsGrpcTest, Timer) {
+  ServerBuilder builder;
+
+  int port = 0;
+
+  builder.AddListeningPort(
+      "0.0.0.0:0",
+      grpc::InsecureServerCredentials(),
+      &port);
+
+  builder.SetCompletionQueueTick(std::chrono::milliseconds(1));
+
+  auto build = builder.BuildAndStart();
+
+  ASSERT_TRUE(build.status.ok());
+
+  auto server = std::move(build.server);
+
+  ASSERT_TRUE(server);
+
+  auto serve = [&]() {
+    return server->Accept<Greeter, HelloRequest, HelloReply>("SayHello")
+        | Head()
+        | Then(Let([](auto& call) {
+             return UnaryPrologue(call)
+                 | Then([](auto&& request) {
+                      return Timer(std::chrono::milliseconds(50))
+                          | Then([request = std::move(request)]() {
+                               HelloReply reply;
+                               reply.set_message("Hello " + request.name());
+                               return reply;
+                             });
+                    })
+                 | UnaryEpilogue(call);
+           }));
+  };
+
+  auto [cancelled, k] = Terminate(serve());
+
+  k.Start();
+
+  Borrowable<CompletionPool> pool;
+
+  Client client(
+      "0.0.0.0:" + std::to_string(port),
+      grpc::InsecureChannelCredentials(),
+      pool.Borrow());
+
+  auto call = [&]() {
+    return client.Call<Greeter, HelloRequest, HelloReply>("SayHello")
+        | Then(Let([](auto& call) {
+             HelloRequest request;
+             request.set_name("emily");
+             return call.Writer().WriteLast(request)
+                 | call.Reader().Read()
+                 | Map([](auto&& response) {
+                      EXPECT_EQ("Hello emily", response.message());
+                    })
+                 | Loop()
+                 | call.Finish();
+           }));
+  };
+
+  auto start = std::chrono::steady_clock::now();
+
+  auto status = *call();
+
+  EXPECT_TRUE(status.ok());
+
+  EXPECT_LE(
+      std::chrono::milliseconds(50),
+      std::chrono::steady_clock::now() - start);
+
+  EXPECT_FALSE(cancelled.get());
+}
+
+TEST_F(EventualsGrpcTest, TimerWithoutTick) {
+  ServerBuilder builder;
+
+  int port = 0;
+
+  builder.AddListeningPort(
+      "0.0.0.0:0",
+      grpc::InsecureServerCredentials(),
+      &port);
+
+  auto build = builder.BuildAndStart();
+
+  ASSERT_TRUE(build.status.ok());
+
+  auto server = std::move(build.server);
+
+  ASSERT_TRUE(server);
+
+  auto serve = [&]() {
+    return server->Accept<Greeter, HelloRequest, HelloReply>("SayHello")
+        | Head()
+        | Then(Let([](auto& call) {
+             return UnaryPrologue(call)
+                 | Then([](auto&&) {
+                      return Timer(std::chrono::milliseconds(50))
+                          | Then([]() {
+                               return HelloReply();
+                             });
+                    })
+                 | UnaryEpilogue(call);
+           }));
+  };
+
+  auto [cancelled, k] = Terminate(serve());
+
+  k.Start();
+
+  Borrowable<CompletionPool> pool;
+
+  Client client(
+      "0.0.0.0:" + std::to_string(port),
+      grpc::InsecureChannelCredentials(),
+      pool.Borrow());
+
+  auto call = [&]() {
+    return client.Call<Greeter, HelloRequest, HelloReply>("SayHello")
+        | Then(Let([](auto& call) {
+             return call.Writer().WriteLast(HelloRequest())
+                 | call.Reader().Read()
+                 | Loop()
+                 | call.Finish();
+           }));
+  };
+
+  auto status = *call();
+
+  EXPECT_EQ(grpc::UNKNOWN, status.error_code());
+
+  EXPECT_EQ(
+      "Timer must be started from a completion queue "
+      "that is polled with a tick",
+      status.error_message());
+
+  EXPECT_FALSE(cancelled.get());
+}
@@ -1,3 +1,4 @@
+#include "eventuals/eventual.h"
 #include "eventuals/grpc/client.h"
 #include "eventuals/grpc/server.h"
 #include "eventuals/head.h"
@@ -15,6 +16,7 @@ using helloworld::HelloRequest;
 
 using stout::Borrowable;
 
+using eventuals::Eventual;
 using eventuals::Head;
 using eventuals::Let;
 using eventuals::Loop;
@@ -100,3 +102,161 @@ TEST_F(EventualsGrpcTest, Unary) {
   server->Shutdown();
   server->Wait();
 }
+
+TEST_F(EventualsGrpcTest, ClientUnary) {
+  ServerBuilder builder;
+
+  int port = 0;
+
+  builder.AddListeningPort(
+      "0.0.0.0:0",
+      grpc::InsecureServerCredentials(),
+      &port);
+
+  auto build = builder.BuildAndStart();
+
+  ASSERT_TRUE(build.status.ok());
+
+  auto server = std::move(build.server);
+
+  ASSERT_TRUE(server);
+
+  auto serve = [&]() {
+    return server->Accept<Greeter, HelloRequest, HelloReply>("SayHello")
+        | Head()
+        | Then(Let([](auto& call) {
+             return UnaryPrologue(call)
+                 | Then([](auto&& request) {
+                      HelloReply reply;
+                      std::string prefix("Hello ");
+                      reply.set_message(prefix + request.name());
+                      return reply;
+                    })
+                 | UnaryEpilogue(call);
+           }));
+  };
+
+  auto [cancelled, k] = Terminate(serve());
+
+  k.Start();
+
+  Borrowable<CompletionPool> pool;
+
+  Client client(
+      "0.0.0.0:" + std::to_string(port),
+      grpc::InsecureChannelCredentials(),
+      pool.Borrow());
+
+  auto call = [&]() {
+    HelloRequest request;
+    request.set_name("emily");
+    return client.Unary<Greeter, HelloRequest, HelloReply>(
+        "SayHello",
+        std::move(request));
+  };
+
+  auto result = *call();
+
+  EXPECT_TRUE(result.status.ok());
+
+  EXPECT_EQ("Hello emily", result.response.message());
+
+  EXPECT_FALSE(cancelled.get());
+}
+
+TEST_F(EventualsGrpcTest, ClientUnaryUnimplemented) {
+  ServerBuilder builder;
+
+  int port = 0;
+
+  builder.AddListeningPort(
+      "0.0.0.0:0",
+      grpc::InsecureServerCredentials(),
+      &port);
+
+  auto build = builder.BuildAndStart();
+
+  ASSERT_TRUE(build.status.ok());
+
+  auto server = std::move(build.server);
+
+  ASSERT_TRUE(server);
+
+  Borrowable<CompletionPool> pool;
+
+  Client client(
+      "0.0.0.0:" + std::to_string(port),
+      grpc::InsecureChannelCredentials(),
+      pool.Borrow());
+
+  auto call = [&]() {
+    return client.Unary<Greeter, HelloRequest, HelloReply>(
+        "SayHello",
+        HelloRequest());
+  };
+
+  auto result = *call();
+
+  EXPECT_EQ(grpc::UNIMPLEMENTED, result.status.error_code());
+}
+
+TEST_F(EventualsGrpcTest, UnaryEpilogueFailure) {
+  ServerBuilder builder;
+
+  int port = 0;
+
+  builder.AddListeningPort(
+      "0.0.0.0:0",
+      grpc::InsecureServerCredentials(),
+      &port);
+
+  auto build = builder.BuildAndStart();
+
+  ASSERT_TRUE(build.status.ok());
+
+  auto server = std::move(build.server);
+
+  ASSERT_TRUE(server);
+
+  auto serve = [&]() {
+    return server->Accept<Greeter, HelloRequest, HelloReply>("SayHello")
+        | Head()
+        | Then(Let([](auto& call) {
+             return UnaryPrologue(call)
+                 | Then([](auto&& request) {
+                      return Eventual<HelloReply>()
+                          .raises<std::runtime_error>()
+                          .start([](auto& k) {
+                            k.Fail(std::runtime_error("oops"));
+                          });
+                    })
+                 | UnaryEpilogue(call);
+           }));
+  };
+
+  auto [cancelled, k] = Terminate(serve());
+
+  k.Start();
+
+  Borrowable<CompletionPool> pool;
+
+  Client client(
+      "0.0.0.0:" + std::to_string(port),
+      grpc::InsecureChannelCredentials(),
+      pool.Borrow());
+
+  auto call = [&]() {
+    HelloRequest request;
+    request.set_name("emily");
+    return client.Unary<Greeter, HelloRequest, HelloReply>(
+        "SayHello",
+        std::move(request));
+  };
+
+  auto result = *call();
+
+  EXPECT_EQ(grpc::UNKNOWN, result.status.error_code());
+  EXPECT_EQ("oops", result.status.error_message());
+
+  EXPECT_FALSE(cancelled.get());
+}